@@ -59,6 +59,14 @@ static void SHA256D64_1024(benchmark::State& state)
     }
 }
 
+static void SHA256D_80b_Batch(benchmark::State& state)
+{
+    std::vector<uint8_t> in(80 * 32, 0), out(32 * 32);
+    while (state.KeepRunning()) {
+        SHA256DBatch(out.data(), in.data(), 80, 32);
+    }
+}
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -100,5 +108,6 @@ BENCHMARK(SHA512, 330);
 BENCHMARK(SHA256_32b, 4700 * 1000);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
 BENCHMARK(SHA256D64_1024, 7400);
+BENCHMARK(SHA256D_80b_Batch, 60 * 1000);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
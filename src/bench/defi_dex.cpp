@@ -0,0 +1,86 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/defi_state.h>
+#include <chainparams.h>
+#include <masternodes/mn_checks.h>
+#include <masternodes/poolpairs.h>
+
+#include <cassert>
+
+static const CAmount PROVIDER_LIQUIDITY = 1000 * COIN;
+
+// Rewards of a pool share over the state's history, a reward, liquidity or
+// commission change every few heights
+static void DeFiPoolRewards(benchmark::State& state)
+{
+    auto& defi = DeFiBenchState::Get();
+    while (state.KeepRunning()) {
+        CAmount total{};
+        defi.view->CalculatePoolRewards(defi.pools[0], [] { return PROVIDER_LIQUIDITY; },
+            defi.height - DeFiBenchState::HISTORY_HEIGHTS, defi.height,
+            [&](RewardType, CTokenAmount amount, uint32_t) {
+                total += amount.nValue;
+            });
+        assert(total > 0);
+    }
+}
+
+static void DeFiPoolRewardsAccrued(benchmark::State& state)
+{
+    auto& defi = DeFiBenchState::Get();
+    while (state.KeepRunning()) {
+        CAmount total{};
+        defi.view->AccruePoolRewards(defi.pools[0], [] { return PROVIDER_LIQUIDITY; },
+            defi.height - DeFiBenchState::HISTORY_HEIGHTS, defi.height,
+            [&](RewardType, CTokenAmount amount, uint32_t, uint32_t count) {
+                total += amount.nValue * count;
+            });
+        assert(total > 0);
+    }
+}
+
+// Swap between loan tokens without a pool of their own, over DFI, DUSD or other loan tokens
+static CPoolSwapMessage CompositeSwap(const DeFiBenchState& defi)
+{
+    CPoolSwapMessage msg{};
+    msg.from = defi.swapper;
+    msg.to = defi.swapper;
+    msg.idTokenFrom = defi.loanTokens[1];
+    msg.idTokenTo = defi.loanTokens[defi.loanTokens.size() / 2];
+    msg.amountFrom = COIN;
+    msg.maxPrice = PoolPrice::getMaxValid();
+    return msg;
+}
+
+static void DeFiCompositeSwapPaths(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    const auto& consensus = Params().GetConsensus();
+    const auto msg = CompositeSwap(defi);
+    while (state.KeepRunning()) {
+        CCustomCSView view(*defi.view);
+        const auto path = CPoolSwap(msg, defi.height).CalculateSwaps(view, consensus, true);
+        assert(path.size() > 1);
+    }
+}
+
+static void DeFiCompositeSwap(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    const auto& consensus = Params().GetConsensus();
+    const auto msg = CompositeSwap(defi);
+    while (state.KeepRunning()) {
+        CCustomCSView view(*defi.view);
+        const auto path = CPoolSwap(msg, defi.height).CalculateSwaps(view, consensus, true);
+        const auto res = CPoolSwap(msg, defi.height).ExecuteSwap(view, path, consensus);
+        assert(res);
+    }
+}
+
+BENCHMARK(DeFiPoolRewards, 10);
+BENCHMARK(DeFiPoolRewardsAccrued, 10);
+BENCHMARK(DeFiCompositeSwapPaths, 100);
+BENCHMARK(DeFiCompositeSwap, 50);
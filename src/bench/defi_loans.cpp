@@ -0,0 +1,64 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/defi_state.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <masternodes/threadpool.h>
+#include <masternodes/validation.h>
+#include <masternodes/vaultrisk.h>
+
+#include <cassert>
+
+static void DeFiVaultAssets(benchmark::State& state)
+{
+    auto& defi = DeFiBenchState::Get();
+    while (state.KeepRunning()) {
+        CAmount total{};
+        for (size_t i = 0; i < defi.vaults.size(); i += defi.vaults.size() / 1000) {
+            const auto& vaultId = defi.vaults[i];
+            const auto collaterals = defi.view->GetVaultCollaterals(vaultId);
+            assert(collaterals);
+            const auto assets = defi.view->GetVaultAssets(vaultId, *collaterals, defi.height, 0);
+            assert(assets);
+            total += assets.val->totalCollaterals;
+        }
+        assert(total > 0);
+    }
+}
+
+// Collateralization of every vault at a ratio calculation height, liquidating the
+// ones under their scheme's ratio. The vault risk index is left out to scan them all.
+static void DeFiLoanEvents(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    const auto riskIndex = fVaultRiskIndex;
+    fVaultRiskIndex = false;
+    const bool ownPool = !DfTxTaskPool;
+    if (ownPool) {
+        InitDfTxGlobalTaskPool();
+    }
+
+    const auto hash = uint256S("01");
+    CBlockIndex index;
+    index.nHeight = defi.height;
+    index.nTime = 1700000000;
+    index.phashBlock = &hash;
+    while (state.KeepRunning()) {
+        CCustomCSView cache(*defi.view);
+        ProcessLoanEvents(&index, cache, Params());
+        // the first vault is under its ratio
+        assert(cache.GetVault(defi.vaults[0])->isUnderLiquidation);
+    }
+
+    if (ownPool) {
+        ShutdownDfTxGlobalTaskPool();
+        DfTxTaskPool.reset();
+    }
+    fVaultRiskIndex = riskIndex;
+}
+
+BENCHMARK(DeFiVaultAssets, 20);
+BENCHMARK(DeFiLoanEvents, 1);
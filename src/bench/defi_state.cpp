@@ -0,0 +1,261 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/defi_state.h>
+
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <masternodes/govvariables/attributes.h>
+#include <masternodes/loan.h>
+#include <masternodes/oracles.h>
+#include <masternodes/poolpairs.h>
+#include <masternodes/vault.h>
+#include <random.h>
+#include <util/system.h>
+
+#include <cassert>
+#include <map>
+
+static const std::string BENCH_SCHEME = "BENCH150";
+static const CAmount POOL_RESERVE = 100000 * COIN;
+static const CAmount VAULT_LOAN = 10 * COIN;
+// records written to the database at once while building
+static const uint32_t BUILD_BATCH = 50000;
+
+static void Check(const Res& res)
+{
+    if (!res) {
+        LogPrintf("DeFi bench state: %s\n", res.msg);
+    }
+    assert(res);
+}
+
+static void FlushBatch(DeFiBenchState& state)
+{
+    assert(state.view->Flush());
+    assert(state.db->Flush());
+}
+
+static DCT_ID CreateToken(CCustomCSView& mnview, FastRandomContext& rng, const std::string& symbol, uint8_t flags)
+{
+    CTokenImplementation token;
+    token.symbol = symbol;
+    token.name = symbol;
+    token.creationTx = rng.rand256();
+    token.creationHeight = 0;
+    token.flags = flags;
+    auto res = mnview.CreateToken(token, false);
+    Check(res);
+    return *res.val;
+}
+
+static void SetPrice(CCustomCSView& mnview, const std::string& symbol, CAmount price)
+{
+    CFixedIntervalPrice fixedIntervalPrice;
+    fixedIntervalPrice.priceFeedId = {symbol, "USD"};
+    fixedIntervalPrice.timestamp = 0;
+    fixedIntervalPrice.priceRecord = {price, price};
+    Check(mnview.SetFixedIntervalPrice(fixedIntervalPrice));
+}
+
+DeFiBenchState& DeFiBenchState::Get()
+{
+    static DeFiBenchState state;
+    return state;
+}
+
+DeFiBenchState::DeFiBenchState()
+{
+    const auto& consensus = Params().GetConsensus();
+    const auto interval = consensus.blocksCollateralizationRatioCalculation();
+    height = (static_cast<uint32_t>(consensus.GrandCentralEpilogueHeight) + HISTORY_HEIGHTS) / interval * interval + interval;
+    const auto historyStart = height - HISTORY_HEIGHTS;
+
+    db = std::make_unique<CStorageLevelDB>(GetDataDir() / "bench_defi_state", 64 << 20, true, true);
+    view = std::make_unique<CCustomCSView>(*db);
+    FastRandomContext rng(true);
+
+    Check(view->CreateDFIToken());
+    const DCT_ID dfi{0};
+    SetPrice(*view, "DFI", 2 * COIN);
+
+    const uint8_t datFlags = static_cast<uint8_t>(CToken::TokenFlags::Default) | static_cast<uint8_t>(CToken::TokenFlags::DAT);
+    const uint8_t loanFlags = datFlags | static_cast<uint8_t>(CToken::TokenFlags::LoanToken);
+    const uint8_t lpsFlags = datFlags | static_cast<uint8_t>(CToken::TokenFlags::LPS);
+
+    // collaterals, DUSD and loan tokens
+    CLoanSchemeMessage scheme;
+    scheme.identifier = BENCH_SCHEME;
+    scheme.ratio = 150;
+    scheme.rate = COIN;
+    Check(view->StoreLoanScheme(scheme));
+    Check(view->StoreDefaultLoanScheme(BENCH_SCHEME));
+
+    std::map<DCT_ID, std::string> symbols{{dfi, "DFI"}};
+    std::map<DCT_ID, CAmount> prices{{dfi, 2 * COIN}};
+    for (uint32_t i = 0; i < TOKENS; ++i) {
+        const auto symbol = i == 0 ? std::string("DUSD") : i == 1 ? std::string("BTC") : strprintf("T%02d", i);
+        const auto price = i == 0 ? COIN : i == 1 ? 20000 * COIN : (i % 50 + 1) * COIN;
+        const auto id = CreateToken(*view, rng, symbol, i == 1 ? datFlags : loanFlags);
+        symbols.emplace(id, symbol);
+        prices.emplace(id, price);
+        tokens.push_back(id);
+        SetPrice(*view, symbol, price);
+
+        if (i == 1) {
+            btc = id;
+            continue;
+        }
+        CLoanSetLoanTokenImplementation loanToken;
+        loanToken.symbol = symbol;
+        loanToken.name = symbol;
+        loanToken.fixedIntervalPriceId = {symbol, "USD"};
+        loanToken.interest = (i % 5) * COIN;
+        loanToken.creationTx = rng.rand256();
+        Check(view->SetLoanToken(loanToken, id));
+        loanTokens.push_back(id);
+    }
+    dusd = tokens[0];
+    for (const auto& id : {dfi, btc, dusd}) {
+        CLoanSetCollateralTokenImplementation collateralToken;
+        collateralToken.idToken = id;
+        collateralToken.factor = COIN;
+        collateralToken.fixedIntervalPriceId = {symbols[id], "USD"};
+        collateralToken.creationTx = rng.rand256();
+        collateralToken.creationHeight = 0;
+        Check(view->CreateLoanCollateralToken(collateralToken));
+    }
+
+    // accounts, the first ones provide the pools' liquidity
+    accounts.reserve(ACCOUNTS);
+    for (uint32_t i = 0; i < ACCOUNTS; ++i) {
+        accounts.push_back(CScript() << OP_DUP << OP_HASH160 << rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG);
+        Check(view->AddBalance(accounts.back(), {dfi, 100 * COIN + i}));
+        if (i % 4 == 0) {
+            Check(view->AddBalance(accounts.back(), {tokens[i / 4 % TOKENS], 10 * COIN}));
+        }
+        if (i % BUILD_BATCH == 0) {
+            FlushBatch(*this);
+        }
+    }
+
+    // every token with DFI and DUSD, then pairs of loan tokens further and further apart
+    std::vector<std::pair<DCT_ID, DCT_ID>> pairs;
+    for (const auto& id : tokens) {
+        pairs.emplace_back(id, dfi);
+    }
+    for (const auto& id : tokens) {
+        if (id != dusd) {
+            pairs.emplace_back(id, dusd);
+        }
+    }
+    for (uint32_t distance = 1; pairs.size() < POOLS; ++distance) {
+        for (uint32_t i = 2; i < TOKENS && pairs.size() < POOLS; ++i) {
+            pairs.emplace_back(tokens[i], tokens[2 + (i - 2 + distance) % (TOKENS - 2)]);
+        }
+    }
+    for (const auto& [idA, idB] : pairs) {
+        const auto idPool = CreateToken(*view, rng, symbols[idA] + "-" + symbols[idB], lpsFlags);
+        const auto& provider = accounts[pools.size()];
+        pools.push_back(idPool);
+
+        CPoolPair pool{};
+        pool.idTokenA = idA;
+        pool.idTokenB = idB;
+        pool.commission = COIN / 500;
+        pool.status = true;
+        pool.creationTx = rng.rand256();
+        pool.creationHeight = 1;
+        Check(view->SetPoolPair(idPool, 1, pool));
+        const auto reserveB = DivideAmounts(MultiplyAmounts(POOL_RESERVE, prices[idA]), prices[idB]);
+        Check(pool.AddLiquidity(POOL_RESERVE, reserveB, [&](CAmount liquidity) {
+            Check(view->AddBalance(provider, {idPool, liquidity}));
+            return view->SetShare(idPool, provider, 1);
+        }));
+        Check(view->SetPoolPair(idPool, 1, pool));
+        Check(view->SetRewardPct(idPool, 1, COIN / POOLS));
+
+        attributes.pushKV(strprintf("v0/poolpairs/%d/token_a_fee_pct", idPool.v), "0.001");
+        attributes.pushKV(strprintf("v0/poolpairs/%d/token_b_fee_pct", idPool.v), "0.002");
+    }
+    for (const auto& id : tokens) {
+        attributes.pushKV(strprintf("v0/token/%d/dex_in_fee_pct", id.v), "0.003");
+        attributes.pushKV(strprintf("v0/token/%d/dex_out_fee_pct", id.v), "0.004");
+    }
+    ATTRIBUTES govVar;
+    Check(govVar.Import(attributes));
+    Check(view->SetVariable(govVar));
+    Check(view->SetDailyReward(historyStart, 100000 * COIN));
+    FlushBatch(*this);
+
+    // swaps, liquidity and reward changes of the first pool up to the height
+    auto pool = *view->GetPoolPair(pools[0]);
+    const auto& provider = accounts[0];
+    const auto liquidityB = DivideAmounts(MultiplyAmounts(COIN, prices[pool.idTokenA]), prices[pool.idTokenB]);
+    for (auto h = historyStart; h < height; ++h) {
+        if (h % 1000 == 0) {
+            Check(view->SetDailyReward(h, (100000 - (h - historyStart) / 1000) * COIN));
+        }
+        pool.swapEvent = h % 10 == 0;
+        pool.blockCommissionA = pool.swapEvent ? COIN / 100 : 0;
+        pool.blockCommissionB = pool.swapEvent ? COIN / 200 : 0;
+        if (h % 100 == 0) {
+            Check(pool.AddLiquidity(COIN, liquidityB, [&](CAmount liquidity) {
+                return view->AddBalance(provider, {pools[0], liquidity});
+            }));
+        }
+        if (pool.swapEvent || h % 100 == 0) {
+            Check(view->SetPoolPair(pools[0], h, pool));
+        }
+        if (h % BUILD_BATCH == 0) {
+            FlushBatch(*this);
+        }
+    }
+
+    // vaults with one loan each, collateralized by DFI and BTC
+    vaults.reserve(VAULTS);
+    for (uint32_t i = 0; i < VAULTS; ++i) {
+        const auto vaultId = rng.rand256();
+        vaults.push_back(vaultId);
+
+        CVaultData vault{};
+        vault.ownerAddress = accounts[i];
+        vault.schemeId = BENCH_SCHEME;
+        vault.isUnderLiquidation = false;
+        Check(view->StoreVault(vaultId, vault));
+
+        const auto loanToken = loanTokens[i % loanTokens.size()];
+        const auto loanTokenData = view->GetLoanTokenByID(loanToken);
+        Check(view->AddLoanToken(vaultId, {loanToken, VAULT_LOAN}));
+        Check(view->IncreaseInterest(historyStart, vaultId, BENCH_SCHEME, loanToken, loanTokenData->interest, VAULT_LOAN));
+
+        const auto ratio = i % UNSAFE_VAULT_INTERVAL == 0 ? 120 : 300;
+        const auto collateral = MultiplyAmounts(VAULT_LOAN, prices[loanToken]) * ratio / 100;
+        Check(view->AddVaultCollateral(vaultId, {dfi, DivideAmounts(collateral * 6 / 10, prices[dfi])}));
+        Check(view->AddVaultCollateral(vaultId, {btc, DivideAmounts(collateral * 4 / 10, prices[btc])}));
+        if (i % BUILD_BATCH == 0) {
+            FlushBatch(*this);
+        }
+    }
+
+    swapper = CScript() << OP_DUP << OP_HASH160 << rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG;
+    for (const auto& id : loanTokens) {
+        Check(view->AddBalance(swapper, {id, 1000 * COIN}));
+    }
+    view->SetLastHeight(height - 1);
+    FlushBatch(*this);
+}
+
+void DeFiBenchState::Transfer(CCustomCSView& mnview, uint32_t count, uint32_t seed) const
+{
+    uint256 key;
+    WriteLE32(key.begin(), seed);
+    FastRandomContext rng(key);
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& from = accounts[rng.randrange(accounts.size())];
+        const auto& to = accounts[rng.randrange(accounts.size())];
+        Check(mnview.SubBalance(from, {DCT_ID{0}, COIN / 100}));
+        Check(mnview.AddBalance(to, {DCT_ID{0}, COIN / 100}));
+    }
+}
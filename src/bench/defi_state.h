@@ -0,0 +1,58 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_BENCH_DEFI_STATE_H
+#define DEFI_BENCH_DEFI_STATE_H
+
+#include <flushablestorage.h>
+#include <masternodes/masternodes.h>
+#include <univalue.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Synthetic DeFi state of mainnet scale the DeFi benchmarks run against: DAT
+ * tokens with live prices, pools between them, funded accounts and vaults with
+ * loans, a few of them under their scheme's ratio. Built once on first use in an
+ * in-memory database, benchmarks leave it as is and work on views over it.
+ */
+struct DeFiBenchState {
+    static constexpr uint32_t TOKENS = 100;
+    static constexpr uint32_t POOLS = 500;
+    static constexpr uint32_t ACCOUNTS = 1000000;
+    static constexpr uint32_t VAULTS = 100000;
+    // one vault in this many is under its scheme's ratio
+    static constexpr uint32_t UNSAFE_VAULT_INTERVAL = 100;
+    // heights of swap, liquidity and reward history of the first pool, ending at the state's height
+    static constexpr uint32_t HISTORY_HEIGHTS = 100000;
+
+    std::unique_ptr<CStorageLevelDB> db;
+    std::unique_ptr<CCustomCSView> view;
+
+    // a collateralization ratio calculation height, past the forks mainnet runs on
+    uint32_t height;
+    DCT_ID dusd;
+    DCT_ID btc;
+    // every DAT token but DFI, the loan tokens
+    std::vector<DCT_ID> tokens;
+    std::vector<DCT_ID> loanTokens;
+    std::vector<DCT_ID> pools;
+    std::vector<CScript> accounts;
+    std::vector<CVaultId> vaults;
+    // holds loan tokens and no pool shares
+    CScript swapper;
+    // pool and token fees, the ATTRIBUTES of the state
+    UniValue attributes{UniValue::VOBJ};
+
+    static DeFiBenchState& Get();
+
+    // DFI transfers between accounts, the balance changes of as many account DfTxs
+    void Transfer(CCustomCSView& mnview, uint32_t count, uint32_t seed) const;
+
+private:
+    DeFiBenchState();
+};
+
+#endif // DEFI_BENCH_DEFI_STATE_H
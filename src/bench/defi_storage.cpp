@@ -0,0 +1,147 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/defi_state.h>
+#include <masternodes/govvariables/attributes.h>
+#include <masternodes/undo.h>
+#include <random.h>
+
+#include <cassert>
+
+// Views stacked the way a block connects: the block's cache over the chain state,
+// a tx view over it and a view of a DfTx's sub steps on top
+struct LayeredViews {
+    CCustomCSView block;
+    CCustomCSView tx;
+    CCustomCSView step;
+
+    explicit LayeredViews(const DeFiBenchState& state) : block(*state.view), tx(block), step(tx)
+    {
+        state.Transfer(block, 2000, 1);
+        state.Transfer(tx, 20, 2);
+        state.Transfer(step, 2, 3);
+    }
+};
+
+static void DeFiLayeredReads(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    LayeredViews views(defi);
+    FastRandomContext rng(true);
+    while (state.KeepRunning()) {
+        CAmount total{};
+        for (int i = 0; i < 1000; ++i) {
+            const auto& owner = defi.accounts[rng.randrange(defi.accounts.size())];
+            total += views.step.GetBalance(owner, DCT_ID{0}).nValue;
+        }
+        assert(total > 0);
+    }
+}
+
+static void DeFiLayeredIteration(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    LayeredViews views(defi);
+    FastRandomContext rng(true);
+    while (state.KeepRunning()) {
+        const auto& start = defi.accounts[rng.randrange(defi.accounts.size())];
+        size_t count{};
+        views.step.ForEachBalance([&](const CScript&, const CTokenAmount&) {
+            return ++count < 10000;
+        }, BalanceKey{start, DCT_ID{0}});
+        views.step.ForEachPoolPair([&](const DCT_ID&, const CPoolPair&) {
+            ++count;
+            return true;
+        });
+        assert(count > 0);
+    }
+}
+
+// A block's txs applied on views of their own, flushed into the block's cache
+static void DeFiLayerFlush(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    while (state.KeepRunning()) {
+        CCustomCSView block(*defi.view);
+        for (uint32_t i = 0; i < 500; ++i) {
+            CCustomCSView tx(block);
+            defi.Transfer(tx, 4, i);
+            tx.Flush();
+        }
+        assert(block.GetStorage().GetRaw().Size() > 0);
+    }
+}
+
+static void DeFiUndoConstruct(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    CCustomCSView block(*defi.view);
+    defi.Transfer(block, 2000, 1);
+    while (state.KeepRunning()) {
+        const auto undo = CUndo::Construct(defi.view->GetStorage(), block.GetStorage().GetRaw());
+        assert(!undo.before.empty());
+    }
+}
+
+static void DeFiUndoRevert(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    CCustomCSView block(*defi.view);
+    defi.Transfer(block, 2000, 1);
+    const auto undo = CUndo::Construct(defi.view->GetStorage(), block.GetStorage().GetRaw());
+    while (state.KeepRunning()) {
+        CFlushableStorageKV reverted(static_cast<CStorageKV&>(block.GetStorage()));
+        CUndo::Revert(reverted, undo);
+        assert(reverted.GetRaw().Size() > 0);
+    }
+}
+
+// Merkle root of a block's changes, undo records of its txs included
+static void DeFiMerkleRoot(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    CCustomCSView block(*defi.view);
+    FastRandomContext rng(true);
+    for (uint32_t i = 0; i < 500; ++i) {
+        CCustomCSView tx(block);
+        defi.Transfer(tx, 4, i);
+        const auto undo = CUndo::Construct(block.GetStorage(), tx.GetStorage().GetRaw());
+        tx.Flush();
+        block.SetUndo({defi.height, rng.rand256()}, undo);
+    }
+    while (state.KeepRunning()) {
+        const auto root = block.MerkleRoot();
+        assert(!root.IsNull());
+    }
+}
+
+static void DeFiAttributesImport(benchmark::State& state)
+{
+    const auto& defi = DeFiBenchState::Get();
+    while (state.KeepRunning()) {
+        ATTRIBUTES attributes;
+        const auto res = attributes.Import(defi.attributes);
+        assert(res);
+    }
+}
+
+static void DeFiAttributesExport(benchmark::State& state)
+{
+    const auto attributes = DeFiBenchState::Get().view->GetAttributes();
+    assert(attributes);
+    while (state.KeepRunning()) {
+        const auto exported = attributes->Export();
+        assert(exported.size() > 0);
+    }
+}
+
+BENCHMARK(DeFiLayeredReads, 200);
+BENCHMARK(DeFiLayeredIteration, 100);
+BENCHMARK(DeFiLayerFlush, 20);
+BENCHMARK(DeFiUndoConstruct, 100);
+BENCHMARK(DeFiUndoRevert, 100);
+BENCHMARK(DeFiMerkleRoot, 50);
+BENCHMARK(DeFiAttributesImport, 50);
+BENCHMARK(DeFiAttributesExport, 50);
@@ -0,0 +1,141 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <flushablestorage.h>
+#include <masternodes/accounts.h>
+#include <masternodes/poolpairs.h>
+#include <masternodes/undos.h>
+#include <random.h>
+
+// Change set of a block worth of DfTxs: balance updates of random owners,
+// pool reserves and shares, one undo record per tx and a few prefix scans.
+struct DfTxKeyMix {
+    std::vector<TBytes> balances;
+    std::vector<TBytes> pools;
+    std::vector<TBytes> shares;
+    std::vector<TBytes> undos;
+    TBytes value;
+
+    DfTxKeyMix() : value(40, 0x42) {
+        FastRandomContext rng(true);
+        for (uint32_t i = 0; i < 2000; ++i) {
+            CScript owner = CScript() << OP_DUP << OP_HASH160 << ToByteVector(rng.rand256()) << OP_EQUALVERIFY;
+            DCT_ID token{static_cast<uint32_t>(rng.randrange(30))};
+            balances.push_back(DbTypeToBytes(std::make_pair(CAccountsView::ByBalanceKey::prefix(), BalanceKey{owner, token})));
+            shares.push_back(DbTypeToBytes(std::make_pair(CPoolPairView::ByShare::prefix(), PoolShareKey{token, owner})));
+        }
+        for (uint32_t i = 0; i < 20; ++i) {
+            pools.push_back(DbTypeToBytes(std::make_pair(CPoolPairView::ByReserves::prefix(), DCT_ID{i})));
+        }
+        for (uint32_t i = 0; i < 2000; ++i) {
+            undos.push_back(DbTypeToBytes(std::make_pair(CUndosView::ByUndoKey::prefix(), UndoKey{1000000, rng.rand256()})));
+        }
+    }
+};
+
+struct MapKVBuffer {
+    MapKV map;
+
+    bool Read(const TBytes& key, TBytes& value) const {
+        auto it = map.find(key);
+        if (it == map.end() || !it->second) {
+            return false;
+        }
+        value = *it->second;
+        return true;
+    }
+    void Write(const TBytes& key, const TBytes& value) {
+        map[key] = value;
+    }
+    size_t Scan(const TBytes& key, size_t count) const {
+        size_t bytes{};
+        for (auto it = map.lower_bound(key); it != map.end() && count--; ++it) {
+            bytes += it->first.size();
+        }
+        return bytes;
+    }
+    size_t Walk() const {
+        size_t bytes{};
+        for (const auto& [key, value] : map) {
+            bytes += key.size() + (value ? value->size() : 0);
+        }
+        return bytes;
+    }
+};
+
+struct WriteBuffer {
+    CKVWriteBuffer buffer;
+
+    bool Read(const TBytes& key, TBytes& value) const {
+        auto entry = buffer.Find(MakeBytesView(key));
+        if (!entry || entry->Erased()) {
+            return false;
+        }
+        value.assign(entry->Value().begin(), entry->Value().end());
+        return true;
+    }
+    void Write(const TBytes& key, const TBytes& value) {
+        buffer.Write(MakeBytesView(key), MakeBytesView(value));
+    }
+    size_t Scan(const TBytes& key, size_t count) const {
+        size_t bytes{};
+        CKVWriteBuffer::Cursor cursor(buffer);
+        for (cursor.Seek(MakeBytesView(key)); cursor.Valid() && count--; cursor.Next()) {
+            bytes += cursor.Key().size();
+        }
+        return bytes;
+    }
+    size_t Walk() const {
+        size_t bytes{};
+        for (const auto& [key, value] : buffer) {
+            bytes += key.size() + (value ? value->size() : 0);
+        }
+        return bytes;
+    }
+};
+
+template<typename Buffer>
+static void FlushableStorageBlock(benchmark::State& state)
+{
+    static const DfTxKeyMix mix;
+    TBytes value;
+    while (state.KeepRunning()) {
+        Buffer buffer;
+        size_t total{};
+        for (size_t tx = 0; tx < mix.undos.size(); ++tx) {
+            const auto& from = mix.balances[(tx * 7) % mix.balances.size()];
+            const auto& to = mix.balances[(tx * 13 + 5) % mix.balances.size()];
+            buffer.Read(from, value);
+            buffer.Write(from, mix.value);
+            buffer.Read(to, value);
+            buffer.Write(to, mix.value);
+            if (tx % 4 == 0) {
+                const auto& pool = mix.pools[tx % mix.pools.size()];
+                buffer.Read(pool, value);
+                buffer.Write(pool, mix.value);
+                buffer.Write(mix.shares[(tx * 3) % mix.shares.size()], mix.value);
+            }
+            if (tx % 16 == 0) {
+                total += buffer.Scan(from, 8);
+            }
+            buffer.Write(mix.undos[tx], mix.value);
+        }
+        total += buffer.Walk();
+        assert(total > 0);
+    }
+}
+
+static void FlushableStorageMapKV(benchmark::State& state)
+{
+    FlushableStorageBlock<MapKVBuffer>(state);
+}
+
+static void FlushableStorageWriteBuffer(benchmark::State& state)
+{
+    FlushableStorageBlock<WriteBuffer>(state);
+}
+
+BENCHMARK(FlushableStorageMapKV, 50);
+BENCHMARK(FlushableStorageWriteBuffer, 50);
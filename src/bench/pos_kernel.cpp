@@ -0,0 +1,44 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <masternodes/masternodes.h>
+#include <pos_kernel.h>
+
+// One staker search interval of a ten year masternode, with an unattainable target so
+// every time and subnode gets hashed.
+static const size_t SEARCH_TIMES = 64;
+static const uint32_t UNATTAINABLE_BITS = 0x03000001;
+
+static void KernelHashSerial(benchmark::State& state)
+{
+    const auto stakeModifier = uint256S(std::string(64, '1'));
+    const auto masternodeID = uint256S(std::string(64, '2'));
+    const std::vector<int64_t> subNodesBlockTime{0, 0, 0, 0};
+    const auto& params = Params().GetConsensus();
+    CheckContextState ctxState;
+    while (state.KeepRunning()) {
+        for (size_t t = 0; t < SEARCH_TIMES; ++t) {
+            pos::CheckKernelHash(stakeModifier, UNATTAINABLE_BITS, 0, 1000 + t, 10000000, masternodeID, params,
+                                 subNodesBlockTime, CMasternode::TENYEAR, ctxState);
+        }
+    }
+}
+
+static void KernelHashBatch(benchmark::State& state)
+{
+    const auto stakeModifier = uint256S(std::string(64, '1'));
+    const auto masternodeID = uint256S(std::string(64, '2'));
+    const std::vector<int64_t> subNodesBlockTime{0, 0, 0, 0};
+    const pos::CKernelSearch kernelSearch(stakeModifier, UNATTAINABLE_BITS, 0, 10000000, masternodeID, Params().GetConsensus(),
+                                          subNodesBlockTime, CMasternode::TENYEAR);
+    CheckContextState ctxState;
+    while (state.KeepRunning()) {
+        kernelSearch.Search(1000, 1, SEARCH_TIMES, ctxState);
+    }
+}
+
+BENCHMARK(KernelHashSerial, 2000);
+BENCHMARK(KernelHashBatch, 5000);
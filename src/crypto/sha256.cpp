@@ -22,11 +22,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void TransformMulti_4way(uint32_t* s, const unsigned char* in);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void TransformMulti_8way(uint32_t* s, const unsigned char* in);
 }
 
 namespace sha256d64_shani
@@ -416,6 +418,7 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -461,6 +464,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -544,6 +549,19 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test SHA256DBatch against CSHA256, for one and two block messages over all lane widths.
+    for (size_t len : {33, 80, 81}) {
+        const size_t count = 640 / len;
+        unsigned char batch[640 / 33 * 32];
+        SHA256DBatch(batch, data + 1, len, count);
+        for (size_t i = 0; i < count; ++i) {
+            unsigned char hash[32];
+            CSHA256().Write(data + 1 + i * len, len).Finalize(hash);
+            CSHA256().Write(hash, 32).Finalize(hash);
+            if (!std::equal(hash, hash + 32, batch + i * 32)) return false;
+        }
+    }
+
     return true;
 }
 
@@ -622,6 +640,7 @@ std::string SHA256AutoDetect()
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_DEFI_INTERNAL)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformMulti_4way = sha256d64_sse41::TransformMulti_4way;
         ret += ",sse41(4way)";
 #endif
     }
@@ -629,6 +648,7 @@ std::string SHA256AutoDetect()
 #if defined(ENABLE_AVX2) && !defined(BUILD_DEFI_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256d64_avx2::TransformMulti_8way;
         ret += ",avx2(8way)";
     }
 #endif
@@ -695,6 +715,70 @@ CSHA256& CSHA256::Reset()
     return *this;
 }
 
+void SHA256DBatch(unsigned char* out, const unsigned char* in, size_t len, size_t count)
+{
+    assert(len <= 119);
+    const size_t blocks = len + 9 > 64 ? 2 : 1;
+    // blocks of all lanes in block order, then the digests
+    unsigned char buffer[8 * 128];
+    uint32_t s[8 * 8];
+    while (count) {
+        size_t lanes = 1;
+        TransformMultiType tr = nullptr;
+        if (TransformMulti_8way && count >= 8) {
+            lanes = 8;
+            tr = TransformMulti_8way;
+        } else if (TransformMulti_4way && count >= 4) {
+            lanes = 4;
+            tr = TransformMulti_4way;
+        }
+
+        memset(buffer, 0, 64 * blocks * lanes);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            unsigned char message[128] = {};
+            memcpy(message, in + lane * len, len);
+            message[len] = 0x80;
+            WriteBE64(message + 64 * blocks - 8, uint64_t{len} << 3);
+            for (size_t block = 0; block < blocks; ++block) {
+                memcpy(buffer + 64 * (block * lanes + lane), message + 64 * block, 64);
+            }
+            sha256::Initialize(s + 8 * lane);
+        }
+        for (size_t block = 0; block < blocks; ++block) {
+            if (tr) {
+                tr(s, buffer + 64 * block * lanes);
+            } else {
+                Transform(s, buffer + 64 * block, 1);
+            }
+        }
+
+        memset(buffer, 0, 64 * lanes);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            unsigned char* digest = buffer + 64 * lane;
+            for (size_t i = 0; i < 8; ++i) {
+                WriteBE32(digest + 4 * i, s[8 * lane + i]);
+            }
+            digest[32] = 0x80;
+            digest[62] = 1;
+            sha256::Initialize(s + 8 * lane);
+        }
+        if (tr) {
+            tr(s, buffer);
+        } else {
+            Transform(s, buffer, 1);
+        }
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            for (size_t i = 0; i < 8; ++i) {
+                WriteBE32(out + 32 * lane + 4 * i, s[8 * lane + i]);
+            }
+        }
+        out += 32 * lanes;
+        in += len * lanes;
+        count -= lanes;
+    }
+}
+
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
     if (TransformD64_8way) {
@@ -38,4 +38,12 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute multiple double-SHA256's of equally long messages of at most 119 bytes.
+ *  output:  pointer to a count*32 byte output buffer
+ *  input:   pointer to a count*len byte input buffer
+ *  len:     the length of every message
+ *  count:   the number of hashes to compute.
+ */
+void SHA256DBatch(unsigned char* output, const unsigned char* input, size_t len, size_t count);
+
 #endif // DEFI_CRYPTO_SHA256_H
@@ -66,6 +66,33 @@ void inline Write8(unsigned char* out, int offset, __m256i v) {
     WriteLE32(out + 224 + offset, _mm256_extract_epi32(v, 0));
 }
 
+/** SHA-256 round constants. */
+const uint32_t kRoundConstants[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul
+};
+
+__m256i inline LoadState8(const uint32_t* s, int i) {
+    return _mm256_set_epi32(s[i], s[8 + i], s[16 + i], s[24 + i], s[32 + i], s[40 + i], s[48 + i], s[56 + i]);
+}
+
+void inline StoreState8(uint32_t* s, int i, __m256i v) {
+    s[i] = _mm256_extract_epi32(v, 7);
+    s[8 + i] = _mm256_extract_epi32(v, 6);
+    s[16 + i] = _mm256_extract_epi32(v, 5);
+    s[24 + i] = _mm256_extract_epi32(v, 4);
+    s[32 + i] = _mm256_extract_epi32(v, 3);
+    s[40 + i] = _mm256_extract_epi32(v, 2);
+    s[48 + i] = _mm256_extract_epi32(v, 1);
+    s[56 + i] = _mm256_extract_epi32(v, 0);
+}
+
 }
 
 void Transform_8way(unsigned char* out, const unsigned char* in)
@@ -319,6 +346,50 @@ void Transform_8way(unsigned char* out, const unsigned char* in)
     Write8(out, 28, Add(h, K(0x5be0cd19ul)));
 }
 
+/** Compress one block per lane, lane i's state at s + 8 * i and its block at in + 64 * i. */
+void TransformMulti_8way(uint32_t* s, const unsigned char* in)
+{
+    __m256i a = LoadState8(s, 0);
+    __m256i b = LoadState8(s, 1);
+    __m256i c = LoadState8(s, 2);
+    __m256i d = LoadState8(s, 3);
+    __m256i e = LoadState8(s, 4);
+    __m256i f = LoadState8(s, 5);
+    __m256i g = LoadState8(s, 6);
+    __m256i h = LoadState8(s, 7);
+
+    __m256i w[16];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = Read8(in, 4 * i);
+    }
+
+    __m256i t[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            Inc(w[i & 15], sigma1(w[(i + 14) & 15]), w[(i + 9) & 15], sigma0(w[(i + 1) & 15]));
+        }
+        __m256i t1 = Add(t[7], Sigma1(t[4]), Ch(t[4], t[5], t[6]), K(kRoundConstants[i]), w[i & 15]);
+        __m256i t2 = Add(Sigma0(t[0]), Maj(t[0], t[1], t[2]));
+        t[7] = t[6];
+        t[6] = t[5];
+        t[5] = t[4];
+        t[4] = Add(t[3], t1);
+        t[3] = t[2];
+        t[2] = t[1];
+        t[1] = t[0];
+        t[0] = Add(t1, t2);
+    }
+
+    StoreState8(s, 0, Add(a, t[0]));
+    StoreState8(s, 1, Add(b, t[1]));
+    StoreState8(s, 2, Add(c, t[2]));
+    StoreState8(s, 3, Add(d, t[3]));
+    StoreState8(s, 4, Add(e, t[4]));
+    StoreState8(s, 5, Add(f, t[5]));
+    StoreState8(s, 6, Add(g, t[6]));
+    StoreState8(s, 7, Add(h, t[7]));
+}
+
 }
 
 #endif
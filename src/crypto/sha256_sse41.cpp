@@ -58,6 +58,29 @@ void inline Write4(unsigned char* out, int offset, __m128i v) {
     WriteLE32(out + 96 + offset, _mm_extract_epi32(v, 0));
 }
 
+/** SHA-256 round constants. */
+const uint32_t kRoundConstants[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul
+};
+
+__m128i inline LoadState4(const uint32_t* s, int i) {
+    return _mm_set_epi32(s[i], s[8 + i], s[16 + i], s[24 + i]);
+}
+
+void inline StoreState4(uint32_t* s, int i, __m128i v) {
+    s[i] = _mm_extract_epi32(v, 3);
+    s[8 + i] = _mm_extract_epi32(v, 2);
+    s[16 + i] = _mm_extract_epi32(v, 1);
+    s[24 + i] = _mm_extract_epi32(v, 0);
+}
+
 }
 
 void Transform_4way(unsigned char* out, const unsigned char* in)
@@ -311,6 +334,50 @@ void Transform_4way(unsigned char* out, const unsigned char* in)
     Write4(out, 28, Add(h, K(0x5be0cd19ul)));
 }
 
+/** Compress one block per lane, lane i's state at s + 8 * i and its block at in + 64 * i. */
+void TransformMulti_4way(uint32_t* s, const unsigned char* in)
+{
+    __m128i a = LoadState4(s, 0);
+    __m128i b = LoadState4(s, 1);
+    __m128i c = LoadState4(s, 2);
+    __m128i d = LoadState4(s, 3);
+    __m128i e = LoadState4(s, 4);
+    __m128i f = LoadState4(s, 5);
+    __m128i g = LoadState4(s, 6);
+    __m128i h = LoadState4(s, 7);
+
+    __m128i w[16];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = Read4(in, 4 * i);
+    }
+
+    __m128i t[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            Inc(w[i & 15], sigma1(w[(i + 14) & 15]), w[(i + 9) & 15], sigma0(w[(i + 1) & 15]));
+        }
+        __m128i t1 = Add(t[7], Sigma1(t[4]), Ch(t[4], t[5], t[6]), K(kRoundConstants[i]), w[i & 15]);
+        __m128i t2 = Add(Sigma0(t[0]), Maj(t[0], t[1], t[2]));
+        t[7] = t[6];
+        t[6] = t[5];
+        t[5] = t[4];
+        t[4] = Add(t[3], t1);
+        t[3] = t[2];
+        t[2] = t[1];
+        t[1] = t[0];
+        t[0] = Add(t1, t2);
+    }
+
+    StoreState4(s, 0, Add(a, t[0]));
+    StoreState4(s, 1, Add(b, t[1]));
+    StoreState4(s, 2, Add(c, t[2]));
+    StoreState4(s, 3, Add(d, t[3]));
+    StoreState4(s, 4, Add(e, t[4]));
+    StoreState4(s, 5, Add(f, t[5]));
+    StoreState4(s, 6, Add(g, t[6]));
+    StoreState4(s, 7, Add(h, t[7]));
+}
+
 }
 
 #endif
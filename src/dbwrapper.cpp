@@ -13,9 +13,138 @@
 #include <memenv.h>
 #include <stdint.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
 
 bool levelDBChecksum{true};
 
+namespace {
+
+// The DeFi state sees hot point reads, the history databases are mostly appended to and
+// scanned in key order, their blocks are larger and compressed. The shares of the cache
+// size they are all opened with add up to one.
+std::map<std::string, DBProfile> dbProfiles{
+    {"enhancedcs", {false, 4 << 10, 16, 0.5, 64 << 20, true}},
+    {"history", {true, 64 << 10, 10, 0.2, 32 << 20, true}},
+    {"burn", {true, 64 << 10, 10, 0.1, 8 << 20, true}},
+    {"vault", {true, 64 << 10, 10, 0.1, 8 << 20, true}},
+    {"anchors", {false, 4 << 10, 16, 0.05, 4 << 20, false}},
+    {"spv", {false, 4 << 10, 16, 0.05, 4 << 20, false}},
+    {"spv_testnet", {false, 4 << 10, 16, 0.05, 4 << 20, false}},
+};
+
+std::shared_ptr<leveldb::Cache> dbCachePool;
+size_t dbCachePoolSize{0};
+
+std::mutex dbsMutex;
+std::set<const CDBWrapper*> dbs;
+
+// Block cache of a database counting its lookups, the blocks are kept in a cache
+// of its own or in the pool
+class CDBBlockCache : public leveldb::Cache {
+public:
+    explicit CDBBlockCache(std::shared_ptr<leveldb::Cache> cache) : cache(std::move(cache)) {}
+
+    Handle* Insert(const leveldb::Slice& key, void* value, size_t charge, void (*deleter)(const leveldb::Slice& key, void* value)) override {
+        return cache->Insert(key, value, charge, deleter);
+    }
+    Handle* Lookup(const leveldb::Slice& key) override {
+        auto handle = cache->Lookup(key);
+        (handle ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+        return handle;
+    }
+    void Release(Handle* handle) override { cache->Release(handle); }
+    void* Value(Handle* handle) override { return cache->Value(handle); }
+    void Erase(const leveldb::Slice& key) override { cache->Erase(key); }
+    uint64_t NewId() override { return cache->NewId(); }
+    void Prune() override { cache->Prune(); }
+    size_t TotalCharge() const override { return cache->TotalCharge(); }
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+private:
+    std::shared_ptr<leveldb::Cache> cache;
+};
+
+} // namespace
+
+DBProfile GetDBProfile(const std::string& name)
+{
+    auto it = dbProfiles.find(name);
+    return it != dbProfiles.end() ? it->second : DBProfile{};
+}
+
+bool ParseDBProfile(const std::string& arg, std::string& error)
+{
+    const auto colon = arg.find(':');
+    if (colon == std::string::npos || colon == 0) {
+        error = strprintf("Invalid database profile '%s', expected <name>:<setting>=<value>[,<setting>=<value>...]", arg);
+        return false;
+    }
+    const auto name = arg.substr(0, colon);
+    auto profile = GetDBProfile(name);
+    std::vector<std::string> settings;
+    boost::split(settings, arg.substr(colon + 1), boost::is_any_of(","));
+    for (const auto& setting : settings) {
+        const auto eq = setting.find('=');
+        const auto key = setting.substr(0, eq);
+        const auto value = eq != std::string::npos ? setting.substr(eq + 1) : std::string{};
+        int64_t number{0};
+        double share{0};
+        if (key == "compression" && (value == "0" || value == "1")) {
+            profile.compression = value == "1";
+        } else if (key == "blocksize" && ParseInt64(value, &number) && number >= 1 << 10 && number <= 4 << 20) {
+            profile.blockSize = number;
+        } else if (key == "bloombits" && ParseInt64(value, &number) && number >= 0 && number <= 64) {
+            profile.bloomBits = number;
+        } else if (key == "cacheshare" && ParseDouble(value, &share) && share > 0 && share <= 1) {
+            profile.cacheShare = share;
+        } else if (key == "writebuffer" && ParseInt64(value, &number) && number >= 1 && number <= 1024) {
+            profile.maxWriteBuffer = static_cast<size_t>(number) << 20;
+        } else if (key == "adaptive" && (value == "0" || value == "1")) {
+            profile.adaptiveCache = value == "1";
+        } else {
+            error = strprintf("Invalid setting '%s' of database profile '%s'", setting, name);
+            return false;
+        }
+    }
+    dbProfiles[name] = profile;
+    return true;
+}
+
+void SetDBCachePool(size_t nCacheSize)
+{
+    // the block caches the adaptive databases would have on their own, put together
+    double shares{0};
+    for (const auto& [name, profile] : dbProfiles) {
+        if (profile.adaptiveCache) {
+            shares += profile.cacheShare;
+        }
+    }
+    dbCachePoolSize = static_cast<size_t>(nCacheSize * shares / 2);
+    // the databases already opened keep the former pool until they are closed
+    dbCachePool = dbCachePoolSize ? std::shared_ptr<leveldb::Cache>(leveldb::NewLRUCache(dbCachePoolSize)) : nullptr;
+}
+
+std::vector<DBStats> GetDBStats()
+{
+    std::vector<DBStats> stats;
+    std::lock_guard<std::mutex> lock(dbsMutex);
+    for (const auto db : dbs) {
+        stats.push_back(db->GetStats());
+    }
+    std::sort(stats.begin(), stats.end(), [](const DBStats& a, const DBStats& b) {
+        return a.name < b.name;
+    });
+    return stats;
+}
+
 class CDefiLevelDBLogger : public leveldb::Logger {
 public:
     // This code is adapted from posix_logger.h, which is why it is using vsprintf.
@@ -99,7 +228,7 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBProfile& profile, bool pooledCache)
 {
     const auto ceil_power_of_two = [](size_t v) {
         v--;
@@ -108,12 +237,13 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         return v;
     };
 
+    nCacheSize = static_cast<size_t>(nCacheSize * profile.cacheShare);
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = ceil_power_of_two(std::min(static_cast<size_t>(64)
-     << 20, nCacheSize / 4)); // Max of 64mb -more is not useful
-    options.filter_policy = leveldb::NewBloomFilterPolicy(16);
-    options.compression = leveldb::kNoCompression;
+    options.block_cache = new CDBBlockCache(pooledCache ? dbCachePool : std::shared_ptr<leveldb::Cache>(leveldb::NewLRUCache(nCacheSize / 2)));
+    options.write_buffer_size = ceil_power_of_two(std::min(profile.maxWriteBuffer, nCacheSize / 4)); // Max of 64mb by default -more is not useful
+    options.block_size = profile.blockSize;
+    options.filter_policy = profile.bloomBits ? leveldb::NewBloomFilterPolicy(profile.bloomBits) : nullptr;
+    options.compression = profile.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
     options.info_log = new CDefiLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -125,14 +255,15 @@ static leveldb::Options GetOptions(size_t nCacheSize)
 }
 
 CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
-    : m_name{path.stem().string()}
+    : m_name{path.stem().string()}, m_profile{GetDBProfile(m_name)}, m_pooled_cache{m_profile.adaptiveCache && dbCachePool}
 {
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, m_profile, m_pooled_cache);
+    m_block_cache_size = m_pooled_cache ? 0 : static_cast<size_t>(nCacheSize * m_profile.cacheShare / 2);
     options.create_if_missing = true;
 
     readoptions.verify_checksums = levelDBChecksum;
@@ -178,10 +309,17 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     }
 
     LogPrintf("Using obfuscation key for %s: %s\n", path.string(), HexStr(obfuscate_key));
+
+    std::lock_guard<std::mutex> lock(dbsMutex);
+    dbs.insert(this);
 }
 
 CDBWrapper::~CDBWrapper()
 {
+    {
+        std::lock_guard<std::mutex> lock(dbsMutex);
+        dbs.erase(this);
+    }
     delete pdb;
     pdb = nullptr;
     delete options.filter_policy;
@@ -220,6 +358,25 @@ size_t CDBWrapper::DynamicMemoryUsage() const {
     return stoul(memory);
 }
 
+DBStats CDBWrapper::GetStats() const
+{
+    DBStats stats;
+    stats.name = m_name;
+    stats.profile = m_profile;
+    stats.pooledCache = m_pooled_cache;
+    const auto cache = static_cast<const CDBBlockCache*>(options.block_cache);
+    stats.blockCacheSize = m_pooled_cache ? dbCachePoolSize : m_block_cache_size;
+    stats.blockCacheUsage = cache->TotalCharge();
+    stats.cacheHits = cache->hits.load(std::memory_order_relaxed);
+    stats.cacheMisses = cache->misses.load(std::memory_order_relaxed);
+    stats.memoryUsage = DynamicMemoryUsage();
+    const leveldb::Range range(leveldb::Slice("", 0), leveldb::Slice("\xff\xff\xff\xff", 4));
+    uint64_t size{0};
+    pdb->GetApproximateSizes(&range, 1, &size);
+    stats.diskSize = size;
+    return stats;
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -252,6 +409,11 @@ bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
 void CDBIterator::Next() { piter->Next(); }
 void CDBIterator::Prev() { piter->Prev(); }
+bool CDBIterator::IsObfuscated() const
+{
+    const auto& key = dbwrapper_private::GetObfuscateKey(parent);
+    return std::any_of(key.begin(), key.end(), [](unsigned char c) { return c != 0; });
+}
 
 namespace dbwrapper_private {
 
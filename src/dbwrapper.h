@@ -19,9 +19,51 @@
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 static const std::string DEFAULT_LEVELDB_CHECKSUM = "auto";
+static const bool DEFAULT_DB_CACHE_ADAPTIVE = true;
 
 extern bool levelDBChecksum;
 
+//! LevelDB tuning of the databases opened under a name
+struct DBProfile {
+    //! snappy compressed blocks, stored as they are where snappy is not available
+    bool compression{false};
+    size_t blockSize{4 << 10};
+    //! bits per key of the bloom filter, 0 for none
+    int bloomBits{16};
+    //! part of the cache size the database is opened with it uses
+    double cacheShare{1.0};
+    //! bound of the write buffer, which takes a quarter of the database's cache at most
+    size_t maxWriteBuffer{64 << 20};
+    //! block cache taken from the pool shared by the adaptive databases, if there is one
+    bool adaptiveCache{false};
+};
+
+//! Profile of the databases opened under the name, the default one for names without their own
+DBProfile GetDBProfile(const std::string& name);
+//! Applies "<name>:<setting>=<value>[,<setting>=<value>...]" to the profile of the databases under the name
+bool ParseDBProfile(const std::string& arg, std::string& error);
+//! Pools the block caches of the adaptive databases opened with the cache size. The pool evicts the
+//! least recently used blocks of any of them, so their parts of it follow the blocks their reads keep
+//! hitting. Set before they are opened, a size of 0 gives every database a cache of its own.
+void SetDBCachePool(size_t nCacheSize);
+
+struct DBStats {
+    std::string name;
+    DBProfile profile;
+    //! size of the database's own block cache or of the pool
+    size_t blockCacheSize{};
+    //! charge of the cached blocks, of every database sharing the pool
+    size_t blockCacheUsage{};
+    bool pooledCache{};
+    uint64_t cacheHits{};
+    uint64_t cacheMisses{};
+    size_t memoryUsage{};
+    size_t diskSize{};
+};
+
+//! Stats of the open databases
+std::vector<DBStats> GetDBStats();
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -191,6 +233,19 @@ public:
         return piter->value().size();
     }
 
+    /** Raw key bytes, valid until the iterator moves. */
+    Span<const unsigned char> GetKeyView() const {
+        leveldb::Slice slKey = piter->key();
+        return {reinterpret_cast<const unsigned char*>(slKey.data()), static_cast<std::ptrdiff_t>(slKey.size())};
+    }
+
+    /** Raw value bytes, valid until the iterator moves. Only usable when the database is not obfuscated. */
+    Span<const unsigned char> GetValueView() const {
+        leveldb::Slice slValue = piter->value();
+        return {reinterpret_cast<const unsigned char*>(slValue.data()), static_cast<std::ptrdiff_t>(slValue.size())};
+    }
+
+    bool IsObfuscated() const;
 };
 
 //template<>
@@ -235,6 +290,15 @@ private:
     //! the name of this database
     std::string m_name;
 
+    //! the profile this database was opened with
+    DBProfile m_profile;
+
+    //! whether the block cache is the adaptive databases' pool
+    bool m_pooled_cache{false};
+
+    //! size of the block cache of its own
+    size_t m_block_cache_size{0};
+
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
@@ -329,6 +393,8 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    DBStats GetStats() const;
+
     // not available for LevelDB; provide for compatibility with BDB
     bool Flush()
     {
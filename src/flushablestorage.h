@@ -11,12 +11,42 @@
 #include <functional>
 #include <map>
 #include <memusage.h>
+#include <span.h>
 
+#include <array>
+#include <cstring>
+#include <limits>
 #include <optional>
 
 using TBytes = std::vector<unsigned char>;
+using TBytesView = Span<const unsigned char>;
 using MapKV = std::map<TBytes, std::optional<TBytes>>;
 
+inline TBytesView MakeBytesView(const TBytes& bytes) {
+    return TBytesView{bytes.data(), static_cast<std::ptrdiff_t>(bytes.size())};
+}
+
+// Same ordering as std::vector<unsigned char>::operator<
+inline int CompareBytes(TBytesView a, TBytesView b) {
+    auto size = std::min(a.size(), b.size());
+    if (size > 0) {
+        if (auto cmp = std::memcmp(a.data(), b.data(), size)) {
+            return cmp;
+        }
+    }
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+// Storage operations of the views on this thread, sampled by the DfTx stats
+struct CStorageOpCounters {
+    uint64_t reads{};
+    uint64_t writes{};
+    // serialized keys and values the operations moved
+    uint64_t bytes{};
+};
+
+inline thread_local CStorageOpCounters storageOpCounters;
+
 template<typename T>
 static TBytes DbTypeToBytes(const T& value) {
     TBytes bytes;
@@ -25,11 +55,29 @@ static TBytes DbTypeToBytes(const T& value) {
     return bytes;
 }
 
+// Types with a virtual Unserialize(VectorReader&), i.e. gov variables, can't be read from a span
+template<typename T, typename Stream, typename = void>
+struct HasUnserializeFrom : std::false_type {};
+
+template<typename T, typename Stream>
+struct HasUnserializeFrom<T, Stream, std::void_t<decltype(std::declval<T&>().Unserialize(std::declval<Stream&>()))>>
+    : std::true_type {};
+
 template<typename T>
-static bool BytesToDbType(const TBytes& bytes, T& value) {
+using IsVectorOnlyUnserializable = std::bool_constant<HasUnserializeFrom<T, VectorReader>::value &&
+                                                      !HasUnserializeFrom<T, SpanReader>::value>;
+
+template<typename T>
+static bool BytesToDbType(TBytesView bytes, T& value) {
     try {
-        VectorReader stream(SER_DISK, CLIENT_VERSION, bytes, 0);
-        stream >> value;
+        if constexpr (IsVectorOnlyUnserializable<T>::value) {
+            const TBytes copy(bytes.begin(), bytes.end());
+            VectorReader stream(SER_DISK, CLIENT_VERSION, copy, 0);
+            stream >> value;
+        } else {
+            SpanReader stream(SER_DISK, CLIENT_VERSION, bytes);
+            stream >> value;
+        }
 //        assert(stream.size() == 0); // will fail with partial key matching
     }
     catch (std::ios_base::failure&) {
@@ -38,6 +86,11 @@ static bool BytesToDbType(const TBytes& bytes, T& value) {
     return true;
 }
 
+template<typename T>
+static bool BytesToDbType(const TBytes& bytes, T& value) {
+    return BytesToDbType(MakeBytesView(bytes), value);
+}
+
 // Key-Value storage iterator interface
 class CStorageKVIterator {
 public:
@@ -46,8 +99,18 @@ public:
     virtual void Next() = 0;
     virtual void Prev() = 0;
     virtual bool Valid() = 0;
-    virtual TBytes Key() = 0;
-    virtual TBytes Value() = 0;
+    // Views into the iterator's current record, valid until it moves
+    virtual TBytesView KeyView() = 0;
+    virtual TBytesView ValueView() = 0;
+
+    TBytes Key() {
+        auto key = KeyView();
+        return {key.begin(), key.end()};
+    }
+    TBytes Value() {
+        auto value = ValueView();
+        return {value.begin(), value.end()};
+    }
 };
 
 // Represents an empty iterator
@@ -58,8 +121,8 @@ public:
     void Next() override {}
     void Prev() override {}
     bool Valid() override { return false; }
-    TBytes Key() override { return {}; }
-    TBytes Value() override { return {}; }
+    TBytesView KeyView() override { return {}; }
+    TBytesView ValueView() override { return {}; }
 };
 
 // Key-Value storage interface
@@ -74,6 +137,8 @@ public:
     virtual size_t SizeEstimate() const = 0;
     virtual void Discard() = 0;
     virtual bool Flush() = 0;
+    // Moves whenever a record under the key prefix may have changed in this or an underlying layer
+    virtual uint64_t PrefixVersion(uint8_t prefix) const { return 0; }
 };
 
 // doesn't serialize/deserialize vector size
@@ -103,7 +168,7 @@ inline RawTBytes<T> refTBytes(T& val) {
 // LevelDB glue layer Iterator
 class CStorageLevelDBIterator : public CStorageKVIterator {
 public:
-    explicit CStorageLevelDBIterator(std::unique_ptr<CDBIterator>&& it) : it{std::move(it)} { }
+    explicit CStorageLevelDBIterator(std::unique_ptr<CDBIterator>&& it) : it{std::move(it)}, obfuscated{this->it->IsObfuscated()} { }
     CStorageLevelDBIterator(const CStorageLevelDBIterator&) = delete;
     ~CStorageLevelDBIterator() override = default;
 
@@ -119,18 +184,21 @@ public:
     bool Valid() override {
         return it->Valid();
     }
-    TBytes Key() override {
-        TBytes key;
-        auto rawKey = refTBytes(key);
-        return it->GetKey(rawKey) ? key : TBytes{};
+    TBytesView KeyView() override {
+        return it->GetKeyView();
     }
-    TBytes Value() override {
-        TBytes value;
+    TBytesView ValueView() override {
+        if (!obfuscated) {
+            return it->GetValueView();
+        }
         auto rawValue = refTBytes(value);
-        return it->GetValue(rawValue) ? value : TBytes{};
+        return it->GetValue(rawValue) ? MakeBytesView(value) : TBytesView{};
     }
 private:
     std::unique_ptr<CDBIterator> it;
+    const bool obfuscated;
+    // de-obfuscated copy of the current value
+    TBytes value;
 };
 
 // LevelDB glue layer storage
@@ -183,10 +251,314 @@ private:
 
 // Flashable storage
 
+// Sorted write buffer of the flushable storage. Keys and values are copied into
+// an append-only arena, entries are kept in a sorted flat vector and a small
+// sorted vector of recent insertions which is merged in once it grows, so lookups
+// are binary searches and ordered iteration is a linear walk over both.
+// Erased keys are kept as tombstones, they have to hide the parent's records.
+class CKVWriteBuffer {
+    static constexpr uint32_t ERASED = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t MIN_CHUNK_SIZE = 1024;
+    static constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;
+    static constexpr size_t MIN_DELTA_SIZE = 64;
+
+    struct Entry {
+        // leading key bytes, most comparisons are decided without touching the arena
+        uint64_t head;
+        const unsigned char* key;
+        const unsigned char* value;
+        uint32_t keySize;
+        uint32_t valueSize;
+
+        TBytesView Key() const { return {key, keySize}; }
+        TBytesView Value() const { return {value, valueSize}; }
+        bool Erased() const { return valueSize == ERASED; }
+    };
+
+    // Zero padded big endian head, heads order as the keys do whenever they differ
+    static uint64_t Head(TBytesView key) {
+        uint64_t head{};
+        auto size = std::min<std::ptrdiff_t>(key.size(), 8);
+        for (std::ptrdiff_t i = 0; i < 8; ++i) {
+            head = (head << 8) | (i < size ? key[i] : 0);
+        }
+        return head;
+    }
+    static int Compare(const Entry& entry, uint64_t head, TBytesView key) {
+        if (entry.head != head) {
+            return entry.head < head ? -1 : 1;
+        }
+        return CompareBytes(entry.Key(), key);
+    }
+    static int Compare(const Entry& a, const Entry& b) {
+        return Compare(a, b.head, b.Key());
+    }
+
+public:
+    struct value_type {
+        TBytesView key;
+        std::optional<TBytesView> value;
+    };
+
+    // Ordered position over both entry vectors. It survives insertions into the buffer,
+    // when the layout changes it re-seeks to the key it was positioned at.
+    class Cursor {
+    public:
+        explicit Cursor(const CKVWriteBuffer& buffer) : buffer(buffer) {}
+
+        // Positions at the first key not less than the given one
+        void Seek(TBytesView target) {
+            Reset(target);
+            Pick();
+        }
+        // Positions at the last key less than the given one
+        void SeekBefore(TBytesView target) {
+            Reset(target);
+            StepBack();
+        }
+        void Next() {
+            assert(valid);
+            Sync();
+            inMain ? ++im : ++id;
+            Pick();
+        }
+        void Prev() {
+            assert(valid);
+            Sync();
+            StepBack();
+        }
+        bool Valid() const {
+            return valid;
+        }
+        // the buffer layout has changed since the last positioning
+        bool Stale() const {
+            return version != buffer.version;
+        }
+        TBytesView Key() const {
+            assert(valid);
+            return key;
+        }
+        // may be called after writes to the buffer
+        const Entry& Current() {
+            assert(valid);
+            Sync();
+            return inMain ? buffer.main[im] : buffer.delta[id];
+        }
+
+    private:
+        void Reset(TBytesView target) {
+            version = buffer.version;
+            im = LowerBound(buffer.main, target);
+            id = LowerBound(buffer.delta, target);
+        }
+        void Sync() {
+            if (version != buffer.version) {
+                Reset(key);
+                inMain = im < buffer.main.size() && CompareBytes(buffer.main[im].Key(), key) == 0;
+            }
+        }
+        // im and id always point to the first entry not less than the current key
+        void Pick() {
+            auto m = im < buffer.main.size();
+            auto d = id < buffer.delta.size();
+            valid = m || d;
+            if (valid) {
+                inMain = m && (!d || Compare(buffer.main[im], buffer.delta[id]) < 0);
+                key = inMain ? buffer.main[im].Key() : buffer.delta[id].Key();
+            }
+        }
+        void StepBack() {
+            auto m = im > 0;
+            auto d = id > 0;
+            valid = m || d;
+            if (valid) {
+                inMain = m && (!d || Compare(buffer.main[im - 1], buffer.delta[id - 1]) > 0);
+                inMain ? --im : --id;
+                key = inMain ? buffer.main[im].Key() : buffer.delta[id].Key();
+            }
+        }
+
+        const CKVWriteBuffer& buffer;
+        uint64_t version{};
+        size_t im{}, id{};
+        bool inMain{};
+        bool valid{};
+        TBytesView key;
+    };
+
+    class const_iterator {
+    public:
+        const_iterator(const CKVWriteBuffer& buffer, bool end) : cursor(buffer) {
+            if (!end) {
+                cursor.Seek({});
+            }
+        }
+        value_type operator*() {
+            const auto& entry = cursor.Current();
+            return {entry.Key(), entry.Erased() ? std::optional<TBytesView>{} : entry.Value()};
+        }
+        const_iterator& operator++() {
+            cursor.Next();
+            return *this;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return cursor.Valid() != other.cursor.Valid() || (cursor.Valid() && cursor.Key().data() != other.cursor.Key().data());
+        }
+    private:
+        Cursor cursor;
+    };
+
+    CKVWriteBuffer() = default;
+    CKVWriteBuffer(const CKVWriteBuffer&) = delete;
+    CKVWriteBuffer& operator=(const CKVWriteBuffer&) = delete;
+
+    const Entry* Find(TBytesView key) const {
+        if (auto entry = Find(main, key)) {
+            return entry;
+        }
+        return Find(delta, key);
+    }
+    void Write(TBytesView key, TBytesView value) {
+        if (auto entry = const_cast<Entry*>(Find(key))) {
+            SetValue(*entry, value);
+            return;
+        }
+        Entry entry{Head(key), Store(key), nullptr, static_cast<uint32_t>(key.size()), ERASED};
+        SetValue(entry, value);
+        Insert(entry);
+    }
+    void Erase(TBytesView key) {
+        if (auto entry = const_cast<Entry*>(Find(key))) {
+            entry->valueSize = ERASED;
+            return;
+        }
+        Insert({Head(key), Store(key), nullptr, static_cast<uint32_t>(key.size()), ERASED});
+    }
+    void Clear() {
+        main.clear();
+        delta.clear();
+        chunks.clear();
+        chunkUsed = chunkSize = arenaUsage = 0;
+        ++version;
+    }
+    bool Empty() const {
+        return main.empty() && delta.empty();
+    }
+    size_t Size() const {
+        return main.size() + delta.size();
+    }
+    TBytesView FrontKey() const {
+        assert(!Empty());
+        if (delta.empty() || (!main.empty() && Compare(main.front(), delta.front()) < 0)) {
+            return main.front().Key();
+        }
+        return delta.front().Key();
+    }
+    TBytesView BackKey() const {
+        assert(!Empty());
+        if (delta.empty() || (!main.empty() && Compare(main.back(), delta.back()) > 0)) {
+            return main.back().Key();
+        }
+        return delta.back().Key();
+    }
+    size_t DynamicUsage() const {
+        return arenaUsage + memusage::DynamicUsage(main) + memusage::DynamicUsage(delta) + memusage::DynamicUsage(chunks);
+    }
+    const_iterator begin() const {
+        return {*this, false};
+    }
+    const_iterator end() const {
+        return {*this, true};
+    }
+    bool operator==(const CKVWriteBuffer& other) const {
+        if (Size() != other.Size()) {
+            return false;
+        }
+        for (auto it = begin(), oit = other.begin(); it != end(); ++it, ++oit) {
+            auto [key, value] = *it;
+            auto [okey, ovalue] = *oit;
+            if (key != okey || bool(value) != bool(ovalue) || (value && *value != *ovalue)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const CKVWriteBuffer& other) const {
+        return !(*this == other);
+    }
+
+private:
+    static size_t LowerBound(const std::vector<Entry>& entries, TBytesView key) {
+        auto head = Head(key);
+        return std::lower_bound(entries.begin(), entries.end(), key, [head](const Entry& entry, TBytesView key) {
+            return Compare(entry, head, key) < 0;
+        }) - entries.begin();
+    }
+    static const Entry* Find(const std::vector<Entry>& entries, TBytesView key) {
+        auto pos = LowerBound(entries, key);
+        if (pos < entries.size() && CompareBytes(entries[pos].Key(), key) == 0) {
+            return &entries[pos];
+        }
+        return nullptr;
+    }
+    void Insert(const Entry& entry) {
+        delta.insert(delta.begin() + LowerBound(delta, entry.Key()), entry);
+        ++version;
+        // keeps insertion cost around sqrt(n) copies per entry
+        if (delta.size() > MIN_DELTA_SIZE && delta.size() * delta.size() > 4 * main.size()) {
+            std::vector<Entry> merged;
+            merged.reserve(main.size() + delta.size());
+            std::merge(main.begin(), main.end(), delta.begin(), delta.end(), std::back_inserter(merged), [](const Entry& a, const Entry& b) {
+                return Compare(a, b) < 0;
+            });
+            main.swap(merged);
+            delta.clear();
+        }
+    }
+    void SetValue(Entry& entry, TBytesView value) {
+        // overwrite in place when it fits, otherwise the old value stays in the arena until Clear
+        if (!entry.Erased() && static_cast<size_t>(value.size()) <= entry.valueSize) {
+            if (value.size() > 0) {
+                std::memcpy(const_cast<unsigned char*>(entry.value), value.data(), value.size());
+            }
+        } else {
+            entry.value = Store(value);
+        }
+        entry.valueSize = static_cast<uint32_t>(value.size());
+    }
+    const unsigned char* Store(TBytesView bytes) {
+        static const unsigned char empty{};
+        if (bytes.size() == 0) {
+            return &empty;
+        }
+        size_t size = bytes.size();
+        if (chunks.empty() || chunkUsed + size > chunkSize) {
+            // chunks grow with the buffer, short-lived views stay small
+            chunkSize = std::max(size, std::min(MAX_CHUNK_SIZE, std::max(MIN_CHUNK_SIZE, arenaUsage)));
+            chunks.emplace_back(new unsigned char[chunkSize]);
+            chunkUsed = 0;
+            arenaUsage += chunkSize;
+        }
+        auto ptr = chunks.back().get() + chunkUsed;
+        std::memcpy(ptr, bytes.data(), size);
+        chunkUsed += size;
+        return ptr;
+    }
+
+    std::vector<Entry> main;
+    std::vector<Entry> delta;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+    size_t chunkUsed{};
+    size_t chunkSize{};
+    size_t arenaUsage{};
+    // bumped on every layout change, lets cursors detect shifted positions
+    uint64_t version{};
+};
+
 // Flushable Key-Value Storage Iterator
 class CFlushableStorageKVIterator : public CStorageKVIterator {
 public:
-    explicit CFlushableStorageKVIterator(std::unique_ptr<CStorageKVIterator>&& pIt, MapKV& map) : map(map), pIt(std::move(pIt)) {
+    explicit CFlushableStorageKVIterator(std::unique_ptr<CStorageKVIterator>&& pIt, const CKVWriteBuffer& buffer) : bIt(buffer), pIt(std::move(pIt)) {
         itState = Invalid;
     }
     CFlushableStorageKVIterator(const CFlushableStorageKVIterator&) = delete;
@@ -194,75 +566,102 @@ public:
 
     void Seek(const TBytes& key) override {
         pIt->Seek(key);
-        mIt = Advance(map.lower_bound(key), map.end(), std::greater<TBytes>{}, {});
+        bIt.Seek(MakeBytesView(key));
+        forward = true;
+        Advance();
     }
     void Next() override {
         assert(Valid());
-        mIt = Advance(mIt, map.end(), std::greater<TBytes>{}, Key());
+        auto key = StableKey();
+        if (!forward) {
+            pIt->Seek(TBytes(key.begin(), key.end()));
+            bIt.Seek(key);
+            forward = true;
+        } else if (bIt.Stale()) {
+            // keys could have been written between the current one and the cursor
+            bIt.Seek(key);
+        }
+        // both are positioned at the current key or past it
+        if (pIt->Valid() && CompareBytes(pIt->KeyView(), key) == 0) {
+            pIt->Next();
+        }
+        if (bIt.Valid() && CompareBytes(bIt.Key(), key) == 0) {
+            bIt.Next();
+        }
+        Advance();
     }
     void Prev() override {
         assert(Valid());
-        auto tmp = mIt;
-        if (tmp != map.end()) {
-            ++tmp;
-        }
-        auto it = std::reverse_iterator<decltype(tmp)>(tmp);
-        auto end = Advance(it, map.rend(), std::less<TBytes>{}, Key());
-        if (end == map.rend()) {
-            mIt = map.begin();
+        auto key = StableKey();
+        if (forward) {
+            while (pIt->Valid() && CompareBytes(pIt->KeyView(), key) >= 0) {
+                pIt->Prev();
+            }
+            bIt.SeekBefore(key);
+            forward = false;
         } else {
-            auto offset = mIt == map.end() ? 1 : 0;
-            std::advance(mIt, -std::distance(it, end) - offset);
+            // both are positioned at the current key or before it
+            if (pIt->Valid() && CompareBytes(pIt->KeyView(), key) == 0) {
+                pIt->Prev();
+            }
+            if (bIt.Stale()) {
+                bIt.SeekBefore(key);
+            } else if (bIt.Valid() && CompareBytes(bIt.Key(), key) == 0) {
+                bIt.Prev();
+            }
         }
+        Advance();
     }
     bool Valid() override {
         return itState != Invalid;
     }
-    TBytes Key() override {
+    TBytesView KeyView() override {
         assert(Valid());
-        return itState == Map ? mIt->first : pIt->Key();
+        return itState == Buffer ? bIt.Key() : pIt->KeyView();
     }
-    TBytes Value() override {
+    TBytesView ValueView() override {
         assert(Valid());
-        return itState == Map ? *mIt->second : pIt->Value();
+        return itState == Buffer ? bIt.Current().Value() : pIt->ValueView();
     }
 private:
-    template<typename TIterator, typename Compare>
-    TIterator Advance(TIterator it, TIterator end, Compare comp, TBytes prevKey) {
-
-        while (it != end || pIt->Valid()) {
-            while (it != end && (!pIt->Valid() || !comp(it->first, pIt->Key()))) {
-                if (prevKey.empty() || comp(it->first, prevKey)) {
-                    if (it->second) {
-                        itState = Map;
-                        return it;
-                    } else {
-                        prevKey = it->first;
-                    }
-                }
-                ++it;
+    // Settles on the nearest visible record in the current direction,
+    // buffered entries shadow the parent's and tombstones hide them
+    void Advance() {
+        while (true) {
+            auto pValid = pIt->Valid();
+            if (!bIt.Valid()) {
+                itState = pValid ? Parent : Invalid;
+                return;
             }
-            if (pIt->Valid()) {
-                if (prevKey.empty() || comp(pIt->Key(), prevKey)) {
-                    itState = Parent;
-                    return it;
-                }
-                NextParent(it);
+            auto cmp = pValid ? CompareBytes(bIt.Key(), pIt->KeyView()) : 0;
+            if (pValid && (forward ? cmp > 0 : cmp < 0)) {
+                itState = Parent;
+                return;
+            }
+            if (!bIt.Current().Erased()) {
+                itState = Buffer;
+                return;
             }
+            if (pValid && cmp == 0) {
+                forward ? pIt->Next() : pIt->Prev();
+            }
+            forward ? bIt.Next() : bIt.Prev();
         }
-        itState = Invalid;
-        return it;
-    }
-    void NextParent(MapKV::const_iterator&) {
-        pIt->Next();
     }
-    void NextParent(std::reverse_iterator<MapKV::const_iterator>&) {
-        pIt->Prev();
+    // Current key which stays valid while the parent moves, buffer keys live in its arena
+    TBytesView StableKey() {
+        if (itState == Buffer) {
+            return bIt.Key();
+        }
+        auto key = pIt->KeyView();
+        keyCopy.assign(key.begin(), key.end());
+        return MakeBytesView(keyCopy);
     }
-    const MapKV& map;
-    MapKV::const_iterator mIt;
+    CKVWriteBuffer::Cursor bIt;
     std::unique_ptr<CStorageKVIterator> pIt;
-    enum IteratorState { Invalid, Map, Parent } itState;
+    TBytes keyCopy;
+    bool forward{true};
+    enum IteratorState { Invalid, Buffer, Parent } itState;
 };
 
 // Flushable Key-Value Storage
@@ -273,61 +672,79 @@ public:
     ~CFlushableStorageKV() override = default;
 
     bool Exists(const TBytes& key) const override {
-        auto it = changed.find(key);
-        if (it != changed.end()) {
-            return bool(it->second);
+        if (auto entry = changed.Find(MakeBytesView(key))) {
+            return !entry->Erased();
         }
         return db.Exists(key);
     }
     bool Write(const TBytes& key, const TBytes& value) override {
-        changed[key] = value;
+        changed.Write(MakeBytesView(key), MakeBytesView(value));
+        BumpVersion(key);
         return true;
     }
     bool Erase(const TBytes& key) override {
-        changed[key] = {};
+        changed.Erase(MakeBytesView(key));
+        BumpVersion(key);
         return true;
     }
     bool Read(const TBytes& key, TBytes& value) const override {
-        auto it = changed.find(key);
-        if (it == changed.end()) {
+        auto entry = changed.Find(MakeBytesView(key));
+        if (!entry) {
             return db.Read(key, value);
-        } else if (it->second) {
-            value = it->second.value();
+        } else if (!entry->Erased()) {
+            auto raw = entry->Value();
+            value.assign(raw.begin(), raw.end());
             return true;
         } else {
             return false;
         }
     }
     bool Flush() override {
-        for (const auto& it : changed) {
-            if (!it.second) {
-                if (!db.Erase(it.first)) {
+        for (const auto& [key, value] : changed) {
+            TBytes rawKey(key.begin(), key.end());
+            if (!value) {
+                if (!db.Erase(rawKey)) {
                     return false;
                 }
-            } else if (!db.Write(it.first, it.second.value())) {
+            } else if (!db.Write(rawKey, TBytes(value->begin(), value->end()))) {
                 return false;
             }
         }
-        changed.clear();
+        changed.Clear();
         return true;
     }
     void Discard() override {
-        changed.clear();
+        changed.Clear();
+        for (auto& version : versions) {
+            ++version;
+        }
     }
     size_t SizeEstimate() const override {
-        return memusage::DynamicUsage(changed);
+        return changed.DynamicUsage();
+    }
+    uint64_t PrefixVersion(uint8_t prefix) const override {
+        return versions[prefix] + db.PrefixVersion(prefix);
+    }
+    // Version of this layer alone, zero while nothing under the prefix was written to it
+    uint64_t LayerVersion(uint8_t prefix) const {
+        return versions[prefix];
     }
     std::unique_ptr<CStorageKVIterator> NewIterator() override {
         return std::make_unique<CFlushableStorageKVIterator>(db.NewIterator(), changed);
     }
 
-    MapKV& GetRaw() {
+    CKVWriteBuffer& GetRaw() {
         return changed;
     }
 
 private:
+    void BumpVersion(const TBytes& key) {
+        ++versions[key.empty() ? 0 : key[0]];
+    }
+
     CStorageKV& db;
-    MapKV changed;
+    CKVWriteBuffer changed;
+    std::array<uint64_t, 256> versions{};
 };
 
 template<typename T>
@@ -349,10 +766,16 @@ public:
     const T& get() {
         if (!value) {
             value = T{};
-            BytesToDbType(it->Value(), *value);
+            auto raw = it->ValueView();
+            storageOpCounters.bytes += raw.size();
+            BytesToDbType(raw, *value);
         }
         return *value;
     }
+    // the value as stored, valid until the iterator moves
+    TBytesView raw() const {
+        return it->ValueView();
+    }
 };
 
 template<typename By, typename KeyType>
@@ -362,7 +785,15 @@ class CStorageIteratorWrapper {
     std::unique_ptr<CStorageKVIterator> it;
 
     void UpdateValidity() {
-        valid = it->Valid() && BytesToDbType(it->Key(), key) && key.first == By::prefix();
+        if (!it->Valid()) {
+            valid = false;
+            return;
+        }
+        // cheap end of range check before decoding the key
+        auto rawKey = it->KeyView();
+        ++storageOpCounters.reads;
+        storageOpCounters.bytes += rawKey.size();
+        valid = rawKey.size() > 0 && rawKey[0] == By::prefix() && BytesToDbType(rawKey, key) && key.first == By::prefix();
     }
 
     struct Resolver {
@@ -421,15 +852,17 @@ public:
     template<typename T>
     bool Value(T& value) {
         assert(Valid());
-        return BytesToDbType(it->Value(), value);
+        auto raw = it->ValueView();
+        storageOpCounters.bytes += raw.size();
+        return BytesToDbType(raw, value);
     }
 };
 
 // Creates an iterator to single level key value storage
 template<typename By, typename KeyType>
-CStorageIteratorWrapper<By, KeyType> NewKVIterator(const KeyType& key, MapKV& map) {
+CStorageIteratorWrapper<By, KeyType> NewKVIterator(const KeyType& key, const CKVWriteBuffer& buffer) {
     auto emptyParent = std::make_unique<CStorageKVEmptyIterator>();
-    auto flushableIterator = std::make_unique<CFlushableStorageKVIterator>(std::move(emptyParent), map);
+    auto flushableIterator = std::make_unique<CFlushableStorageKVIterator>(std::move(emptyParent), buffer);
     CStorageIteratorWrapper<By, KeyType> it{std::move(flushableIterator)};
     it.Seek(key);
     return it;
@@ -443,7 +876,10 @@ public:
 
     template<typename KeyType>
     bool Exists(const KeyType& key) const {
-        return DB().Exists(DbTypeToBytes(key));
+        auto vKey = DbTypeToBytes(key);
+        ++storageOpCounters.reads;
+        storageOpCounters.bytes += vKey.size();
+        return DB().Exists(vKey);
     }
     template<typename By, typename KeyType>
     bool ExistsBy(const KeyType& key) const {
@@ -454,6 +890,8 @@ public:
     bool Write(const KeyType& key, const ValueType& value) {
         auto vKey = DbTypeToBytes(key);
         auto vValue = DbTypeToBytes(value);
+        ++storageOpCounters.writes;
+        storageOpCounters.bytes += vKey.size() + vValue.size();
         return DB().Write(vKey, vValue);
     }
     template<typename By, typename KeyType, typename ValueType>
@@ -464,6 +902,8 @@ public:
     template<typename KeyType>
     bool Erase(const KeyType& key) {
         auto vKey = DbTypeToBytes(key);
+        ++storageOpCounters.writes;
+        storageOpCounters.bytes += vKey.size();
         return DB().Exists(vKey) && DB().Erase(vKey);
     }
     template<typename By, typename KeyType>
@@ -475,7 +915,10 @@ public:
     bool Read(const KeyType& key, ValueType& value) const {
         auto vKey = DbTypeToBytes(key);
         TBytes vValue;
-        return DB().Read(vKey, vValue) && BytesToDbType(vValue, value);
+        ++storageOpCounters.reads;
+        auto found = DB().Read(vKey, vValue);
+        storageOpCounters.bytes += vKey.size() + vValue.size();
+        return found && BytesToDbType(vValue, value);
     }
     template<typename By, typename KeyType, typename ValueType>
     bool ReadBy(const KeyType& key, ValueType& value) const {
@@ -505,8 +948,10 @@ public:
     }
 
     virtual bool Flush() { return DB().Flush(); }
-    void Discard() { DB().Discard(); }
+    virtual void Discard() { DB().Discard(); }
     size_t SizeEstimate() const { return DB().SizeEstimate(); }
+    // Storage of the raw records, for tools copying them as they are
+    CStorageKV & RawStorage() { return DB(); }
 
 protected:
     CStorageKV & DB() { return *storage.get(); }
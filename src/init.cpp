@@ -26,10 +26,15 @@
 #include <ain_rs_exports.h>
 #include <masternodes/accountshistory.h>
 #include <masternodes/anchors.h>
+#include <masternodes/dftxstats.h>
 #include <masternodes/govvariables/attributes.h>
 #include <masternodes/masternodes.h>
+#include <masternodes/snapshot.h>
+#include <masternodes/speculative.h>
 #include <masternodes/vaulthistory.h>
 #include <masternodes/threadpool.h>
+#include <masternodes/validation.h>
+#include <masternodes/vaultrisk.h>
 #include <miner.h>
 #include <net.h>
 #include <net_permissions.h>
@@ -91,6 +96,9 @@ static const bool DEFAULT_STOPAFTERBLOCKIMPORT = false;
 
 // Dump addresses to banlist.dat every 15 minutes (900s)
 static constexpr int DUMP_BANS_INTERVAL = 60 * 15;
+// Block index entries whose minter key is stored per background step, and the delay between steps in ms
+static constexpr size_t MINTER_KEY_MIGRATION_BATCH = 10000;
+static constexpr int64_t MINTER_KEY_MIGRATION_INTERVAL = 100;
 
 std::unique_ptr<CConnman> g_connman;
 std::unique_ptr<PeerLogicValidation> peerLogic;
@@ -162,6 +170,16 @@ static std::unique_ptr<ECCVerifyHandle> globalVerifyHandle;
 std::vector<std::thread> threadGroup;
 static CScheduler scheduler;
 
+// Stores the minter keys recovered while loading the block index, a batch at a time
+static void ScheduleMinterKeyMigration()
+{
+    scheduler.scheduleFromNow([]{
+        if (MigrateBlockIndexMinterKeys(MINTER_KEY_MIGRATION_BATCH)) {
+            ScheduleMinterKeyMigration();
+        }
+    }, MINTER_KEY_MIGRATION_INTERVAL);
+}
+
 #if HAVE_SYSTEM
 static void ShutdownNotify()
 {
@@ -422,11 +440,15 @@ void SetupServerArgs()
     gArgs.AddArg("-conf=<file>", strprintf("Specify configuration file. Relative paths will be prefixed by datadir location. (default: %s)", DEFI_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dbcacheadaptive", strprintf("Pool the block caches of the DeFi state and history databases, their parts of it follow the blocks their reads keep hitting (default: %u)", DEFAULT_DB_CACHE_ADAPTIVE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dbprofile=<name>:<setting>=<value>[,...]", "Tune the leveldb databases under the name (enhancedcs, history, burn, vault, anchors, spv, chainstate, index, ...). Settings are compression (0/1), blocksize (bytes), bloombits (0 for no filter), cacheshare (part of the cache the database is opened with, 0 to 1), writebuffer (MiB) and adaptive (0/1, its block cache is pooled). Can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (-nodebuglogfile to disable; default: %s)", DEFAULT_DEBUGLOGFILE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-loadblock=<file>", "Imports blocks from external blk000??.dat file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-loaddefistate=<file>", "Replaces the DeFi state, coins and history databases by a snapshot written by dumpdefistate on startup. The blocks up to the snapshot's block have to be on disk. Relative paths are taken from the datadir.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-loaddefistateroot=<hex>", "State root the snapshot loaded by -loaddefistate has to match, as reported by dumpdefistate on a trusted node. Required by -loaddefistate", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -551,19 +573,23 @@ void SetupServerArgs()
     gArgs.AddArg("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubdefistatediff=<address>", "Enable publish the DeFi state changes of each connected and disconnected block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubdefistatediffhwm=<n>", strprintf("Set publish DeFi state diff outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
+    hidden_args.emplace_back("-zmqpubdefistatediff=<address>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
+    hidden_args.emplace_back("-zmqpubdefistatediffhwm=<n>");
 #endif
 
     gArgs.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -637,11 +663,15 @@ void SetupServerArgs()
     gArgs.AddArg("-server", "Accept command line and JSON-RPC commands", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcallowcors=<host>", "Allow CORS requests from the given host origin. Include scheme and port (eg: -rpcallowcors=http://127.0.0.1:5000)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcstats", strprintf("Log RPC stats. (default: %u)", DEFAULT_RPC_STATS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    gArgs.AddArg("-dftxstats", strprintf("Profile the execution of custom transactions by type and of the block event stages, see getdftxstats (default: %u)", DEFAULT_DFTX_STATS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-consolidaterewards=<token-or-pool-symbol>", "Consolidate rewards on startup. Accepted multiple times for each token symbol", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-rpccache=<0/1/2>", "Cache rpc results - uses additional memory to hold on to the last results per block, but faster (0=none, 1=all, 2=smart)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-negativeinterest", "(experimental) Track negative interest values", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     gArgs.AddArg("-rpc-governance-accept-neutral", "Allow voting with neutral votes for JellyFish purpose", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     gArgs.AddArg("-dftxworkers=<n>", strprintf("No. of parallel workers associated with the DfTx related work pool. Stock splits, parallel processing of the chain where appropriate, etc use this worker pool (default: %d)", DEFAULT_DFTX_WORKERS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dftxspeculation", strprintf("Apply custom transactions of a block speculatively in parallel on the DfTx worker pool, re-executing the ones that depend on preceding transactions (default: %u)", DEFAULT_DFTX_SPECULATION), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-tokensplitworkers=<n>", strprintf("No. of DfTx pool threads the account and vault updates of a token split are sharded over, 1 applies them serially (default: %d, 0 = all)", DEFAULT_TOKEN_SPLIT_WORKERS), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-vaultriskindex", strprintf("Experimental: keep the vaults found above their collateralization ratio in memory and only evaluate the ones which may have fallen below it since (default: %u)", DEFAULT_VAULT_RISK_INDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxaddrratepersecond=<n>", strprintf("Sets MAX_ADDR_RATE_PER_SECOND limit for ADDR messages(default: %f)", MAX_ADDR_RATE_PER_SECOND), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxaddrprocessingtokenbucket=<n>", strprintf("Sets MAX_ADDR_PROCESSING_TOKEN_BUCKET limit for ADDR messages(default: %d)", MAX_ADDR_PROCESSING_TOKEN_BUCKET), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-grpcbind=<addr>[:port]", "Bind to given address to listen for JSON-gRPC connections. Do not expose the gRPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -grpcport. This option can be specified multiple times (default: 127.0.0.1 i.e., localhost)", ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
@@ -889,7 +919,6 @@ static bool AppInitServers()
         default: return RPCResultCache::RPCCacheMode::None;
     }}();
     GetRPCResultCache().Init(rpcCacheMode);
-    GetMemoizedResultCache().Init(rpcCacheMode);
 
     RPCServer::OnStarted(&OnRPCStarted);
     RPCServer::OnStopped(&OnRPCStopped);
@@ -1234,6 +1263,16 @@ bool AppInitParameterInteraction()
         incrementalRelayFee = CFeeRate(n);
     }
 
+    dftxStats.setActive(gArgs.GetBoolArg("-dftxstats", DEFAULT_DFTX_STATS));
+
+    // leveldb profiles of the databases, applied as they are opened
+    for (const auto& arg : gArgs.GetArgs("-dbprofile")) {
+        std::string error;
+        if (!ParseDBProfile(arg, error)) {
+            return InitError(error);
+        }
+    }
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1551,6 +1590,9 @@ void SetupCacheSizes(CacheSizes& cacheSizes) {
     nCoinCacheUsage = totalCache; // the rest goes to in-memory cache
     nCustomMemUsage = std::max((totalCache >> 8), (nMinDbCache << 16)); // use significant less in-memory cache
 
+    // the DeFi databases are all opened with the custom cache size, their profiles share it out
+    SetDBCachePool(gArgs.GetBoolArg("-dbcacheadaptive", DEFAULT_DB_CACHE_ADAPTIVE) ? cacheSizes.customCacheSize : 0);
+
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
 
     // Log cache configurations
@@ -1564,6 +1606,11 @@ void SetupCacheSizes(CacheSizes& cacheSizes) {
                   cacheSizes.filterIndexCache * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
     }
     LogPrintf("* Using %.1f MiB for chain state database\n", cacheSizes.coinDBCache * (1.0 / 1024 / 1024));
+    for (const auto name : {"enhancedcs", "history", "burn", "vault"}) {
+        const auto profile = GetDBProfile(name);
+        LogPrintf("* Using %.1f MiB for %s database%s\n", cacheSizes.customCacheSize * profile.cacheShare * (1.0 / 1024 / 1024), name,
+                  profile.adaptiveCache && gArgs.GetBoolArg("-dbcacheadaptive", DEFAULT_DB_CACHE_ADAPTIVE) ? " (block cache pooled)" : "");
+    }
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 }
 
@@ -1659,6 +1706,74 @@ void SetupInterrupts() {
     fStopOrInterrupt = isSet;
 }
 
+// Replaces the DeFi state, coins and history databases by the snapshot given with -loaddefistate.
+// They are written and closed again before the node opens them, blocks after the snapshot's
+// block are connected as usual.
+static bool ImportDeFiStateSnapshot(const CChainParams& chainparams, size_t cacheSize, std::string& strError) {
+    AssertLockHeld(cs_main);
+
+    const fs::path path = fs::absolute(gArgs.GetArg("-loaddefistate", ""), GetDataDir());
+    CAutoFile file(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        strError = strprintf("Cannot open DeFi state snapshot %s", path.string());
+        return false;
+    }
+
+    std::vector<const char*> names;
+    try {
+        CDeFiStateSnapshotHeader header;
+        file >> header;
+        if (auto res = header.Check(chainparams); !res) {
+            strError = strprintf("DeFi state snapshot %s rejected: %s", path.string(), res.msg);
+            return false;
+        }
+        const auto pindex = LookupBlockIndex(header.blockHash);
+        if (!pindex || pindex->nHeight != header.height || !(pindex->nStatus & BLOCK_HAVE_DATA) || !pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+            strError = strprintf("Block %s of the DeFi state snapshot is not in the block index, the blocks up to it have to be on disk", header.blockHash.ToString());
+            return false;
+        }
+        LogPrintf("Loading DeFi state snapshot of block %s at height %d\n", header.blockHash.ToString(), header.height);
+
+        std::vector<std::unique_ptr<CStorageLevelDB>> dbs;
+        std::array<CStorageKV*, SNAPSHOT_SECTIONS> targets{};
+        auto open = [&](SnapshotSection section, const char* name) {
+            names.push_back(name);
+            dbs.push_back(std::make_unique<CStorageLevelDB>(GetDataDir() / name, cacheSize, false, true));
+            targets[static_cast<uint8_t>(section)] = dbs.back().get();
+        };
+        open(SnapshotSection::CustomCS, "enhancedcs");
+        open(SnapshotSection::Coins, "chainstate");
+        if (gArgs.GetBoolArg("-acindex", DEFAULT_ACINDEX)) {
+            open(SnapshotSection::AccountHistory, "history");
+        }
+        open(SnapshotSection::BurnHistory, "burn");
+        if (gArgs.GetBoolArg("-vaultindex", DEFAULT_VAULTINDEX)) {
+            open(SnapshotSection::VaultHistory, "vault");
+        }
+
+        const auto time = GetTimeMillis();
+        auto trailer = LoadDeFiStateSnapshot(file, targets);
+        if (trailer && trailer->stateRoot != uint256S(gArgs.GetArg("-loaddefistateroot", ""))) {
+            trailer = Res::Err("state root %s is not the trusted one", trailer->stateRoot.ToString());
+        }
+        if (!trailer) {
+            strError = trailer.msg;
+        } else {
+            LogPrintf("Loaded DeFi state snapshot, %d records with state root %s (time: %dms)\n", trailer->records, trailer->stateRoot.ToString(), GetTimeMillis() - time);
+            return true;
+        }
+    } catch (const std::exception& e) {
+        strError = e.what();
+    }
+
+    // nothing half loaded is left behind, the databases written to are wiped again
+    for (const auto name : names) {
+        CStorageLevelDB(GetDataDir() / name, cacheSize, false, true);
+    }
+    strError = strprintf("DeFi state snapshot %s rejected: %s. The databases it replaced have to be rebuilt using -reindex-chainstate", path.string(), strError);
+    return false;
+}
+
 static bool LoanAmountsInClosedVaults(CCustomCSView &mnview) {
     LOCK(cs_main);
 
@@ -1789,10 +1904,25 @@ bool AppInitMain(InitInterfaces& interfaces)
     CacheSizes nCacheSizes;
     SetupCacheSizes(nCacheSizes);
     InitDfTxGlobalTaskPool();
+    fDfTxSpeculation = gArgs.GetBoolArg("-dftxspeculation", DEFAULT_DFTX_SPECULATION);
+    fVaultRiskIndex = gArgs.GetBoolArg("-vaultriskindex", DEFAULT_VAULT_RISK_INDEX);
+    nTokenSplitWorkers = std::max<int>(0, gArgs.GetArg("-tokensplitworkers", DEFAULT_TOKEN_SPLIT_WORKERS));
 
     bool fLoaded = false;
     fReindex = gArgs.GetBoolArg("-reindex", false);
     bool fReindexChainState = gArgs.GetBoolArg("-reindex-chainstate", false);
+    const bool fLoadDeFiState = gArgs.IsArgSet("-loaddefistate");
+    if (fLoadDeFiState && (fReindex || fReindexChainState)) {
+        return InitError(_("-loaddefistate is incompatible with -reindex and -reindex-chainstate").translated);
+    }
+    // the snapshot's own trailer only proves it is intact, the root it has to match comes from the user
+    if (fLoadDeFiState) {
+        const auto stateRoot = gArgs.GetArg("-loaddefistateroot", "");
+        if (stateRoot.size() != 64 || !IsHex(stateRoot)) {
+            return InitError(_("-loaddefistate requires -loaddefistateroot set to the state root reported by dumpdefistate on a trusted node").translated);
+        }
+    }
+    bool fDeFiStateLoaded = false;
     while (!fLoaded && !ShutdownRequested()) {
         bool fReset = fReindex;
         std::string strLoadError;
@@ -1858,6 +1988,13 @@ bool AppInitMain(InitInterfaces& interfaces)
                 // At this point we're either in reindex or we've loaded a useful
                 // block tree into BlockIndex()!
 
+                if (fLoadDeFiState && !fDeFiStateLoaded) {
+                    if (!ImportDeFiStateSnapshot(chainparams, nCacheSizes.customCacheSize, strLoadError)) {
+                        break;
+                    }
+                    fDeFiStateLoaded = true;
+                }
+
                 ::ChainstateActive().InitCoinsDB(
                     /* cache_size_bytes */ nCacheSizes.coinDBCache,
                     /* in_memory */ false,
@@ -1894,11 +2031,14 @@ bool AppInitMain(InitInterfaces& interfaces)
                 if (gArgs.GetBoolArg("-acindex", DEFAULT_ACINDEX)) {
                     paccountHistoryDB = std::make_unique<CAccountHistoryStorage>(GetDataDir() / "history", nCacheSizes.customCacheSize, false, fReset || fReindexChainState);
                     paccountHistoryDB->CreateMultiIndexIfNeeded();
+                    paccountHistoryDB->CreateSegmentIndexIfNeeded();
                 }
 
                 pburnHistoryDB.reset();
                 pburnHistoryDB = std::make_unique<CBurnHistoryStorage>(GetDataDir() / "burn", nCacheSizes.customCacheSize, false, fReset || fReindexChainState);
                 pburnHistoryDB->CreateMultiIndexIfNeeded();
+                pburnHistoryDB->CreateSegmentIndexIfNeeded();
+                pburnHistoryDB->CreateTotalsIfNeeded();
 
                 // Create vault history DB
                 pvaultHistoryDB.reset();
@@ -1913,8 +2053,8 @@ bool AppInitMain(InitInterfaces& interfaces)
                     break;
                 }
 
-                // Wipe EVM folder on reindex
-                if (fReset || fReindexChainState) {
+                // Wipe EVM folder on reindex, a loaded snapshot predates the EVM
+                if (fReset || fReindexChainState || fDeFiStateLoaded) {
                     auto res = CrossBoundaryChecked(ain_rs_wipe_evm_folder(result));
                     if (!res) {
                         return false;
@@ -2304,6 +2444,8 @@ bool AppInitMain(InitInterfaces& interfaces)
         g_banman->DumpBanlist();
     }, DUMP_BANS_INTERVAL * 1000);
 
+    ScheduleMinterKeyMigration();
+
     // ********************************************************* Step XX.a: create mocknet MN
     // MN: 0000000000000000000000000000000000000000000000000000000000000000
     // Owner/Operator Address: df1qu04hcpd3untnm453mlkgc0g9mr9ap39lyx4ajc
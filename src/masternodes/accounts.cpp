@@ -76,6 +76,34 @@ Res CAccountsView::SubBalances(const CScript &owner, const CBalances &balances)
     return Res::Ok();
 }
 
+std::vector<bool> CAccountsView::AddBalancesInBatch(const std::vector<std::pair<CScript, CTokenAmount>> &amounts) {
+    std::vector<bool> added(amounts.size(), true);
+    std::map<std::pair<CScript, DCT_ID>, std::pair<CTokenAmount, bool>> balances;
+    for (size_t i = 0; i < amounts.size(); ++i) {
+        const auto &[owner, amount] = amounts[i];
+        if (amount.nValue == 0) {
+            continue;
+        }
+        const auto key = std::make_pair(owner, amount.nTokenId);
+        auto it = balances.find(key);
+        if (it == balances.end()) {
+            it = balances.emplace(key, std::make_pair(GetBalance(owner, amount.nTokenId), false)).first;
+        }
+        auto &[balance, changed] = it->second;
+        if (!balance.Add(amount.nValue)) {
+            added[i] = false;
+            continue;
+        }
+        changed = true;
+    }
+    for (const auto &[key, balance] : balances) {
+        if (balance.second) {
+            SetBalance(key.first, balance.first);
+        }
+    }
+    return added;
+}
+
 void CAccountsView::ForEachAccount(std::function<bool(const CScript &)> callback, const CScript &start) {
     ForEach<ByHeightKey, CScript, uint32_t>(
         [&callback](const CScript &owner, CLazySerialize<uint32_t>) { return callback(owner); }, start);
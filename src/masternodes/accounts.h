@@ -64,6 +64,9 @@ public:
     virtual Res SubBalance(const CScript &owner, CTokenAmount amount);
 
     Res AddBalances(const CScript &owner, const CBalances &balances);
+    // Adds the amounts in turn as AddBalance would, reading and writing each balance once.
+    // Returns whether each amount was added.
+    std::vector<bool> AddBalancesInBatch(const std::vector<std::pair<CScript, CTokenAmount>> &amounts);
     Res SubBalances(const CScript &owner, const CBalances &balances);
 
     uint32_t GetBalancesHeight(const CScript &owner);
@@ -6,8 +6,13 @@
 #include <masternodes/accounts.h>
 #include <masternodes/accountshistory.h>
 #include <masternodes/historywriter.h>
+#include <masternodes/mn_checks.h>
+#include <masternodes/threadpool.h>
 #include <masternodes/vaulthistory.h>
 
+#include <deque>
+#include <queue>
+
 static AccountHistoryKeyNew Convert(const AccountHistoryKey &key) {
     return {key.blockHeight, key.owner, key.txn};
 }
@@ -37,24 +42,214 @@ void CAccountsHistoryView::CreateMultiIndexIfNeeded() {
     LogPrint(BCLog::BENCH, "    - Multi index took: %dms\n", GetTimeMillis() - startTime);
 }
 
+void CAccountsHistoryView::CreateSegmentIndexIfNeeded() {
+    if (ExistsBy<BySegmentIndexBuilt>('\0')) {
+        return;
+    }
+
+    LogPrintf("Adding history segment index in progress...\n");
+
+    auto startTime = GetTimeMillis();
+
+    AccountHistoryKey startKey{{}, ~0u, ~0u};
+    auto it = LowerBound<ByAccountHistoryKey>(startKey);
+    for (; it.Valid(); it.Next()) {
+        WriteSegmentSummary(it.Key(), it.Value());
+    }
+    WriteBy<BySegmentIndexBuilt>('\0', '\0');
+
+    Flush();
+
+    LogPrint(BCLog::BENCH, "    - Segment index took: %dms\n", GetTimeMillis() - startTime);
+}
+
+void CAccountsHistoryView::WriteSegmentSummary(const AccountHistoryKey &key, const AccountHistoryValue &value) {
+    const auto segment = key.blockHeight / ACCOUNT_HISTORY_SEGMENT_SIZE;
+    WriteBy<ByOwnerSegment>(std::make_pair(segment, key.owner), '\0');
+    WriteBy<ByCategorySegment>(std::make_pair(segment, value.category), '\0');
+    for (const auto &[id, amount] : value.diff) {
+        WriteBy<ByTokenSegment>(std::make_pair(segment, id), '\0');
+    }
+}
+
+bool CAccountsHistoryView::SegmentMatches(uint32_t segment, const AccountHistorySegmentFilter &filter) const {
+    if (!filter.owners.empty() && std::none_of(filter.owners.begin(), filter.owners.end(), [&](const CScript &owner) {
+            return ExistsBy<ByOwnerSegment>(std::make_pair(segment, owner));
+        })) {
+        return false;
+    }
+    if (!filter.categories.empty() && std::none_of(filter.categories.begin(), filter.categories.end(), [&](uint8_t category) {
+            return ExistsBy<ByCategorySegment>(std::make_pair(segment, category));
+        })) {
+        return false;
+    }
+    return !filter.token || ExistsBy<ByTokenSegment>(std::make_pair(segment, *filter.token));
+}
+
 void CAccountsHistoryView::ForEachAccountHistory(
     std::function<bool(const AccountHistoryKey &, AccountHistoryValue)> callback,
     const CScript &owner,
     uint32_t height,
-    uint32_t txn) {
+    uint32_t txn,
+    const AccountHistorySegmentFilter &filter) {
+    // Rows are walked from the highest height down, a segment is checked once on entering it
+    std::optional<uint32_t> enteredSegment;
+    auto skipSegment = [&](uint32_t blockHeight) {
+        const auto segment = blockHeight / ACCOUNT_HISTORY_SEGMENT_SIZE;
+        if (filter.Empty() || enteredSegment == segment) {
+            return false;
+        }
+        if (!SegmentMatches(segment, filter)) {
+            return true;
+        }
+        enteredSegment = segment;
+        return false;
+    };
+    const auto maxTxn = std::numeric_limits<uint32_t>::max();
+
     if (!owner.empty()) {
-        ForEach<ByAccountHistoryKey, AccountHistoryKey, AccountHistoryValue>(callback, {owner, height, txn});
+        auto it = LowerBound<ByAccountHistoryKey>(AccountHistoryKey{owner, height, txn});
+        while (it.Valid()) {
+            const auto key = it.Key();
+            if (key.owner == owner && skipSegment(key.blockHeight)) {
+                const auto segmentStart = key.blockHeight - key.blockHeight % ACCOUNT_HISTORY_SEGMENT_SIZE;
+                if (segmentStart == 0) {
+                    break;
+                }
+                it.Seek({owner, segmentStart - 1, maxTxn});
+                continue;
+            }
+            if (!callback(key, it.Value().as<AccountHistoryValue>())) {
+                break;
+            }
+            it.Next();
+        }
         return;
     }
 
-    ForEach<ByAccountHistoryKeyNew, AccountHistoryKeyNew, char>(
-        [&](const AccountHistoryKeyNew &newKey, char) {
-            auto key   = Convert(newKey);
-            auto value = ReadAccountHistory(key);
-            assert(value);
-            return callback(key, *value);
+    auto it = LowerBound<ByAccountHistoryKeyNew>(AccountHistoryKeyNew{height, owner, txn});
+    while (it.Valid()) {
+        const auto newKey = it.Key();
+        if (skipSegment(newKey.blockHeight)) {
+            const auto segmentStart = newKey.blockHeight - newKey.blockHeight % ACCOUNT_HISTORY_SEGMENT_SIZE;
+            if (segmentStart == 0) {
+                break;
+            }
+            it.Seek({segmentStart - 1, {}, maxTxn});
+            continue;
+        }
+        auto key   = Convert(newKey);
+        auto value = ReadAccountHistory(key);
+        assert(value);
+        if (!callback(key, *value)) {
+            break;
+        }
+        it.Next();
+    }
+}
+
+// Rows read ahead per owner, doubled on every read up to the max
+static const size_t OWNER_HISTORY_FIRST_BATCH = 8;
+static const size_t OWNER_HISTORY_MAX_BATCH   = 1024;
+
+namespace {
+struct OwnerHistoryCursor {
+    CScript owner;
+    // serialized owner, rows at the same height are walked in its order
+    TBytes ownerKey;
+    std::deque<std::pair<AccountHistoryKey, AccountHistoryValue>> rows;
+    // position to read on from
+    uint32_t height;
+    uint32_t txn;
+    size_t batchSize{OWNER_HISTORY_FIRST_BATCH};
+    bool exhausted{false};
+};
+}  // namespace
+
+static void ReadAhead(CAccountsHistoryView &view, OwnerHistoryCursor &cursor, const AccountHistorySegmentFilter &filter) {
+    size_t read{};
+    view.ForEachAccountHistory(
+        [&](const AccountHistoryKey &key, AccountHistoryValue value) {
+            if (key.owner != cursor.owner) {
+                return false;
+            }
+            cursor.rows.emplace_back(key, std::move(value));
+            return ++read < cursor.batchSize;
         },
-        {height, owner, txn});
+        cursor.owner, cursor.height, cursor.txn, filter);
+
+    if (read < cursor.batchSize) {
+        cursor.exhausted = true;
+        return;
+    }
+    const auto &last = cursor.rows.back().first;
+    if (last.blockHeight == 0 && last.txn == 0) {
+        cursor.exhausted = true;
+        return;
+    }
+    if (last.txn == 0) {
+        cursor.height = last.blockHeight - 1;
+        cursor.txn    = std::numeric_limits<uint32_t>::max();
+    } else {
+        cursor.height = last.blockHeight;
+        cursor.txn    = last.txn - 1;
+    }
+    cursor.batchSize = std::min(cursor.batchSize * 2, OWNER_HISTORY_MAX_BATCH);
+}
+
+void CAccountsHistoryView::ForEachAccountHistoryOfOwners(
+    std::function<bool(const AccountHistoryKey &, AccountHistoryValue)> callback,
+    const std::set<CScript> &owners,
+    uint32_t height,
+    uint32_t txn,
+    const AccountHistorySegmentFilter &filter) {
+    std::vector<OwnerHistoryCursor> cursors;
+    cursors.reserve(owners.size());
+    for (const auto &owner : owners) {
+        // an empty owner stands for all of them
+        if (!owner.empty()) {
+            cursors.push_back({owner, DbTypeToBytes(owner), {}, height, txn});
+        }
+    }
+
+    DfTxTaskPool->ParallelFor(0, cursors.size(), {"Account history read ahead", 16}, [&](size_t i, size_t) {
+        ReadAhead(*this, cursors[i], filter);
+    });
+
+    // k-way merge of the cursors' next rows, the greatest in walk order on top
+    auto walkedAfter = [&](size_t lhs, size_t rhs) {
+        const auto &left  = cursors[lhs].rows.front().first;
+        const auto &right = cursors[rhs].rows.front().first;
+        if (left.blockHeight != right.blockHeight) {
+            return left.blockHeight < right.blockHeight;
+        }
+        if (cursors[lhs].ownerKey != cursors[rhs].ownerKey) {
+            return cursors[lhs].ownerKey > cursors[rhs].ownerKey;
+        }
+        return left.txn < right.txn;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(walkedAfter)> queue{walkedAfter};
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (!cursors[i].rows.empty()) {
+            queue.push(i);
+        }
+    }
+
+    while (!queue.empty()) {
+        auto &cursor = cursors[queue.top()];
+        queue.pop();
+        auto [key, value] = std::move(cursor.rows.front());
+        cursor.rows.pop_front();
+        if (cursor.rows.empty() && !cursor.exhausted) {
+            ReadAhead(*this, cursor, filter);
+        }
+        if (!cursor.rows.empty()) {
+            queue.push(&cursor - cursors.data());
+        }
+        if (!callback(key, std::move(value))) {
+            return;
+        }
+    }
 }
 
 std::optional<AccountHistoryValue> CAccountsHistoryView::ReadAccountHistory(const AccountHistoryKey &key) const {
@@ -64,6 +259,7 @@ std::optional<AccountHistoryValue> CAccountsHistoryView::ReadAccountHistory(cons
 void CAccountsHistoryView::WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value) {
     WriteBy<ByAccountHistoryKey>(key, value);
     WriteBy<ByAccountHistoryKeyNew>(Convert(key), '\0');
+    WriteSegmentSummary(key, value);
 }
 
 Res CAccountsHistoryView::EraseAccountHistory(const AccountHistoryKey &key) {
@@ -92,6 +288,206 @@ CAccountHistoryStorage::CAccountHistoryStorage(const fs::path &dbName, std::size
 CBurnHistoryStorage::CBurnHistoryStorage(const fs::path &dbName, std::size_t cacheSize, bool fMemory, bool fWipe)
     : CStorageView(new CStorageLevelDB(dbName, cacheSize, fMemory, fWipe)) {}
 
+// Negative amounts never made it into the token totals, they are left out both ways
+static void AddPositiveAmounts(CBalances &balances, const TAmounts &amounts, int sign) {
+    for (const auto &[id, amount] : amounts) {
+        if (amount <= 0) {
+            continue;
+        }
+        auto &total = balances.balances[id];
+        total += sign * amount;
+        if (total == 0) {
+            balances.balances.erase(id);
+        }
+    }
+}
+
+static void AddAmounts(CBalances &balances, const TAmounts &amounts, int sign) {
+    for (const auto &[id, amount] : amounts) {
+        auto &total = balances.balances[id];
+        total += sign * amount;
+        if (total == 0) {
+            balances.balances.erase(id);
+        }
+    }
+}
+
+static CAmount SumAmounts(const TAmounts &amounts) {
+    CAmount sum{};
+    for (const auto &[id, amount] : amounts) {
+        sum += amount;
+    }
+    return sum;
+}
+
+void CBurnHistoryTotals::Add(const AccountHistoryValue &value, int sign) {
+    switch (static_cast<CustomTxType>(value.category)) {
+        // UTXO burn
+        case CustomTxType::None:
+            burntDFI += sign * SumAmounts(value.diff);
+            break;
+        // Fee burn
+        case CustomTxType::CreateMasternode:
+        case CustomTxType::CreateToken:
+        case CustomTxType::Vault:
+        case CustomTxType::CreateCfp:
+        case CustomTxType::CreateVoc:
+            burntFee += sign * SumAmounts(value.diff);
+            break;
+        // withdraw burn
+        case CustomTxType::PaybackLoan:
+        case CustomTxType::PaybackLoanV2:
+        case CustomTxType::PaybackWithCollateral:
+            AddPositiveAmounts(paybackFee, value.diff, sign);
+            break;
+        // auction burn
+        case CustomTxType::AuctionBid:
+            auctionFee += sign * SumAmounts(value.diff);
+            break;
+        // dex fee burn
+        case CustomTxType::PoolSwap:
+        case CustomTxType::PoolSwapV2:
+            AddPositiveAmounts(dexfeeburn, value.diff, sign);
+            break;
+        // token burn with burnToken tx
+        case CustomTxType::BurnToken:
+            AddPositiveAmounts(nonConsortiumTokens, value.diff, sign);
+            break;
+        // Token burn
+        default:
+            AddPositiveAmounts(burntTokens, value.diff, sign);
+            break;
+    }
+}
+
+void CBurnHistoryTotals::Add(const CBurnHistoryTotals &other, int sign) {
+    burntDFI += sign * other.burntDFI;
+    burntFee += sign * other.burntFee;
+    auctionFee += sign * other.auctionFee;
+    AddAmounts(burntTokens, other.burntTokens.balances, sign);
+    AddAmounts(nonConsortiumTokens, other.nonConsortiumTokens.balances, sign);
+    AddAmounts(dexfeeburn, other.dexfeeburn.balances, sign);
+    AddAmounts(paybackFee, other.paybackFee.balances, sign);
+}
+
+void CBurnHistoryStorage::CreateTotalsIfNeeded() {
+    if (ExistsBy<ByTotals>('\0')) {
+        return;
+    }
+
+    LogPrintf("Adding burn totals in progress...\n");
+
+    auto startTime = GetTimeMillis();
+
+    CBurnHistoryTotals totals;
+    std::map<uint32_t, CBurnHistoryTotals> segments;
+    AccountHistoryKey startKey{{}, ~0u, ~0u};
+    auto it = LowerBound<ByAccountHistoryKey>(startKey);
+    for (; it.Valid(); it.Next()) {
+        const auto value = it.Value().as<AccountHistoryValue>();
+        totals.Add(value);
+        segments[it.Key().blockHeight / ACCOUNT_HISTORY_SEGMENT_SIZE].Add(value);
+    }
+    for (const auto &[segment, segmentTotals] : segments) {
+        WriteBy<BySegmentTotals>(BurnTotalsSegmentKey{segment}, segmentTotals);
+    }
+    WriteBy<ByTotals>('\0', totals);
+
+    Flush();
+
+    LogPrint(BCLog::BENCH, "    - Burn totals took: %dms\n", GetTimeMillis() - startTime);
+}
+
+std::optional<AccountHistoryValue> CBurnHistoryStorage::GetPendingRow(const AccountHistoryKey &key) const {
+    if (const auto it = pendingRows.find(key); it != pendingRows.end()) {
+        return it->second;
+    }
+    return parent ? parent->GetPendingRow(key) : ReadAccountHistory(key);
+}
+
+void CBurnHistoryStorage::AddToTotals(const AccountHistoryKey &key, const AccountHistoryValue &value, int sign) {
+    pendingTotals.Add(value, sign);
+    pendingSegments[key.blockHeight / ACCOUNT_HISTORY_SEGMENT_SIZE].Add(value, sign);
+}
+
+void CBurnHistoryStorage::WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value) {
+    if (const auto previous = GetPendingRow(key)) {
+        AddToTotals(key, *previous, -1);
+    }
+    CAccountsHistoryView::WriteAccountHistory(key, value);
+    AddToTotals(key, value, 1);
+    pendingRows[key] = value;
+}
+
+Res CBurnHistoryStorage::EraseAccountHistory(const AccountHistoryKey &key) {
+    if (const auto previous = GetPendingRow(key)) {
+        AddToTotals(key, *previous, -1);
+    }
+    pendingRows[key] = std::nullopt;
+    return CAccountsHistoryView::EraseAccountHistory(key);
+}
+
+bool CBurnHistoryStorage::Flush() {
+    if (parent) {
+        for (auto &[key, row] : pendingRows) {
+            parent->pendingRows[key] = std::move(row);
+        }
+        parent->pendingTotals.Add(pendingTotals);
+        for (const auto &[segment, totals] : pendingSegments) {
+            parent->pendingSegments[segment].Add(totals);
+        }
+    } else if (!pendingRows.empty()) {
+        auto totals = ReadBy<ByTotals, CBurnHistoryTotals>('\0').value_or(CBurnHistoryTotals{});
+        totals.Add(pendingTotals);
+        WriteBy<ByTotals>('\0', totals);
+        for (const auto &[segment, segmentChange] : pendingSegments) {
+            const BurnTotalsSegmentKey segmentKey{segment};
+            auto segmentTotals = ReadBy<BySegmentTotals, CBurnHistoryTotals>(segmentKey).value_or(CBurnHistoryTotals{});
+            segmentTotals.Add(segmentChange);
+            WriteBy<BySegmentTotals>(segmentKey, segmentTotals);
+        }
+    }
+    pendingRows.clear();
+    pendingTotals = {};
+    pendingSegments.clear();
+    return CAccountsHistoryView::Flush();
+}
+
+void CBurnHistoryStorage::Discard() {
+    pendingRows.clear();
+    pendingTotals = {};
+    pendingSegments.clear();
+    CAccountsHistoryView::Discard();
+}
+
+CBurnHistoryTotals CBurnHistoryStorage::GetTotals(uint32_t height) {
+    auto totals = ReadBy<ByTotals, CBurnHistoryTotals>('\0').value_or(CBurnHistoryTotals{});
+
+    const auto segment = height / ACCOUNT_HISTORY_SEGMENT_SIZE;
+    ForEach<BySegmentTotals, BurnTotalsSegmentKey, CBurnHistoryTotals>(
+        [&](const BurnTotalsSegmentKey &, const CBurnHistoryTotals &segmentTotals) {
+            totals.Add(segmentTotals, -1);
+            return true;
+        },
+        BurnTotalsSegmentKey{segment + 1});
+
+    // rows of the height's own segment above it
+    const auto segmentEnd = static_cast<uint32_t>(
+        std::min<uint64_t>((uint64_t{segment} + 1) * ACCOUNT_HISTORY_SEGMENT_SIZE - 1, std::numeric_limits<uint32_t>::max()));
+    if (segmentEnd > height) {
+        ForEachAccountHistory(
+            [&](const AccountHistoryKey &key, const AccountHistoryValue &value) {
+                if (key.blockHeight <= height) {
+                    return false;
+                }
+                totals.Add(value, -1);
+                return true;
+            },
+            {}, segmentEnd);
+    }
+    return totals;
+}
+
 CAccountsHistoryWriter::CAccountsHistoryWriter(CCustomCSView &storage,
                                                uint32_t height,
                                                uint32_t txn,
@@ -103,6 +499,7 @@ CAccountsHistoryWriter::CAccountsHistoryWriter(CCustomCSView &storage,
       txid(txid),
       type(type),
       writers(storage.GetHistoryWriters()) {
+    parentView = &storage;
 }
 
 CAccountsHistoryWriter::~CAccountsHistoryWriter() {
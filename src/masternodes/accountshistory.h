@@ -18,17 +18,43 @@ class CVaultHistoryStorage;
 struct VaultHistoryKey;
 struct VaultHistoryValue;
 
+// Heights per segment of the history rows summary
+static const uint32_t ACCOUNT_HISTORY_SEGMENT_SIZE = 1000;
+
+// Rows a history query is after. Segments without a single row matching every
+// non empty field are skipped, the rows read are still up to the caller to filter.
+struct AccountHistorySegmentFilter {
+    // any of the owners
+    std::set<CScript> owners;
+    // any of the categories
+    std::set<uint8_t> categories;
+    std::optional<DCT_ID> token;
+
+    [[nodiscard]] bool Empty() const { return owners.empty() && categories.empty() && !token; }
+};
+
 class CAccountsHistoryView : public virtual CStorageView {
 public:
     void CreateMultiIndexIfNeeded();
+    void CreateSegmentIndexIfNeeded();
     Res EraseAccountHistoryHeight(uint32_t height);
     [[nodiscard]] std::optional<AccountHistoryValue> ReadAccountHistory(const AccountHistoryKey &key) const;
-    void WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value);
-    Res EraseAccountHistory(const AccountHistoryKey &key);
+    virtual void WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value);
+    virtual Res EraseAccountHistory(const AccountHistoryKey &key);
     void ForEachAccountHistory(std::function<bool(const AccountHistoryKey &, AccountHistoryValue)> callback,
                                const CScript &owner = {},
                                uint32_t height      = std::numeric_limits<uint32_t>::max(),
-                               uint32_t txn         = std::numeric_limits<uint32_t>::max());
+                               uint32_t txn         = std::numeric_limits<uint32_t>::max(),
+                               const AccountHistorySegmentFilter &filter = {});
+    // Rows of any of the owners in the order all rows are walked in, by height and then owner
+    // from the highest down. The rows of each owner are read ahead in parallel on the DfTx pool.
+    void ForEachAccountHistoryOfOwners(std::function<bool(const AccountHistoryKey &, AccountHistoryValue)> callback,
+                                       const std::set<CScript> &owners,
+                                       uint32_t height = std::numeric_limits<uint32_t>::max(),
+                                       uint32_t txn    = std::numeric_limits<uint32_t>::max(),
+                                       const AccountHistorySegmentFilter &filter = {});
+    // Returns false if none of the rows ever written to the segment matches the filter
+    [[nodiscard]] bool SegmentMatches(uint32_t segment, const AccountHistorySegmentFilter &filter) const;
 
     // tags
     struct ByAccountHistoryKey {
@@ -37,6 +63,22 @@ public:
     struct ByAccountHistoryKeyNew {
         static constexpr uint8_t prefix() { return 'H'; }
     };
+    // owners, categories and tokens of the rows written to a segment, kept on erase
+    struct ByOwnerSegment {
+        static constexpr uint8_t prefix() { return 'o'; }
+    };
+    struct ByCategorySegment {
+        static constexpr uint8_t prefix() { return 'c'; }
+    };
+    struct ByTokenSegment {
+        static constexpr uint8_t prefix() { return 't'; }
+    };
+    struct BySegmentIndexBuilt {
+        static constexpr uint8_t prefix() { return 's'; }
+    };
+
+private:
+    void WriteSegmentSummary(const AccountHistoryKey &key, const AccountHistoryValue &value);
 };
 
 class CAccountHistoryStorage : public CAccountsHistoryView, public CAuctionHistoryView {
@@ -46,9 +88,81 @@ public:
     CAccountHistoryStorage(const fs::path &dbName, std::size_t cacheSize, bool fMemory = false, bool fWipe = false);
 };
 
+// Burn history rows summed up by what was burnt
+struct CBurnHistoryTotals {
+    CAmount burntDFI{};
+    CAmount burntFee{};
+    CAmount auctionFee{};
+    CBalances burntTokens;
+    CBalances nonConsortiumTokens;
+    CBalances dexfeeburn;
+    CBalances paybackFee;
+
+    // Adds the row, or takes it away again with a negative sign
+    void Add(const AccountHistoryValue &value, int sign = 1);
+    void Add(const CBurnHistoryTotals &other, int sign = 1);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(burntDFI);
+        READWRITE(burntFee);
+        READWRITE(auctionFee);
+        READWRITE(burntTokens);
+        READWRITE(nonConsortiumTokens);
+        READWRITE(dexfeeburn);
+        READWRITE(paybackFee);
+    }
+};
+
+struct BurnTotalsSegmentKey {
+    uint32_t segment;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(WrapBigEndian(segment));
+    }
+};
+
+// Burn history along with the totals of its rows, as a whole and per segment. The totals
+// are written on flush from the rows written and erased since, layers flush theirs into
+// the storage they were created on top of.
 class CBurnHistoryStorage : public CAccountsHistoryView {
 public:
+    CBurnHistoryStorage(CBurnHistoryStorage &burnHistory)
+        : CStorageView(new CFlushableStorageKV(burnHistory.DB())),
+          parent(&burnHistory) {}
     CBurnHistoryStorage(const fs::path &dbName, std::size_t cacheSize, bool fMemory = false, bool fWipe = false);
+
+    void CreateTotalsIfNeeded();
+    void WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value) override;
+    Res EraseAccountHistory(const AccountHistoryKey &key) override;
+    bool Flush() override;
+    void Discard() override;
+    // Totals of the flushed rows up to the height. The segments above it are taken off the
+    // totals of all rows, the rows above the height in its own segment are read.
+    [[nodiscard]] CBurnHistoryTotals GetTotals(uint32_t height = std::numeric_limits<uint32_t>::max());
+
+    // tags
+    struct ByTotals {
+        static constexpr uint8_t prefix() { return 'B'; }
+    };
+    struct BySegmentTotals {
+        static constexpr uint8_t prefix() { return 'b'; }
+    };
+
+private:
+    // Row as of the changes not flushed yet, the storage batch cannot be read from
+    std::optional<AccountHistoryValue> GetPendingRow(const AccountHistoryKey &key) const;
+    void AddToTotals(const AccountHistoryKey &key, const AccountHistoryValue &value, int sign);
+
+    CBurnHistoryStorage *parent{};
+    std::map<AccountHistoryKey, std::optional<AccountHistoryValue>> pendingRows;
+    CBurnHistoryTotals pendingTotals;
+    std::map<uint32_t, CBurnHistoryTotals> pendingSegments;
 };
 
 class CAccountsHistoryWriter : public CCustomCSView {
@@ -0,0 +1,172 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/dftxstats.h>
+
+#include <tinyformat.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+CDfTxStats dftxStats;
+
+void CDfTxHistogram::Add(uint64_t value) {
+    size_t bucket{0};
+    for (auto bits = value; bits; bits >>= 1) {
+        ++bucket;
+    }
+    ++buckets[std::min(bucket, BUCKETS - 1)];
+    ++count;
+    sum += value;
+    max = std::max(max, value);
+}
+
+uint64_t CDfTxHistogram::Quantile(double q) const {
+    if (!count) {
+        return 0;
+    }
+    const auto rank = std::max<uint64_t>(1, std::ceil(q * count));
+    uint64_t seen{0};
+    for (size_t i = 0; i < BUCKETS - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(UpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+uint64_t CDfTxHistogram::UpperBound(size_t bucket) {
+    return bucket ? (uint64_t{1} << bucket) - 1 : 0;
+}
+
+void CDfTxTypeStats::Add(const CDfTxSample &sample, bool failed) {
+    wallMicros.Add(sample.wallMicros);
+    reads.Add(sample.reads);
+    writes.Add(sample.writes);
+    bytes.Add(sample.bytes);
+    mapEntries.Add(sample.mapEntries);
+    failures += failed;
+}
+
+static UniValue HistogramToJSON(const CDfTxHistogram &histogram) {
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("total", histogram.sum);
+    obj.pushKV("avg", histogram.count ? histogram.sum / histogram.count : 0);
+    obj.pushKV("p50", histogram.Quantile(0.5));
+    obj.pushKV("p90", histogram.Quantile(0.9));
+    obj.pushKV("p99", histogram.Quantile(0.99));
+    obj.pushKV("max", histogram.max);
+    return obj;
+}
+
+UniValue CDfTxTypeStats::toJSON() const {
+    UniValue stats(UniValue::VOBJ);
+    stats.pushKV("count", wallMicros.count);
+    stats.pushKV("failures", failures);
+    stats.pushKV("time", HistogramToJSON(wallMicros));
+    stats.pushKV("reads", HistogramToJSON(reads));
+    stats.pushKV("writes", HistogramToJSON(writes));
+    stats.pushKV("bytes", HistogramToJSON(bytes));
+    stats.pushKV("mapEntries", HistogramToJSON(mapEntries));
+    return stats;
+}
+
+bool CDfTxStats::isActive() const { return active.load(); }
+void CDfTxStats::setActive(bool isActive) { active.store(isActive); }
+
+void CDfTxStats::add(const std::string &name, const CDfTxSample &sample, bool failed) {
+    std::unique_lock lock(lock_stats);
+    map[name].Add(sample, failed);
+}
+
+std::map<std::string, CDfTxTypeStats> CDfTxStats::getMap() {
+    std::unique_lock lock(lock_stats);
+    return map;
+}
+
+void CDfTxStats::clear() {
+    std::unique_lock lock(lock_stats);
+    map.clear();
+}
+
+UniValue CDfTxStats::toJSON() {
+    UniValue ret(UniValue::VOBJ);
+    for (const auto &[name, stats] : getMap()) {
+        ret.pushKV(name, stats.toJSON());
+    }
+    return ret;
+}
+
+std::string CDfTxStats::toPrometheus() {
+    const auto stats = getMap();
+    const std::pair<const char *, CDfTxHistogram CDfTxTypeStats::*> metrics[] = {
+        {"defi_dftx_time_microseconds", &CDfTxTypeStats::wallMicros},
+        {"defi_dftx_storage_reads", &CDfTxTypeStats::reads},
+        {"defi_dftx_storage_writes", &CDfTxTypeStats::writes},
+        {"defi_dftx_storage_bytes", &CDfTxTypeStats::bytes},
+        {"defi_dftx_map_entries", &CDfTxTypeStats::mapEntries},
+    };
+
+    std::string out;
+    for (const auto &[metric, member] : metrics) {
+        out += strprintf("# TYPE %s histogram\n", metric);
+        for (const auto &[name, typeStats] : stats) {
+            const auto &histogram = typeStats.*member;
+            // buckets past the last used one add nothing to +Inf
+            size_t used{0};
+            for (size_t i = 0; i < CDfTxHistogram::BUCKETS - 1; ++i) {
+                if (histogram.buckets[i]) {
+                    used = i + 1;
+                }
+            }
+            uint64_t cumulative{0};
+            for (size_t i = 0; i < used; ++i) {
+                cumulative += histogram.buckets[i];
+                out += strprintf("%s_bucket{type=\"%s\",le=\"%d\"} %d\n", metric, name, CDfTxHistogram::UpperBound(i), cumulative);
+            }
+            out += strprintf("%s_bucket{type=\"%s\",le=\"+Inf\"} %d\n", metric, name, histogram.count);
+            out += strprintf("%s_sum{type=\"%s\"} %d\n", metric, name, histogram.sum);
+            out += strprintf("%s_count{type=\"%s\"} %d\n", metric, name, histogram.count);
+        }
+    }
+    out += "# TYPE defi_dftx_failures_total counter\n";
+    for (const auto &[name, typeStats] : stats) {
+        out += strprintf("defi_dftx_failures_total{type=\"%s\"} %d\n", name, typeStats.failures);
+    }
+    return out;
+}
+
+CDfTxStatsScope::CDfTxStatsScope(std::string name, const CKVWriteBuffer &buffer)
+    : active(dftxStats.isActive()),
+      name(std::move(name)),
+      buffer(buffer) {
+    if (active) {
+        startEntries = buffer.Size();
+        startOps = storageOpCounters;
+        start = GetTimeMicros();
+    }
+}
+
+CDfTxStatsScope::~CDfTxStatsScope() {
+    Stop(true);
+}
+
+void CDfTxStatsScope::Stop(bool failed) {
+    if (!active) {
+        return;
+    }
+    active = false;
+
+    CDfTxSample sample;
+    sample.wallMicros = std::max<int64_t>(0, GetTimeMicros() - start);
+    sample.reads = storageOpCounters.reads - startOps.reads;
+    sample.writes = storageOpCounters.writes - startOps.writes;
+    sample.bytes = storageOpCounters.bytes - startOps.bytes;
+    const auto entries = buffer.Size();
+    sample.mapEntries = entries > startEntries ? entries - startEntries : 0;
+    dftxStats.add(name, sample, failed);
+}
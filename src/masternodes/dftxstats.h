@@ -0,0 +1,105 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_DFTXSTATS_H
+#define DEFI_MASTERNODES_DFTXSTATS_H
+
+#include <flushablestorage.h>
+#include <sync.h>
+#include <univalue.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+static const bool DEFAULT_DFTX_STATS = false;
+
+// Power of two buckets, bucket i counts the values of i significant bits.
+// The last one takes everything larger.
+struct CDfTxHistogram {
+    static constexpr size_t BUCKETS = 40;
+
+    uint64_t count{};
+    uint64_t sum{};
+    uint64_t max{};
+    std::array<uint64_t, BUCKETS> buckets{};
+
+    void Add(uint64_t value);
+    // Upper bound of the bucket holding the value at the quantile q of [0, 1]
+    uint64_t Quantile(double q) const;
+
+    static uint64_t UpperBound(size_t bucket);
+};
+
+// Costs of a DfTx execution or of a block event stage
+struct CDfTxSample {
+    uint64_t wallMicros{};
+    uint64_t reads{};
+    uint64_t writes{};
+    uint64_t bytes{};
+    // entries the work left in the write buffer of the view it ran on
+    uint64_t mapEntries{};
+};
+
+struct CDfTxTypeStats {
+    CDfTxHistogram wallMicros;
+    CDfTxHistogram reads;
+    CDfTxHistogram writes;
+    CDfTxHistogram bytes;
+    CDfTxHistogram mapEntries;
+    uint64_t failures{};
+
+    void Add(const CDfTxSample &sample, bool failed);
+    UniValue toJSON() const;
+};
+
+/**
+ * Execution profile of the DfTxs by type and of the ProcessDeFiEvent stages,
+ * the stages are named "event:<stage>".
+ */
+class CDfTxStats {
+private:
+    AtomicMutex lock_stats;
+    std::map<std::string, CDfTxTypeStats> map;
+    std::atomic_bool active{DEFAULT_DFTX_STATS};
+
+public:
+    bool isActive() const;
+    void setActive(bool isActive);
+    void add(const std::string &name, const CDfTxSample &sample, bool failed);
+    std::map<std::string, CDfTxTypeStats> getMap();
+    void clear();
+    UniValue toJSON();
+    // Prometheus text exposition format, a histogram family per metric
+    std::string toPrometheus();
+};
+
+extern CDfTxStats dftxStats;
+
+/**
+ * Samples the storage operations of the current thread and the wall time from
+ * construction to Stop, then adds them under the name. Destroyed before Stop the
+ * sample counts as a failure. Does nothing while the stats are not active.
+ * Work handed to other threads is left out.
+ */
+class CDfTxStatsScope {
+public:
+    CDfTxStatsScope(std::string name, const CKVWriteBuffer &buffer);
+    CDfTxStatsScope(const CDfTxStatsScope &) = delete;
+    ~CDfTxStatsScope();
+
+    void Stop(bool failed = false);
+
+private:
+    bool active;
+    std::string name;
+    const CKVWriteBuffer &buffer;
+    size_t startEntries{};
+    int64_t start{};
+    CStorageOpCounters startOps;
+};
+
+#endif  // DEFI_MASTERNODES_DFTXSTATS_H
@@ -23,6 +23,10 @@ struct AccountHistoryKey {
     uint32_t blockHeight;
     uint32_t txn;  // for order in block
 
+    bool operator<(const AccountHistoryKey &other) const {
+        return std::tie(owner, blockHeight, txn) < std::tie(other.owner, other.blockHeight, other.txn);
+    }
+
     ADD_SERIALIZE_METHODS;
 
     template <typename Stream, typename Operation>
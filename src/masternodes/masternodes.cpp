@@ -28,8 +28,12 @@
 #include <masternodes/errors.h>
 
 std::unique_ptr<CCustomCSView> pcustomcsview;
+CViewCacheStats viewCacheStats;
 std::unique_ptr<CStorageLevelDB> pcustomcsDB;
 
+// Bumped whenever what the activity index stores changes, the index is then rebuilt
+static const int MASTERNODE_ACTIVITY_INDEX_VERSION = 1;
+
 int GetMnActivationDelay(int height) {
     // Restore previous activation delay on testnet after FC
     if (height < Params().GetConsensus().EunosHeight ||
@@ -242,14 +246,108 @@ void CMasternodesView::IncrementMintedBy(const uint256 &nodeId) {
     auto node = GetMasternode(nodeId);
     assert(node);
     ++node->mintedBlocks;
-    WriteBy<ID>(nodeId, *node);
+    if (node->mintedBlocks == 1) {
+        WriteMasternode(nodeId, *node);
+    } else {
+        WriteBy<ID>(nodeId, *node);
+    }
 }
 
 void CMasternodesView::DecrementMintedBy(const uint256 &nodeId) {
     auto node = GetMasternode(nodeId);
     assert(node);
     --node->mintedBlocks;
-    WriteBy<ID>(nodeId, *node);
+    if (node->mintedBlocks == 0) {
+        WriteMasternode(nodeId, *node);
+    } else {
+        WriteBy<ID>(nodeId, *node);
+    }
+}
+
+static uint32_t GetActiveUntil(const CMasternode &node) {
+    return node.resignHeight == -1 ? std::numeric_limits<uint32_t>::max() : static_cast<uint32_t>(node.resignHeight);
+}
+
+CMasternodeActivity CMasternodesView::GetMasternodeActivity(const CMasternode &node) const {
+    CMasternodeActivity activity;
+    // Special case for genesis block
+    if (node.creationHeight != 0) {
+        activity.activeFrom = node.creationHeight + GetMnActivationDelay(node.creationHeight);
+    }
+    if (!node.collateralTx.IsNull()) {
+        auto idHeight = GetNewCollateral(node.collateralTx);
+        assert(idHeight);
+        activity.activeFrom =
+            std::max<uint32_t>(activity.activeFrom, idHeight->blockHeight + GetMnActivationDelay(idHeight->blockHeight));
+    }
+    activity.ownerAuthAddress    = node.ownerAuthAddress;
+    activity.operatorAuthAddress = node.operatorAuthAddress;
+    activity.minted              = node.mintedBlocks > 0;
+    return activity;
+}
+
+// Writes the node record along with its entry in the activity index
+void CMasternodesView::WriteMasternode(const uint256 &nodeId, const CMasternode &node) {
+    if (const auto previous = GetMasternode(nodeId)) {
+        EraseBy<ByActivity>(MNActivityKey{GetActiveUntil(*previous), nodeId});
+    }
+    WriteBy<ID>(nodeId, node);
+    WriteBy<ByActivity>(MNActivityKey{GetActiveUntil(node), nodeId}, GetMasternodeActivity(node));
+}
+
+void CMasternodesView::ForEachActiveMasternode(
+    int height,
+    std::function<bool(const uint256 &, const CMasternodeActivity &)> callback) {
+    if (height < Params().GetConsensus().EunosPayaHeight || !IsMasternodeActivityIndexBuilt()) {
+        ForEachMasternode([&](const uint256 &id, CLazySerialize<CMasternode> node) {
+            if (!node.get().IsActive(height, *this)) {
+                return true;
+            }
+            return callback(id, GetMasternodeActivity(node.get()));
+        });
+        return;
+    }
+
+    // Owners with a pending change are transferring
+    std::set<CKeyID> pendingOwners;
+    ForEachPendingHeight([&](const CKeyID &ownerAuthAddress, const uint32_t &) {
+        pendingOwners.insert(ownerAuthAddress);
+        return true;
+    });
+
+    ForEach<ByActivity, MNActivityKey, CMasternodeActivity>(
+        [&](const MNActivityKey &key, const CMasternodeActivity &activity) {
+            if (activity.activeFrom > static_cast<uint32_t>(height) ||
+                pendingOwners.count(activity.ownerAuthAddress)) {
+                return true;
+            }
+            return callback(key.masternodeID, activity);
+        },
+        MNActivityKey{static_cast<uint32_t>(height) + 1, uint256{}});
+}
+
+bool CMasternodesView::IsMasternodeActivityIndexBuilt() const {
+    return ReadBy<ActivityIndexVersion, int>('\0') == MASTERNODE_ACTIVITY_INDEX_VERSION;
+}
+
+void CMasternodesView::BuildMasternodeActivityIndex() {
+    std::vector<MNActivityKey> stale;
+    ForEach<ByActivity, MNActivityKey, CMasternodeActivity>([&](const MNActivityKey &key, CLazySerialize<CMasternodeActivity>) {
+        stale.push_back(key);
+        return true;
+    });
+    for (const auto &key : stale) {
+        EraseBy<ByActivity>(key);
+    }
+
+    size_t count{};
+    ForEachMasternode([&](const uint256 &id, CLazySerialize<CMasternode> node) {
+        WriteBy<ByActivity>(MNActivityKey{GetActiveUntil(node.get()), id}, GetMasternodeActivity(node.get()));
+        ++count;
+        return true;
+    });
+    WriteBy<ActivityIndexVersion>('\0', MASTERNODE_ACTIVITY_INDEX_VERSION);
+    LogPrintf("Masternode activity index built (%d masternodes)\n", count);
 }
 
 std::optional<std::pair<CKeyID, uint256>> CMasternodesView::AmIOperator() const {
@@ -303,7 +401,7 @@ Res CMasternodesView::CreateMasternode(const uint256 &nodeId, const CMasternode
             "bad owner and|or operator address (should be P2PKH or P2WPKH only) or node with those addresses exists");
     }
 
-    WriteBy<ID>(nodeId, node);
+    WriteMasternode(nodeId, node);
     WriteBy<Owner>(node.ownerAuthAddress, nodeId);
     WriteBy<Operator>(node.operatorAuthAddress, nodeId);
 
@@ -330,7 +428,7 @@ Res CMasternodesView::ResignMasternode(CMasternode &node, const uint256 &nodeId,
 
     node.resignTx     = txid;
     node.resignHeight = height;
-    WriteBy<ID>(nodeId, node);
+    WriteMasternode(nodeId, node);
 
     return Res::Ok();
 }
@@ -388,7 +486,7 @@ void CMasternodesView::UpdateMasternodeOperator(const uint256 &nodeId,
     node.operatorAuthAddress = operatorAuthAddress;
 
     // Overwrite and create new record
-    WriteBy<ID>(nodeId, node);
+    WriteMasternode(nodeId, node);
     WriteBy<Operator>(node.operatorAuthAddress, nodeId);
 
     // Pending change
@@ -406,7 +504,7 @@ void CMasternodesView::UpdateMasternodeOwner(const uint256 &nodeId,
     node.ownerAuthAddress = ownerAuthAddress;
 
     // Overwrite and create new record
-    WriteBy<ID>(nodeId, node);
+    WriteMasternode(nodeId, node);
     WriteBy<Owner>(node.ownerAuthAddress, nodeId);
 }
 
@@ -417,13 +515,13 @@ void CMasternodesView::UpdateMasternodeCollateral(const uint256 &nodeId,
     // Remove old record.
     EraseBy<NewCollateral>(node.collateralTx);
 
-    // Store new collateral. Used by HasCollateralAuth.
-    node.collateralTx = newCollateralTx;
-    WriteBy<ID>(nodeId, node);
-
     // Prioritise fast lookup in CanSpend() and GetState()
     WriteBy<NewCollateral>(newCollateralTx,
                            MNNewOwnerHeightValue{static_cast<uint32_t>(height + GetMnResignDelay(height)), nodeId});
+
+    // Store new collateral. Used by HasCollateralAuth.
+    node.collateralTx = newCollateralTx;
+    WriteMasternode(nodeId, node);
 }
 
 std::optional<MNNewOwnerHeightValue> CMasternodesView::GetNewCollateral(const uint256 &txid) const {
@@ -777,6 +875,7 @@ CCustomCSView::CCustomCSView(CStorageKV &st)
 CCustomCSView::CCustomCSView(CCustomCSView &other)
     : CStorageView(new CFlushableStorageKV(other.DB())),
       writers(other.GetHistoryWriters()) {
+    parentView = &other;
     CheckPrefixes();
 }
 
@@ -786,6 +885,16 @@ CCustomCSView::CCustomCSView(CCustomCSView &other,
                              CVaultHistoryStorage *vaultView)
         : CStorageView(new CFlushableStorageKV(other.DB())),
           writers(historyView, burnView, vaultView) {
+    parentView = &other;
+    CheckPrefixes();
+}
+
+CCustomCSView::CCustomCSView(CStorageKV &st,
+                             CAccountHistoryStorage *historyView,
+                             CBurnHistoryStorage *burnView,
+                             CVaultHistoryStorage *vaultView)
+        : CStorageView(new CFlushableStorageKV(st)),
+          writers(historyView, burnView, vaultView) {
     CheckPrefixes();
 }
 
@@ -807,10 +916,7 @@ CTeamView::CTeam CCustomCSView::CalcNextTeam(int height, const uint256 &stakeMod
     int anchoringTeamSize = Params().GetConsensus().mn.anchoringTeamSize;
 
     std::map<arith_uint256, CKeyID, std::less<arith_uint256>> priorityMN;
-    ForEachMasternode([&](const uint256 &id, CMasternode node) {
-        if (!node.IsActive(height, *this))
-            return true;
-
+    ForEachActiveMasternode(height, [&](const uint256 &id, const CMasternodeActivity &node) {
         CDataStream ss{SER_GETHASH, PROTOCOL_VERSION};
         ss << id << stakeModifier;
         priorityMN.insert(std::make_pair(UintToArith256(Hash(ss.begin(), ss.end())), node.operatorAuthAddress));
@@ -843,10 +949,7 @@ void CCustomCSView::CalcAnchoringTeams(const uint256 &stakeModifier, const CBloc
 
     std::map<arith_uint256, CKeyID, std::less<arith_uint256>> authMN;
     std::map<arith_uint256, CKeyID, std::less<arith_uint256>> confirmMN;
-    ForEachMasternode([&](const uint256 &id, CMasternode node) {
-        if (!node.IsActive(pindexNew->nHeight, *this))
-            return true;
-
+    ForEachActiveMasternode(pindexNew->nHeight, [&](const uint256 &id, const CMasternodeActivity &node) {
         // Not in our list of MNs from last week, skip.
         if (masternodeIDs.find(id) == masternodeIDs.end()) {
             return true;
@@ -945,25 +1048,49 @@ bool CCustomCSView::CalculateOwnerRewards(const CScript &owner, uint32_t targetH
     if (balanceHeight >= targetHeight) {
         return false;
     }
-    ForEachPoolId([&](DCT_ID const &poolId) {
-        auto height = GetShare(poolId, owner);
-        if (!height || *height >= targetHeight) {
-            return true;  // no share or target height is before a pool share' one
+    auto accrueShare = [&](DCT_ID const &poolId, uint32_t height) {
+        if (height >= targetHeight) {
+            return true;  // target height is before a pool share' one
         }
         auto onLiquidity = [&]() -> CAmount { return GetBalance(owner, poolId).nValue; };
-        auto beginHeight = std::max(*height, balanceHeight);
-        CalculatePoolRewards(
-            poolId, onLiquidity, beginHeight, targetHeight, [&](RewardType, CTokenAmount amount, uint32_t height) {
-                auto res = AddBalance(owner, amount);
-                if (!res) {
-                    LogPrintf("Pool rewards: can't update balance of %s: %s, height %ld\n",
-                              owner.GetHex(),
-                              res.msg,
-                              targetHeight);
+        auto beginHeight = std::max(height, balanceHeight);
+        auto addReward = [&](const CTokenAmount &amount) {
+            auto res = AddBalance(owner, amount);
+            if (!res) {
+                LogPrintf("Pool rewards: can't update balance of %s: %s, height %ld\n",
+                          owner.GetHex(),
+                          res.msg,
+                          targetHeight);
+            }
+            return bool(res);
+        };
+        AccruePoolRewards(
+            poolId,
+            onLiquidity,
+            beginHeight,
+            targetHeight,
+            [&](RewardType, CTokenAmount amount, uint32_t height, uint32_t count) {
+                const auto total = arith_uint256(amount.nValue) * count;
+                if (total <= std::numeric_limits<CAmount>::max() &&
+                    AddBalance(owner, {amount.nTokenId, CAmount(total.GetLow64())})) {
+                    return;
+                }
+                // overflowing sum, credit height by height as far as the balance allows
+                for (uint32_t i = 0; i < count; ++i) {
+                    addReward(amount);
                 }
             });
         return true;
-    });
+    };
+
+    if (IsOwnerShareIndexBuilt()) {
+        ForEachOwnerShare(owner, accrueShare);
+    } else {
+        ForEachPoolId([&](DCT_ID const &poolId) {
+            auto height = GetShare(poolId, owner);
+            return !height || accrueShare(poolId, *height);
+        });
+    }
 
     return UpdateBalancesHeight(owner, targetHeight);
 }
@@ -1123,40 +1250,162 @@ Res CCustomCSView::PopulateCollateralData(CVaultAssets &result,
 }
 
 uint256 CCustomCSView::MerkleRoot() {
-    auto rawMap = GetStorage().GetRaw();
-    if (rawMap.empty()) {
+    const auto &rawMap = GetStorage().GetRaw();
+    if (rawMap.Empty()) {
         return {};
     }
-    auto isAttributes = [](const TBytes &key) {
-        MapKV map = {std::make_pair(key, TBytes{})};
-        // Attributes should not be part of merkle root
-        static const std::string attributes("ATTRIBUTES");
-        auto it = NewKVIterator<CGovView::ByName>(attributes, map);
-        return it.Valid() && it.Key() == attributes;
-    };
-
-    auto it = NewKVIterator<CUndosView::ByUndoKey>(UndoKey{}, rawMap);
-    for (; it.Valid(); it.Next()) {
-        CUndo value = it.Value();
-        auto &map   = value.before;
-        for (auto it = map.begin(); it != map.end();) {
-            isAttributes(it->first) ? map.erase(it++) : ++it;
+    // Attributes should not be part of merkle root
+    static const auto attributesKey = DbTypeToBytes(std::make_pair(CGovView::ByName::prefix(), std::string("ATTRIBUTES")));
+    // Neither are indexes derived from other records, the ones a node is yet to build included
+    auto isExcluded = [](TBytesView key) {
+        if (key.size() > 0) {
+            switch (key[0]) {
+                case COracleView::ByPairSubmission::prefix():
+                case COracleView::PairIndexBuilt::prefix():
+                case CPoolPairView::ByOwnerShare::prefix():
+                case CPoolPairView::OwnerShareIndexBuilt::prefix():
+                case CMasternodesView::ByActivity::prefix():
+                case CMasternodesView::ActivityIndexVersion::prefix():
+                    return true;
+            }
         }
-        auto key = std::make_pair(CUndosView::ByUndoKey::prefix(), static_cast<const UndoKey &>(it.Key()));
-        rawMap[DbTypeToBytes(key)] = DbTypeToBytes(value);
-    }
+        return key.size() >= static_cast<std::ptrdiff_t>(attributesKey.size()) &&
+               key.first(attributesKey.size()) == MakeBytesView(attributesKey);
+    };
 
     std::vector<uint256> hashes;
+    hashes.reserve(rawMap.Size());
+    std::pair<uint8_t, UndoKey> undoKey;
     for (const auto &[key, value] : rawMap) {
-        if (!isAttributes(key)) {
-            hashes.push_back(Hash2(key, value ? *value : TBytes{}));
+        if (isExcluded(key)) {
+            continue;
+        }
+        if (!value) {
+            hashes.push_back(Hash2(key, TBytesView{}));
+            continue;
         }
+        if (key.size() > 0 && key[0] == CUndosView::ByUndoKey::prefix() && BytesToDbType(TBytes(key.begin(), key.end()), undoKey)) {
+            CUndo undo;
+            BytesToDbType(TBytes(value->begin(), value->end()), undo);
+            auto &map = undo.before;
+            for (auto it = map.begin(); it != map.end();) {
+                isExcluded(MakeBytesView(it->first)) ? map.erase(it++) : ++it;
+            }
+            hashes.push_back(Hash2(key, MakeBytesView(DbTypeToBytes(undo))));
+            continue;
+        }
+        hashes.push_back(Hash2(key, *value));
     }
     return ComputeMerkleRoot(std::move(hashes));
 }
 
+static constexpr std::initializer_list<uint8_t> attributesPrefixes{CGovView::ByName::prefix()};
+static constexpr std::initializer_list<uint8_t> tokenPrefixes{CTokensView::ID::prefix()};
+static constexpr std::initializer_list<uint8_t> poolPairPrefixes{CPoolPairView::ByID::prefix(),
+                                                                 CPoolPairView::ByReserves::prefix(),
+                                                                 CPoolPairView::ByRewardPct::prefix(),
+                                                                 CPoolPairView::ByRewardLoanPct::prefix(),
+                                                                 CPoolPairView::ByPoolSwap::prefix(),
+                                                                 CPoolPairView::ByTotalLiquidity::prefix()};
+static constexpr std::initializer_list<uint8_t> poolPairGraphPrefixes{CPoolPairView::ByID::prefix()};
+
+bool CCustomCSView::UsesParentCache(std::initializer_list<uint8_t> prefixes) const {
+    if (!parentView) {
+        return false;
+    }
+    const auto &storage = GetStorage();
+    return std::all_of(prefixes.begin(), prefixes.end(), [&](uint8_t prefix) {
+        return storage.LayerVersion(prefix) == 0;
+    });
+}
+
+std::shared_ptr<const ATTRIBUTES> CCustomCSView::GetCachedAttributes() const {
+    if (UsesParentCache(attributesPrefixes)) {
+        return parentView->GetCachedAttributes();
+    }
+    const auto version = PrefixesVersion(DB(), attributesPrefixes);
+    {
+        LOCK(cs_readCache);
+        if (attributesVersion == version) {
+            ++viewCacheStats.attributes.hits;
+            return attributesCache;
+        }
+    }
+    ++viewCacheStats.attributes.misses;
+    std::shared_ptr<const ATTRIBUTES> attributes = CGovView::GetAttributes();
+    LOCK(cs_readCache);
+    attributesCache = attributes;
+    attributesVersion = version;
+    return attributes;
+}
+
+std::shared_ptr<ATTRIBUTES> CCustomCSView::GetAttributes() const {
+    if (const auto attributes = GetCachedAttributes()) {
+        return std::make_shared<ATTRIBUTES>(*attributes);
+    }
+    return {};
+}
+
+std::optional<CTokensView::CTokenImpl> CCustomCSView::GetToken(DCT_ID id) const {
+    if (UsesParentCache(tokenPrefixes)) {
+        return parentView->GetToken(id);
+    }
+    const auto version = PrefixesVersion(DB(), tokenPrefixes);
+    {
+        LOCK(cs_readCache);
+        if (auto token = tokensCache.Get(id, version, viewCacheStats.tokens)) {
+            return *token;
+        }
+    }
+    auto token = CTokensView::GetToken(id);
+    LOCK(cs_readCache);
+    tokensCache.Set(id, version, token);
+    return token;
+}
+
+std::optional<CPoolPair> CCustomCSView::GetPoolPair(const DCT_ID &poolId) const {
+    if (UsesParentCache(poolPairPrefixes)) {
+        return parentView->GetPoolPair(poolId);
+    }
+    const auto version = PrefixesVersion(DB(), poolPairPrefixes);
+    {
+        LOCK(cs_readCache);
+        if (auto pool = poolPairsCache.Get(poolId, version, viewCacheStats.poolPairs)) {
+            return *pool;
+        }
+    }
+    auto pool = CPoolPairView::GetPoolPair(poolId);
+    LOCK(cs_readCache);
+    poolPairsCache.Set(poolId, version, pool);
+    return pool;
+}
+
+std::shared_ptr<const CPoolPairGraph> CCustomCSView::GetPoolPairGraph() {
+    if (UsesParentCache(poolPairGraphPrefixes)) {
+        return parentView->GetPoolPairGraph();
+    }
+    const auto version = PrefixesVersion(DB(), poolPairGraphPrefixes);
+    {
+        LOCK(cs_readCache);
+        if (poolPairGraphVersion == version) {
+            ++viewCacheStats.poolPairGraph.hits;
+            return poolPairGraphCache;
+        }
+    }
+    ++viewCacheStats.poolPairGraph.misses;
+    auto graph = std::make_shared<CPoolPairGraph>();
+    ForEachPoolPair([&](DCT_ID const &id, const CPoolPair &pool) {
+        graph->AddPool(id, pool.idTokenA, pool.idTokenB);
+        return true;
+    });
+    LOCK(cs_readCache);
+    poolPairGraphCache = graph;
+    poolPairGraphVersion = version;
+    return graph;
+}
+
 bool CCustomCSView::AreTokensLocked(const std::set<uint32_t> &tokenIds) const {
-    const auto attributes = GetAttributes();
+    const auto attributes = GetCachedAttributes();
     if (!attributes) {
         return false;
     }
@@ -1237,7 +1486,7 @@ std::map<CKeyID, CKey> AmISignerNow(int height, const CAnchorData::CTeam &team)
 }
 
 std::optional<CLoanView::CLoanSetLoanTokenImpl> CCustomCSView::GetLoanTokenFromAttributes(const DCT_ID &id) const {
-    if (const auto attributes = GetAttributes()) {
+    if (const auto attributes = GetCachedAttributes()) {
         CDataStructureV0 pairKey{AttributeTypes::Token, id.v, TokenKeys::FixedIntervalPriceId};
         CDataStructureV0 interestKey{AttributeTypes::Token, id.v, TokenKeys::LoanMintingInterest};
         CDataStructureV0 mintableKey{AttributeTypes::Token, id.v, TokenKeys::LoanMintingEnabled};
@@ -1259,7 +1508,7 @@ std::optional<CLoanView::CLoanSetLoanTokenImpl> CCustomCSView::GetLoanTokenFromA
 
 std::optional<CLoanView::CLoanSetCollateralTokenImpl> CCustomCSView::GetCollateralTokenFromAttributes(
     const DCT_ID &id) const {
-    if (const auto attributes = GetAttributes()) {
+    if (const auto attributes = GetCachedAttributes()) {
         CLoanSetCollateralTokenImplementation collToken;
 
         CDataStructureV0 pairKey{AttributeTypes::Token, id.v, TokenKeys::FixedIntervalPriceId};
@@ -1283,7 +1532,7 @@ std::optional<CLoanView::CLoanSetCollateralTokenImpl> CCustomCSView::GetCollater
 }
 
 uint32_t CCustomCSView::GetVotingPeriodFromAttributes() const {
-    auto attributes = GetAttributes();
+    auto attributes = GetCachedAttributes();
     assert(attributes);
 
     CDataStructureV0 votingKey{AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::VotingPeriod};
@@ -1292,7 +1541,7 @@ uint32_t CCustomCSView::GetVotingPeriodFromAttributes() const {
 }
 
 uint32_t CCustomCSView::GetEmergencyPeriodFromAttributes(const CProposalType &type) const {
-    auto attributes = GetAttributes();
+    auto attributes = GetCachedAttributes();
     assert(attributes);
 
     CDataStructureV0 VOCKey{AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::VOCEmergencyPeriod};
@@ -1300,7 +1549,7 @@ uint32_t CCustomCSView::GetEmergencyPeriodFromAttributes(const CProposalType &ty
 }
 
 CAmount CCustomCSView::GetApprovalThresholdFromAttributes(const CProposalType &type) const {
-    auto attributes = GetAttributes();
+    auto attributes = GetCachedAttributes();
     assert(attributes);
 
     CDataStructureV0 CFPKey{AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::CFPApprovalThreshold};
@@ -1317,7 +1566,7 @@ CAmount CCustomCSView::GetApprovalThresholdFromAttributes(const CProposalType &t
 }
 
 CAmount CCustomCSView::GetQuorumFromAttributes(const CProposalType &type, bool emergency) const {
-    auto attributes = GetAttributes();
+    auto attributes = GetCachedAttributes();
     assert(attributes);
 
     CDataStructureV0 quorumKey{AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::Quorum};
@@ -1332,7 +1581,7 @@ CAmount CCustomCSView::GetQuorumFromAttributes(const CProposalType &type, bool e
 }
 
 CAmount CCustomCSView::GetFeeBurnPctFromAttributes() const {
-    auto attributes = GetAttributes();
+    auto attributes = GetCachedAttributes();
     assert(attributes);
 
     CDataStructureV0 feeBurnPctKey{AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::FeeBurnPct};
@@ -21,8 +21,10 @@
 #include <masternodes/tokens.h>
 #include <masternodes/undos.h>
 #include <masternodes/vault.h>
+#include <masternodes/viewcache.h>
 #include <pubkey.h>
 #include <serialize.h>
+#include <sync.h>
 #include <uint256.h>
 #include <wallet/ismine.h>
 
@@ -198,9 +200,46 @@ struct MNNewOwnerHeightValue {
     }
 };
 
+// What decides whether a masternode is active from EunosPaya on, as stored in the activity index
+struct CMasternodeActivity {
+    //! First height the node is enabled at, a pending owner change aside
+    uint32_t activeFrom{};
+    CKeyID ownerAuthAddress;
+    CKeyID operatorAuthAddress;
+    //! Whether the node minted any block
+    bool minted{};
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(activeFrom);
+        READWRITE(ownerAuthAddress);
+        READWRITE(operatorAuthAddress);
+        READWRITE(minted);
+    }
+};
+
+struct MNActivityKey {
+    //! Resign height, max if the node did not resign
+    uint32_t activeUntil;
+    uint256 masternodeID;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(WrapBigEndian(activeUntil));
+        READWRITE(masternodeID);
+    }
+};
+
 class CMasternodesView : public virtual CStorageView {
     std::map<CKeyID, std::pair<uint32_t, int64_t>> minterTimeCache;
 
+    void WriteMasternode(const uint256 &nodeId, const CMasternode &node);
+    CMasternodeActivity GetMasternodeActivity(const CMasternode &node) const;
+
 public:
     std::optional<CMasternode> GetMasternode(const uint256 &id) const;
     std::optional<uint256> GetMasternodeIdByOperator(const CKeyID &id) const;
@@ -211,6 +250,14 @@ public:
     void IncrementMintedBy(const uint256 &nodeId);
     void DecrementMintedBy(const uint256 &nodeId);
 
+    // Masternodes active at height. From EunosPaya on they come from the activity index once it
+    // is built, nodes that did not resign by the height only, otherwise every node is checked.
+    void ForEachActiveMasternode(int height,
+                                 std::function<bool(const uint256 &, const CMasternodeActivity &)> callback);
+    bool IsMasternodeActivityIndexBuilt() const;
+    // (Re)builds the activity index from the masternode records
+    void BuildMasternodeActivityIndex();
+
     std::optional<std::pair<CKeyID, uint256>> AmIOperator() const;
     std::optional<std::pair<CKeyID, uint256>> AmIOwner() const;
 
@@ -299,6 +346,14 @@ public:
     struct Timelock {
         static constexpr uint8_t prefix() { return 'K'; }
     };
+
+    // Derived activity index, excluded from the merkle root
+    struct ByActivity {
+        static constexpr uint8_t prefix() { return 0x27; }
+    };
+    struct ActivityIndexVersion {
+        static constexpr uint8_t prefix() { return 0x28; }
+    };
 };
 
 class CLastHeightView : public virtual CStorageView {
@@ -452,6 +507,7 @@ class CCustomCSView : public CMasternodesView,
     {
         CheckPrefix<
             CMasternodesView        ::  ID, NewCollateral, PendingHeight, Operator, Owner, Staker, SubNode, Timelock,
+                                        ByActivity, ActivityIndexVersion,
             CLastHeightView         ::  Height,
             CTeamView               ::  AuthTeam, ConfirmTeam, CurrentTeam,
             CFoundationsDebtView    ::  Debt,
@@ -462,10 +518,11 @@ class CCustomCSView : public CMasternodesView,
             CUndosView              ::  ByUndoKey,
             CPoolPairView           ::  ByID, ByPair, ByShare, ByIDPair, ByPoolSwap, ByReserves, ByRewardPct, ByRewardLoanPct,
                                         ByPoolReward, ByDailyReward, ByCustomReward, ByTotalLiquidity, ByDailyLoanReward,
-                                        ByPoolLoanReward, ByTokenDexFeePct,
+                                        ByPoolLoanReward, ByTokenDexFeePct, ByOwnerShare, OwnerShareIndexBuilt,
             CGovView                ::  ByName, ByHeightVars,
             CAnchorConfirmsView     ::  BtcTx,
-            COracleView             ::  ByName, FixedIntervalBlockKey, FixedIntervalPriceKey, PriceDeviation,
+            COracleView             ::  ByName, FixedIntervalBlockKey, FixedIntervalPriceKey, PriceDeviation, ByPairSubmission,
+                                        PairIndexBuilt,
             CICXOrderView           ::  ICXOrderCreationTx, ICXMakeOfferCreationTx, ICXSubmitDFCHTLCCreationTx,
                                         ICXSubmitEXTHTLCCreationTx, ICXClaimDFCHTLCCreationTx, ICXCloseOrderCreationTx,
                                         ICXCloseOfferCreationTx, ICXOrderOpenKey, ICXOrderCloseKey, ICXMakeOfferOpenKey,
@@ -499,8 +556,23 @@ private:
                                bool useNextPrice,
                                bool requireLivePrice);
 
+    // Read-only attributes shared with the cache, GetAttributes() hands out a mutable copy
+    std::shared_ptr<const ATTRIBUTES> GetCachedAttributes() const;
+    // The parent's read cache is valid here as long as this layer did not touch any of the prefixes
+    bool UsesParentCache(std::initializer_list<uint8_t> prefixes) const;
+
+    mutable Mutex cs_readCache;
+    mutable std::shared_ptr<const ATTRIBUTES> attributesCache GUARDED_BY(cs_readCache);
+    mutable std::optional<uint64_t> attributesVersion GUARDED_BY(cs_readCache);
+    mutable CVersionedCache<DCT_ID, std::optional<CTokenImpl>> tokensCache GUARDED_BY(cs_readCache);
+    mutable CVersionedCache<DCT_ID, std::optional<CPoolPair>> poolPairsCache GUARDED_BY(cs_readCache);
+    std::shared_ptr<const CPoolPairGraph> poolPairGraphCache GUARDED_BY(cs_readCache);
+    std::optional<uint64_t> poolPairGraphVersion GUARDED_BY(cs_readCache);
+
 protected:
     CHistoryWriters writers;
+    // View this one is cached upon, serves reads this layer has nothing to add to
+    CCustomCSView *parentView{};
 
 public:
     // Increase version when underlaying tables are changed
@@ -515,6 +587,10 @@ public:
                   CAccountHistoryStorage *historyView,
                   CBurnHistoryStorage *burnView,
                   CVaultHistoryStorage *vaultView);
+    CCustomCSView(CStorageKV &st,
+                  CAccountHistoryStorage *historyView,
+                  CBurnHistoryStorage *burnView,
+                  CVaultHistoryStorage *vaultView);
 
     ~CCustomCSView() = default;
 
@@ -552,6 +628,16 @@ public:
                                               bool useNextPrice,
                                               bool requireLivePrice);
 
+    using CTokensView::GetToken;
+    using CPoolPairView::GetPoolPair;
+
+    // Reads served from a per view cache, invalidated by any write under the records' key prefixes
+    std::shared_ptr<ATTRIBUTES> GetAttributes() const override;
+    std::optional<CTokenImpl> GetToken(DCT_ID id) const override;
+    std::optional<CPoolPair> GetPoolPair(const DCT_ID &poolId) const override;
+    // Token adjacency of all pool pairs, rebuilt once pools are created or updated
+    std::shared_ptr<const CPoolPairGraph> GetPoolPairGraph();
+
     [[nodiscard]] bool AreTokensLocked(const std::set<uint32_t> &tokenIds) const override;
     [[nodiscard]] std::optional<CTokenImpl> GetTokenGuessId(const std::string &str, DCT_ID &id) const override;
     [[nodiscard]] std::optional<CLoanSetLoanTokenImpl> GetLoanTokenByID(DCT_ID const &id) const override;
@@ -571,6 +657,7 @@ public:
 
     // we construct it as it
     CFlushableStorageKV &GetStorage() { return static_cast<CFlushableStorageKV &>(DB()); }
+    const CFlushableStorageKV &GetStorage() const { return static_cast<const CFlushableStorageKV &>(DB()); }
 
     uint32_t GetVotingPeriodFromAttributes() const override;
     uint32_t GetEmergencyPeriodFromAttributes(const CProposalType &type) const override;
@@ -3,6 +3,7 @@
 // file LICENSE or http://www.opensource.org/licenses/mit-license.php.
 
 #include <masternodes/accountshistory.h>
+#include <masternodes/dftxstats.h>
 #include <masternodes/govvariables/attributes.h>
 #include <masternodes/historywriter.h>
 #include <masternodes/mn_checks.h>
@@ -4404,6 +4405,7 @@ Res ApplyCustomTx(CCustomCSView &mnview,
 
     auto txMessage = customTypeToMessage(txType);
     CAccountsHistoryWriter view(mnview, height, txn, tx.GetHash(), uint8_t(txType));
+    CDfTxStatsScope stats(ToString(txType), view.GetStorage().GetRaw());
     if ((res = CustomMetadataParse(height, consensus, metadata, txMessage))) {
         if (mnview.GetHistoryWriters().GetVaultView()) {
             PopulateVaultHistoryData(mnview.GetHistoryWriters(), view, txMessage, txType, height, txn, tx.GetHash());
@@ -4467,6 +4469,7 @@ Res ApplyCustomTx(CCustomCSView &mnview,
     // construct undo
     auto &flushable = view.GetStorage();
     auto undo       = CUndo::Construct(mnview.GetStorage(), flushable.GetRaw());
+    stats.Stop();
     // flush changes
     view.Flush();
     // write undo
@@ -4653,15 +4656,20 @@ std::vector<DCT_ID> CPoolSwap::CalculateSwaps(CCustomCSView &view, const Consens
 
     // Loop through all common pairs
     for (const auto &path : poolPaths) {
-        // Test on copy of view
-        CCustomCSView dummy(view);
+        // Test on copy of view. Test runs only simulate the swaps on the pools read
+        // from the view and write nothing, so they share the view.
+        std::optional<CCustomCSView> dummy;
+        if (!testOnly) {
+            dummy.emplace(view);
+        }
+        auto &pathView = dummy ? *dummy : view;
 
         // Execute pool path
-        auto res = ExecuteSwap(dummy, path, consensus, testOnly);
+        auto res = ExecuteSwap(pathView, path, consensus, testOnly);
 
         // Add error for RPC user feedback
         if (!res) {
-            const auto token = dummy.GetToken(currentID);
+            const auto token = pathView.GetToken(currentID);
             if (token) {
                 errors.emplace_back(token->symbol, res.msg);
             }
@@ -4677,83 +4685,7 @@ std::vector<DCT_ID> CPoolSwap::CalculateSwaps(CCustomCSView &view, const Consens
 }
 
 std::vector<std::vector<DCT_ID> > CPoolSwap::CalculatePoolPaths(CCustomCSView &view) {
-    std::vector<std::vector<DCT_ID> > poolPaths;
-
-    // For tokens to be traded get all pairs and pool IDs
-    std::multimap<uint32_t, DCT_ID> fromPoolsID, toPoolsID;
-    view.ForEachPoolPair(
-        [&](DCT_ID const &id, const CPoolPair &pool) {
-            if ((obj.idTokenFrom == pool.idTokenA && obj.idTokenTo == pool.idTokenB) ||
-                (obj.idTokenTo == pool.idTokenA && obj.idTokenFrom == pool.idTokenB)) {
-                // Push poolId when direct path
-                poolPaths.push_back({{id}});
-            }
-
-            if (pool.idTokenA == obj.idTokenFrom) {
-                fromPoolsID.emplace(pool.idTokenB.v, id);
-            } else if (pool.idTokenB == obj.idTokenFrom) {
-                fromPoolsID.emplace(pool.idTokenA.v, id);
-            }
-
-            if (pool.idTokenA == obj.idTokenTo) {
-                toPoolsID.emplace(pool.idTokenB.v, id);
-            } else if (pool.idTokenB == obj.idTokenTo) {
-                toPoolsID.emplace(pool.idTokenA.v, id);
-            }
-            return true;
-        },
-        {0});
-
-    if (fromPoolsID.empty() || toPoolsID.empty()) {
-        return {};
-    }
-
-    // Find intersection on key
-    std::map<uint32_t, DCT_ID> commonPairs;
-    set_intersection(fromPoolsID.begin(),
-                     fromPoolsID.end(),
-                     toPoolsID.begin(),
-                     toPoolsID.end(),
-                     std::inserter(commonPairs, commonPairs.begin()),
-                     [](std::pair<uint32_t, DCT_ID> a, std::pair<uint32_t, DCT_ID> b) { return a.first < b.first; });
-
-    // Loop through all common pairs and record direct pool to pool swaps
-    for (const auto &item : commonPairs) {
-        // Loop through all source/intermediate pools matching common pairs
-        const auto poolFromIDs = fromPoolsID.equal_range(item.first);
-        for (auto fromID = poolFromIDs.first; fromID != poolFromIDs.second; ++fromID) {
-            // Loop through all destination pools matching common pairs
-            const auto poolToIDs = toPoolsID.equal_range(item.first);
-            for (auto toID = poolToIDs.first; toID != poolToIDs.second; ++toID) {
-                // Add to pool paths
-                poolPaths.push_back({fromID->second, toID->second});
-            }
-        }
-    }
-
-    // Look for pools that bridges token. Might be in addition to common token pairs paths.
-    view.ForEachPoolPair(
-        [&](DCT_ID const &id, const CPoolPair &pool) {
-            // Loop through from pool multimap on unique keys only
-            for (auto fromIt = fromPoolsID.begin(); fromIt != fromPoolsID.end();
-                 fromIt      = fromPoolsID.equal_range(fromIt->first).second) {
-                // Loop through to pool multimap on unique keys only
-                for (auto toIt = toPoolsID.begin(); toIt != toPoolsID.end();
-                     toIt      = toPoolsID.equal_range(toIt->first).second) {
-                    // If a pool pairs matches from pair and to pair add it to the pool paths
-                    if ((fromIt->first == pool.idTokenA.v && toIt->first == pool.idTokenB.v) ||
-                        (fromIt->first == pool.idTokenB.v && toIt->first == pool.idTokenA.v)) {
-                        poolPaths.push_back({fromIt->second, id, toIt->second});
-                    }
-                }
-            }
-
-            return true;
-        },
-        {0});
-
-    // return pool paths
-    return poolPaths;
+    return view.GetPoolPairGraph()->FindPaths(obj.idTokenFrom, obj.idTokenTo);
 }
 
 // Note: `testOnly` doesn't update views, and as such can result in a previous price calculations
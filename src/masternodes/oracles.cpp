@@ -28,6 +28,7 @@ ResVal<CAmount> COracle::GetTokenPrice(const std::string &token, const std::stri
 
 Res COracleView::AppointOracle(const COracleId &oracleId, const COracle &oracle) {
     Require(WriteBy<ByName>(oracleId, oracle), [=]{ return strprintf("failed to appoint the new oracle <%s>", oracleId.GetHex()); });
+    WritePairSubmissions(oracleId, oracle);
 
     return Res::Ok();
 }
@@ -53,20 +54,25 @@ Res COracleView::UpdateOracle(const COracleId &oracleId, COracle &&newOracle) {
         }
     }
 
+    ErasePairSubmissions(oracleId, oracle);
+
     oracle.tokenPrices    = std::move(allowedPrices);
     oracle.availablePairs = std::move(newOracle.availablePairs);
 
     // no need to update oracles list
     Require(WriteBy<ByName>(oracleId, oracle), [=]{ return strprintf("failed to save oracle <%s>", oracleId.GetHex()); });
+    WritePairSubmissions(oracleId, oracle);
 
     return Res::Ok();
 }
 
 Res COracleView::RemoveOracle(const COracleId &oracleId) {
-    Require(ExistsBy<ByName>(oracleId), [=]{ return strprintf("oracle <%s> not found", oracleId.GetHex()); });
+    COracle oracle;
+    Require(ReadBy<ByName>(oracleId, oracle), [=]{ return strprintf("oracle <%s> not found", oracleId.GetHex()); });
 
     // remove oracle
     Require(EraseBy<ByName>(oracleId), [=]{ return strprintf("failed to remove oracle <%s>", oracleId.GetHex()); });
+    ErasePairSubmissions(oracleId, oracle);
 
     return Res::Ok();
 }
@@ -84,6 +90,13 @@ Res COracleView::SetOracleData(const COracleId &oracleId, int64_t timestamp, con
     }
 
     Require(WriteBy<ByName>(oracleId, oracle), [=]{ return strprintf("failed to store oracle %s to database", oracleId.GetHex()); });
+
+    for (const auto &[token, prices] : tokenPrices) {
+        for (const auto &[currency, amount] : prices) {
+            WriteBy<ByPairSubmission>(std::make_pair(std::make_pair(token, currency), oracleId),
+                                      COraclePairSubmission{amount, timestamp, oracle.weightage});
+        }
+    }
     return Res::Ok();
 }
 
@@ -99,6 +112,46 @@ void COracleView::ForEachOracle(std::function<bool(const COracleId &, CLazySeria
     ForEach<ByName, COracleId, COracle>(callback, start);
 }
 
+void COracleView::WritePairSubmissions(const COracleId &oracleId, const COracle &oracle) {
+    for (const auto &[token, prices] : oracle.tokenPrices) {
+        for (const auto &[currency, price] : prices) {
+            WriteBy<ByPairSubmission>(std::make_pair(std::make_pair(token, currency), oracleId),
+                                      COraclePairSubmission{price.first, price.second, oracle.weightage});
+        }
+    }
+}
+
+void COracleView::ErasePairSubmissions(const COracleId &oracleId, const COracle &oracle) {
+    for (const auto &[token, prices] : oracle.tokenPrices) {
+        for (const auto &[currency, price] : prices) {
+            EraseBy<ByPairSubmission>(std::make_pair(std::make_pair(token, currency), oracleId));
+        }
+    }
+}
+
+bool COracleView::IsOraclePairIndexBuilt() const {
+    return ExistsBy<PairIndexBuilt>('\0');
+}
+
+void COracleView::BuildOraclePairIndex() {
+    ForEachOracle([&](const COracleId &oracleId, CLazySerialize<COracle> oracle) {
+        WritePairSubmissions(oracleId, oracle.get());
+        return true;
+    });
+    WriteBy<PairIndexBuilt>('\0', '\0');
+}
+
+void COracleView::ForEachOraclePairSubmission(
+    const CTokenCurrencyPair &pair,
+    std::function<bool(const COracleId &, const COraclePairSubmission &)> callback) {
+    using KeyType = std::pair<CTokenCurrencyPair, COracleId>;
+    for (auto it = LowerBound<ByPairSubmission>(KeyType{pair, {}}); it.Valid() && it.Key().first == pair; it.Next()) {
+        if (!callback(it.Key().second, it.Value().as<COraclePairSubmission>())) {
+            break;
+        }
+    }
+}
+
 bool CFixedIntervalPrice::isLive(const CAmount deviationThreshold) const {
     return (priceRecord[0] > 0 && priceRecord[1] > 0 &&
             (std::abs(priceRecord[1] - priceRecord[0]) < MultiplyAmounts(priceRecord[0], deviationThreshold)));
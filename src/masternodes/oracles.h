@@ -96,6 +96,22 @@ struct COracle : public CAppointOracleMessage {
     }
 };
 
+/// Latest price of a pair submitted by an oracle, with the oracle's weightage
+struct COraclePairSubmission {
+    CAmount price;
+    int64_t timestamp;
+    uint8_t weightage;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(price);
+        READWRITE(timestamp);
+        READWRITE(weightage);
+    }
+};
+
 struct CFixedIntervalPrice {
     CTokenCurrencyPair priceFeedId;
     int64_t timestamp;
@@ -140,6 +156,16 @@ public:
     void ForEachOracle(std::function<bool(const COracleId &, CLazySerialize<COracle>)> callback,
                        const COracleId &start = {});
 
+    /// whether the submissions by pair are indexed for every oracle
+    bool IsOraclePairIndexBuilt() const;
+
+    /// index the submissions of all oracles by pair
+    void BuildOraclePairIndex();
+
+    /// iterate the submissions for a pair, by oracle id
+    void ForEachOraclePairSubmission(const CTokenCurrencyPair &pair,
+                                     std::function<bool(const COracleId &, const COraclePairSubmission &)> callback);
+
     Res SetFixedIntervalPrice(const CFixedIntervalPrice &PriceFeed);
 
     ResVal<CFixedIntervalPrice> GetFixedIntervalPrice(const CTokenCurrencyPair &priceFeedId);
@@ -173,6 +199,16 @@ public:
     struct FixedIntervalPriceKey {
         static constexpr uint8_t prefix() { return 'y'; }
     };
+    struct ByPairSubmission {
+        static constexpr uint8_t prefix() { return 0x1D; }
+    };
+    struct PairIndexBuilt {
+        static constexpr uint8_t prefix() { return 0x1E; }
+    };
+
+private:
+    void WritePairSubmissions(const COracleId &oracleId, const COracle &oracle);
+    void ErasePairSubmissions(const COracleId &oracleId, const COracle &oracle);
 };
 
 #endif  // DEFI_MASTERNODES_ORACLES_H
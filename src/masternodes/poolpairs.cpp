@@ -68,6 +68,67 @@ ReturnType ReadValueAt(CPoolPairView *poolView, const PoolHeightKey &poolKey) {
     return {};
 }
 
+void CPoolPairGraph::AddPool(DCT_ID poolId, DCT_ID idTokenA, DCT_ID idTokenB) {
+    pools.push_back({poolId, idTokenA, idTokenB});
+    adjacency[idTokenA].emplace_back(idTokenB, poolId);
+    if (idTokenB != idTokenA) {
+        adjacency[idTokenB].emplace_back(idTokenA, poolId);
+    }
+}
+
+std::vector<std::vector<DCT_ID>> CPoolPairGraph::FindPaths(DCT_ID from, DCT_ID to) const {
+    const auto fromIt = adjacency.find(from);
+    const auto toIt = adjacency.find(to);
+    if (fromIt == adjacency.end() || toIt == adjacency.end()) {
+        return {};
+    }
+
+    std::vector<std::vector<DCT_ID>> paths;
+
+    // pools of either token by the token they are paired with
+    std::map<DCT_ID, std::vector<DCT_ID>> fromPools, toPools;
+    for (const auto &[token, poolId] : fromIt->second) {
+        if (token == to) {
+            paths.push_back({poolId});
+        }
+        fromPools[token].push_back(poolId);
+    }
+    for (const auto &[token, poolId] : toIt->second) {
+        toPools[token].push_back(poolId);
+    }
+
+    // pool to pool over a common token
+    for (const auto &[token, fromIDs] : fromPools) {
+        const auto toIDs = toPools.find(token);
+        if (toIDs == toPools.end()) {
+            continue;
+        }
+        for (const auto &fromID : fromIDs) {
+            for (const auto &toID : toIDs->second) {
+                paths.push_back({fromID, toID});
+            }
+        }
+    }
+
+    // pools bridging the tokens paired with either, over the first pool of each
+    for (const auto &pool : pools) {
+        auto bridge = [&](DCT_ID fromToken, DCT_ID toToken) {
+            const auto fromIDs = fromPools.find(fromToken);
+            const auto toIDs = toPools.find(toToken);
+            if (fromIDs != fromPools.end() && toIDs != toPools.end()) {
+                paths.push_back({fromIDs->second.front(), pool.id, toIDs->second.front()});
+            }
+        };
+        const auto [low, high] = std::minmax(pool.idTokenA, pool.idTokenB);
+        bridge(low, high);
+        if (low != high) {
+            bridge(high, low);
+        }
+    }
+
+    return paths;
+}
+
 Res CPoolPairView::SetPoolPair(DCT_ID const &poolId, uint32_t height, const CPoolPair &pool) {
     Require(pool.idTokenA != pool.idTokenB, []{ return "Error: tokens IDs are the same."; });
     auto poolPairByID   = GetPoolPair(poolId);
@@ -216,14 +277,29 @@ auto InitPoolVars(CPoolPairView &view, PoolHeightKey poolKey, uint32_t end) {
     auto poolId = poolKey.poolID;
     auto it     = view.LowerBound<By>(poolKey);
 
-    auto height                       = poolKey.height;
-    static const uint32_t startHeight = Params().GetConsensus().GrandCentralHeight;
-    poolKey.height                    = std::max(height, startHeight);
-
-    while (!MatchPoolId(it, poolId) && poolKey.height < end) {
-        height = poolKey.height;
-        it.Seek(poolKey);
-        poolKey.height++;
+    auto height            = poolKey.height;
+    const auto startHeight = uint32_t(Params().GetConsensus().GrandCentralHeight);
+    const auto from        = std::max(height, startHeight);
+
+    // Without a record at the first height the value starts at the first height from
+    // startHeight on with a record at or before it, or at end - 1 if there is none.
+    // Having one is monotone in the height, so it is bisected instead of sought per height.
+    if (!MatchPoolId(it, poolId) && from < end) {
+        height = end - 1;
+        it.Seek(PoolHeightKey{poolId, height});
+        if (MatchPoolId(it, poolId)) {
+            auto low = from;
+            while (low < height) {
+                const auto mid = low + (height - low) / 2;
+                it.Seek(PoolHeightKey{poolId, mid});
+                if (MatchPoolId(it, poolId)) {
+                    height = mid;
+                } else {
+                    low = mid + 1;
+                }
+            }
+            it.Seek(PoolHeightKey{poolId, height});
+        }
     }
 
     Value value = MatchPoolId(it, poolId) ? it.Value() : Value{};
@@ -335,6 +411,124 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
     }
 }
 
+void CPoolPairView::AccruePoolRewards(DCT_ID const &poolId,
+                                      std::function<CAmount()> onLiquidity,
+                                      uint32_t begin,
+                                      uint32_t end,
+                                      std::function<void(RewardType, CTokenAmount, uint32_t, uint32_t)> onReward) {
+    if (begin >= end) {
+        return;
+    }
+    constexpr const uint32_t PRECISION = 10000;
+    const auto newCalcHeight           = uint32_t(Params().GetConsensus().BayfrontGardensHeight);
+
+    auto tokenIds = ReadBy<ByIDPair, ByPairKey>(poolId);
+    assert(tokenIds);  // contract to verify pool data
+
+    PoolHeightKey poolKey = {poolId, begin};
+
+    auto [poolReward, itPoolReward, startPoolReward] = InitPoolVars<ByPoolReward, CAmount>(*this, poolKey, end);
+    auto nextPoolReward                              = startPoolReward;
+
+    auto [poolLoanReward, itPoolLoanReward, startPoolLoanReward] =
+        InitPoolVars<ByPoolLoanReward, CAmount>(*this, poolKey, end);
+    auto nextPoolLoanReward = startPoolLoanReward;
+
+    auto [totalLiquidity, itTotalLiquidity, nextTotalLiquidity] =
+        InitPoolVars<ByTotalLiquidity, CAmount>(*this, poolKey, end);
+
+    auto [customRewards, itCustomRewards, startCustomRewards] =
+        InitPoolVars<ByCustomReward, CBalances>(*this, poolKey, end);
+    auto nextCustomRewards = startCustomRewards;
+
+    auto poolSwapHeight                  = std::numeric_limits<uint32_t>::max();
+    auto nextPoolSwap                    = std::numeric_limits<uint32_t>::max();
+    auto [poolSwap, itPoolSwap, discard] = InitPoolVars<ByPoolSwap, PoolSwapValue>(*this, poolKey, end);
+    if (itPoolSwap.Valid() && itPoolSwap.Key().poolID == poolId) {
+        nextPoolSwap = itPoolSwap.Key().height;
+    }
+
+    for (auto height = begin; height < end;) {
+        // find suitable pool liquidity
+        if (height == nextTotalLiquidity || totalLiquidity == 0) {
+            height = nextTotalLiquidity;
+            ReadValueMoveToNext(itTotalLiquidity, poolId, totalLiquidity, nextTotalLiquidity);
+            continue;
+        }
+        // adjust iterators to working height
+        while (height >= nextPoolReward) {
+            ReadValueMoveToNext(itPoolReward, poolId, poolReward, nextPoolReward);
+        }
+        while (height >= nextPoolLoanReward) {
+            ReadValueMoveToNext(itPoolLoanReward, poolId, poolLoanReward, nextPoolLoanReward);
+        }
+        while (height >= nextPoolSwap) {
+            poolSwapHeight = nextPoolSwap;
+            ReadValueMoveToNext(itPoolSwap, poolId, poolSwap, nextPoolSwap);
+        }
+        while (height >= nextCustomRewards) {
+            ReadValueMoveToNext(itCustomRewards, poolId, customRewards, nextCustomRewards);
+        }
+        // every height up to the next change of a pool variable earns the same
+        auto runEnd = end;
+        for (const auto boundary : {nextTotalLiquidity, nextPoolReward, nextPoolLoanReward, nextPoolSwap,
+                                    nextCustomRewards, startPoolReward, startPoolLoanReward, startCustomRewards,
+                                    newCalcHeight}) {
+            if (boundary > height) {
+                runEnd = std::min(runEnd, boundary);
+            }
+        }
+        // rewards paid in the pool's own share token change the liquidity at every height
+        if (customRewards.balances.count(poolId)) {
+            runEnd = height + 1;
+        }
+        const auto count     = runEnd - height;
+        const auto liquidity = onLiquidity();
+        // daily rewards
+        if (height >= startPoolReward && poolReward != 0) {
+            CAmount providerReward = 0;
+            if (height < newCalcHeight) {  // old calculation
+                uint32_t liqWeight = liquidity * PRECISION / totalLiquidity;
+                providerReward     = poolReward * liqWeight / PRECISION;
+            } else {  // new calculation
+                providerReward = liquidityReward(poolReward, liquidity, totalLiquidity);
+            }
+            onReward(RewardType::Coinbase, {DCT_ID{0}, providerReward}, height, count);
+        }
+        if (height >= startPoolLoanReward && poolLoanReward != 0) {
+            CAmount providerReward = liquidityReward(poolLoanReward, liquidity, totalLiquidity);
+            onReward(RewardType::LoanTokenDEXReward, {DCT_ID{0}, providerReward}, height, count);
+        }
+        // commissions, only earned at the swap height itself
+        if (poolSwapHeight == height && poolSwap.swapEvent) {
+            CAmount feeA, feeB;
+            if (height < newCalcHeight) {
+                uint32_t liqWeight = liquidity * PRECISION / totalLiquidity;
+                feeA               = poolSwap.blockCommissionA * liqWeight / PRECISION;
+                feeB               = poolSwap.blockCommissionB * liqWeight / PRECISION;
+            } else {
+                feeA = liquidityReward(poolSwap.blockCommissionA, liquidity, totalLiquidity);
+                feeB = liquidityReward(poolSwap.blockCommissionB, liquidity, totalLiquidity);
+            }
+            if (feeA) {
+                onReward(RewardType::Commission, {tokenIds->idTokenA, feeA}, height, 1);
+            }
+            if (feeB) {
+                onReward(RewardType::Commission, {tokenIds->idTokenB, feeB}, height, 1);
+            }
+        }
+        // custom rewards
+        if (height >= startCustomRewards) {
+            for (const auto &reward : customRewards.balances) {
+                if (auto providerReward = liquidityReward(reward.second, liquidity, totalLiquidity)) {
+                    onReward(RewardType::Pool, {reward.first, providerReward}, height, count);
+                }
+            }
+        }
+        height = runEnd;
+    }
+}
+
 Res CPoolPair::AddLiquidity(CAmount amountA,
                             CAmount amountB,
                             std::function<Res(CAmount)> onMint,
@@ -631,11 +825,13 @@ std::pair<CAmount, CAmount> CPoolPairView::UpdatePoolRewards(
 
 Res CPoolPairView::SetShare(DCT_ID const &poolId, const CScript &provider, uint32_t height) {
     WriteBy<ByShare>(PoolShareKey{poolId, provider}, height);
+    WriteBy<ByOwnerShare>(OwnerShareKey{provider, poolId}, height);
     return Res::Ok();
 }
 
 Res CPoolPairView::DelShare(DCT_ID const &poolId, const CScript &provider) {
     EraseBy<ByShare>(PoolShareKey{poolId, provider});
+    EraseBy<ByOwnerShare>(OwnerShareKey{provider, poolId});
     return Res::Ok();
 }
 
@@ -712,6 +908,29 @@ void CPoolPairView::ForEachPoolShare(std::function<bool(DCT_ID const &, const CS
         startKey);
 }
 
+void CPoolPairView::ForEachOwnerShare(const CScript &owner, std::function<bool(DCT_ID const &, uint32_t)> callback) {
+    ForEach<ByOwnerShare, OwnerShareKey, uint32_t>(
+        [&](const OwnerShareKey &key, uint32_t height) {
+            return key.owner == owner && callback(key.poolID, height);
+        },
+        OwnerShareKey{owner, DCT_ID{0}});
+}
+
+bool CPoolPairView::IsOwnerShareIndexBuilt() const {
+    return ExistsBy<OwnerShareIndexBuilt>('\0');
+}
+
+void CPoolPairView::BuildOwnerShareIndex() {
+    size_t count{};
+    ForEachPoolShare([&](DCT_ID const &poolId, const CScript &owner, uint32_t height) {
+        WriteBy<ByOwnerShare>(OwnerShareKey{owner, poolId}, height);
+        ++count;
+        return true;
+    });
+    WriteBy<OwnerShareIndexBuilt>('\0', '\0');
+    LogPrintf("Owner share index built (%d shares)\n", count);
+}
+
 Res CPoolPairView::SetDexFeePct(DCT_ID poolId, DCT_ID tokenId, CAmount feePct) {
     Require(feePct >= 0 && feePct <= COIN, []{ return "Token dex fee should be in percentage"; });
     WriteBy<ByTokenDexFeePct>(std::make_pair(poolId, tokenId), uint32_t(feePct));
@@ -217,6 +217,20 @@ struct PoolShareKey {
     }
 };
 
+// Share of an owner, ordered by owner so that all of an owner's pools are adjacent
+struct OwnerShareKey {
+    CScript owner;
+    DCT_ID poolID;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(owner);
+        READWRITE(WrapBigEndian(poolID.v));
+    }
+};
+
 struct PoolHeightKey {
     DCT_ID poolID;
     uint32_t height;
@@ -248,6 +262,28 @@ enum RewardType {
 std::string RewardToString(RewardType type);
 std::string RewardTypeToString(RewardType type);
 
+// Token adjacency of the pool pairs, answers the candidate paths of a composite swap
+class CPoolPairGraph {
+public:
+    // Pools in id order
+    void AddPool(DCT_ID poolId, DCT_ID idTokenA, DCT_ID idTokenB);
+
+    // Direct, two and three pool paths from one token to another. Paths come in the order
+    // composite swaps have always tried them in, the first of equally good ones is used.
+    std::vector<std::vector<DCT_ID>> FindPaths(DCT_ID from, DCT_ID to) const;
+
+private:
+    struct Pool {
+        DCT_ID id;
+        DCT_ID idTokenA;
+        DCT_ID idTokenB;
+    };
+
+    std::vector<Pool> pools;
+    // (other token, pool id) of every token's pools, in pool id order
+    std::map<DCT_ID, std::vector<std::pair<DCT_ID, DCT_ID>>> adjacency;
+};
+
 class CPoolPairView : public virtual CStorageView {
 public:
     Res SetPoolPair(const DCT_ID &poolId, uint32_t height, const CPoolPair &pool);
@@ -258,7 +294,7 @@ public:
                        const CScript &ownerAddress,
                        const CBalances &rewards);
 
-    std::optional<CPoolPair> GetPoolPair(const DCT_ID &poolId) const;
+    virtual std::optional<CPoolPair> GetPoolPair(const DCT_ID &poolId) const;
     std::optional<std::pair<DCT_ID, CPoolPair> > GetPoolPair(DCT_ID const &tokenA, DCT_ID const &tokenB) const;
 
     void ForEachPoolId(std::function<bool(DCT_ID const &)> callback, DCT_ID const &start = DCT_ID{0});
@@ -271,12 +307,27 @@ public:
 
     std::optional<uint32_t> GetShare(DCT_ID const &poolId, const CScript &provider);
 
+    // Pools the owner has a share in with the share's height, in pool id order.
+    // Only complete once the owner share index is built.
+    void ForEachOwnerShare(const CScript &owner, std::function<bool(DCT_ID const &, uint32_t)> callback);
+    bool IsOwnerShareIndexBuilt() const;
+    void BuildOwnerShareIndex();
+
     void CalculatePoolRewards(DCT_ID const &poolId,
                               std::function<CAmount()> onLiquidity,
                               uint32_t begin,
                               uint32_t end,
                               std::function<void(RewardType, CTokenAmount, uint32_t)> onReward);
 
+    // Same rewards as CalculatePoolRewards, reported once per run of heights in which none of the
+    // pool's reward variables change: amount is earned at each of the count heights from height on.
+    // Liquidity is sampled once per run, onReward must not change it.
+    void AccruePoolRewards(DCT_ID const &poolId,
+                           std::function<CAmount()> onLiquidity,
+                           uint32_t begin,
+                           uint32_t end,
+                           std::function<void(RewardType, CTokenAmount, uint32_t, uint32_t)> onReward);
+
     Res SetLoanDailyReward(const uint32_t height, const CAmount reward);
     Res SetDailyReward(uint32_t height, CAmount reward);
     Res SetRewardPct(DCT_ID const &poolId, uint32_t height, CAmount rewardPct);
@@ -339,6 +390,12 @@ public:
     struct ByTokenDexFeePct {
         static constexpr uint8_t prefix() { return 'l'; }
     };
+    struct ByOwnerShare {
+        static constexpr uint8_t prefix() { return 0x1F; }
+    };
+    struct OwnerShareIndexBuilt {
+        static constexpr uint8_t prefix() { return 0x26; }
+    };
 };
 
 struct CLiquidityMessage {
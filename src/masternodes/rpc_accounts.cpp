@@ -234,6 +234,59 @@ static void searchInWallet(const CWallet *pwallet,
     }
 }
 
+// Segments a filtered history query can skip. Only meant for queries whose
+// callbacks do nothing for the rows they filter out.
+static AccountHistorySegmentFilter historySegmentFilter(const std::set<uint8_t> &categories, const std::string &tokenFilter) {
+    AccountHistorySegmentFilter segmentFilter;
+    segmentFilter.categories = categories;
+    DCT_ID id;
+    if (!tokenFilter.empty()) {
+        if (auto token = pcustomcsview->GetTokenGuessId(tokenFilter, id); token && token->CreateSymbolKey(id) == tokenFilter) {
+            segmentFilter.token = id;
+        }
+    }
+    return segmentFilter;
+}
+
+static std::set<uint8_t> txTypeCategories(const std::set<CustomTxType> &txTypes) {
+    std::set<uint8_t> categories;
+    // rows of unknown categories are read as None
+    if (txTypes.count(CustomTxType::None)) {
+        return categories;
+    }
+    for (const auto type : txTypes) {
+        categories.insert(static_cast<uint8_t>(type));
+    }
+    return categories;
+}
+
+// Owner scripts of the wallet's keys and redeem scripts matching the filter
+static std::set<CScript> walletOwners(CWallet *const pwallet, isminetype filter) {
+    std::set<CScript> owners;
+    auto addOwner = [&](const CTxDestination &dest) {
+        auto script = GetScriptForDestination(dest);
+        if (IsMineCached(*pwallet, script) & filter) {
+            owners.insert(std::move(script));
+        }
+    };
+    for (const auto &keyID : pwallet->GetKeys()) {
+        CPubKey pubKey;
+        if (pwallet->GetPubKey(keyID, pubKey)) {
+            for (const auto &dest : GetAllDestinationsForKey(pubKey)) {
+                addOwner(dest);
+            }
+        }
+    }
+    for (const auto &scriptID : pwallet->GetCScripts()) {
+        addOwner(ScriptHash(scriptID));
+        CScript script;
+        if (pwallet->GetCScript(scriptID, script)) {
+            addOwner(WitnessV0ScriptHash(script));
+        }
+    }
+    return owners;
+}
+
 static CScript hexToScript(const std::string &str) {
     if (!IsHex(str)) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "(" + str + ") doesn't represent a correct hex:\n");
@@ -1265,6 +1318,10 @@ UniValue listaccounthistory(const JSONRPCRequest& request) {
     maxBlockHeight = std::min(maxBlockHeight, uint32_t(::ChainActive().Height()));
     depth = std::min(depth, maxBlockHeight);
 
+    // rewards are calculated from and wallet accounts counted over the filtered out rows too
+    const auto segmentFilter = noRewards && !isMine ? historySegmentFilter(txTypeCategories(txTypes), tokenFilter)
+                                                    : AccountHistorySegmentFilter{};
+
     for (const auto &account : accountSet) {
         const auto startBlock = maxBlockHeight - depth;
         auto shouldSkipBlock = [startBlock, maxBlockHeight](uint32_t blockHeight) {
@@ -1274,6 +1331,8 @@ UniValue listaccounthistory(const JSONRPCRequest& request) {
         CScript lastOwner;
         auto count = limit + start;
         auto lastHeight = maxBlockHeight;
+        uint64_t entries{};
+        auto lastEntryHeight = maxBlockHeight;
 
         if (!account.empty())
             isMatchOwner = [&account](const CScript &owner) { return owner == account; };
@@ -1285,6 +1344,12 @@ UniValue listaccounthistory(const JSONRPCRequest& request) {
                 return false;
             }
 
+            // Without rewards wallet entries are listed at the heights of their rows, the ones
+            // below a full page of them are cut off anyway.
+            if (isMine && noRewards && key.blockHeight < lastEntryHeight && entries >= uint64_t{limit} + start) {
+                return false;
+            }
+
             std::unique_ptr<CScopeAccountReverter> reverter;
             if (!noRewards) {
                 reverter = std::make_unique<CScopeAccountReverter>(view, key.owner, value.diff);
@@ -1334,6 +1399,8 @@ UniValue listaccounthistory(const JSONRPCRequest& request) {
                     txs.insert(value.txid);
                 }
                 --count;
+                ++entries;
+                lastEntryHeight = workingHeight;
             }
 
             if (!noRewards && count && lastHeight > workingHeight) {
@@ -1374,7 +1441,12 @@ UniValue listaccounthistory(const JSONRPCRequest& request) {
                 account);
         }
 
-        paccountHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, account, maxBlockHeight, txn);
+        if (isMine) {
+            paccountHistoryDB->ForEachAccountHistoryOfOwners(shouldContinueToNextAccountHistory, walletOwners(pwallet, filter),
+                                                             maxBlockHeight, txn, segmentFilter);
+        } else {
+            paccountHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, account, maxBlockHeight, txn, segmentFilter);
+        }
 
         if (shouldSearchInWallet) {
             count = limit + start;
@@ -1592,7 +1664,12 @@ UniValue listburnhistory(const JSONRPCRequest& request) {
         return count != 0;
     };
 
-    pburnHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, {}, maxBlockHeight);
+    std::set<uint8_t> categories;
+    if (txTypeSearch) {
+        categories.insert(static_cast<uint8_t>(txType));
+    }
+    pburnHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, {}, maxBlockHeight,
+                                          std::numeric_limits<uint32_t>::max(), historySegmentFilter(categories, tokenFilter));
 
     UniValue slice(UniValue::VARR);
     for (auto it = ret.cbegin(); limit != 0 && it != ret.cend(); ++it) {
@@ -1737,6 +1814,10 @@ UniValue accounthistorycount(const JSONRPCRequest& request) {
     CCoinsViewCache coins(&::ChainstateActive().CoinsTip());
     uint64_t count = 0;
 
+    // rewards are calculated from the filtered out rows too
+    const auto segmentFilter = noRewards ? historySegmentFilter(txTypeCategories(txTypes), tokenFilter)
+                                         : AccountHistorySegmentFilter{};
+
     for (const auto &owner : accountSet) {
         CScript lastOwner;
         auto lastHeight          = uint32_t(::ChainActive().Height());
@@ -1791,7 +1872,8 @@ UniValue accounthistorycount(const JSONRPCRequest& request) {
             return true;
         };
 
-        paccountHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, owner, currentHeight);
+        paccountHistoryDB->ForEachAccountHistory(shouldContinueToNextAccountHistory, owner, currentHeight,
+                                                 std::numeric_limits<uint32_t>::max(), segmentFilter);
 
         if (shouldSearchInWallet) {
             searchInWallet(
@@ -2174,8 +2256,6 @@ UniValue getburninfo(const JSONRPCRequest& request) {
     }.Check(request);
 
     if (auto res = GetRPCResultCache().TryGet(request)) return *res;
-    auto initialResult = GetMemoizedResultCache().GetOrDefault(request);
-    auto totalResult = std::get_if<CGetBurnInfoResult>(&initialResult.data);
 
     CAmount dfiPaybackFee{0};
     CAmount burnt{0};
@@ -2190,7 +2270,6 @@ UniValue getburninfo(const JSONRPCRequest& request) {
     LOCK(cs_main);
 
     auto height = ::ChainActive().Height();
-    auto hash = ::ChainActive().Tip()->GetBlockHash();
     auto fortCanningHeight = Params().GetConsensus().FortCanningHeight;
     auto burnAddress = Params().GetConsensus().burnAddress;
     auto view = *pcustomcsview;
@@ -2226,146 +2305,31 @@ UniValue getburninfo(const JSONRPCRequest& request) {
         }
     }
 
-    auto nWorkers = DfTxTaskPool->GetAvailableThreads();
-    if (static_cast<size_t>(height) < nWorkers) {
-        nWorkers = height;
-    }
-
-    const auto chunkSize = height / nWorkers;
-
-    TaskGroup g;
-    BufferPool<CGetBurnInfoResult> resultsPool{nWorkers};
-
-    auto &pool = DfTxTaskPool->pool;
-    auto processedHeight = initialResult.height;
-    auto i               = 0;
-    while (processedHeight < height)
-    {
-        auto startHeight = initialResult.height + (chunkSize * (i + 1));
-        auto stopHeight  = initialResult.height + (chunkSize * (i));
-
-        g.AddTask();
-        boost::asio::post(pool, [startHeight, stopHeight, &g, &resultsPool] {
-            auto currentResult = resultsPool.Acquire();
-
-            pburnHistoryDB->ForEachAccountHistory(
-                [currentResult, stopHeight](const AccountHistoryKey &key, const AccountHistoryValue &value) {
-                    // Stop on chunk range for worker
-                    if (key.blockHeight <= stopHeight) {
-                        return false;
-                    }
-
-                    // UTXO burn
-                    if (value.category == uint8_t(CustomTxType::None)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->burntDFI += diff.second;
-                        }
-                        return true;
-                    }
-
-                    // Fee burn
-                    if (value.category == uint8_t(CustomTxType::CreateMasternode) ||
-                        value.category == uint8_t(CustomTxType::CreateToken) ||
-                        value.category == uint8_t(CustomTxType::Vault) ||
-                        value.category == uint8_t(CustomTxType::CreateCfp) ||
-                        value.category == uint8_t(CustomTxType::CreateVoc)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->burntFee += diff.second;
-                        }
-                        return true;
-                    }
-
-                    // withdraw burn
-                    if (value.category == uint8_t(CustomTxType::PaybackLoan) ||
-                        value.category == uint8_t(CustomTxType::PaybackLoanV2) ||
-                        value.category == uint8_t(CustomTxType::PaybackWithCollateral)) {
-                        for (const auto &[id, amount] : value.diff) {
-                            currentResult->paybackFee.Add({id, amount});
-                        }
-                        return true;
-                    }
-
-                    // auction burn
-                    if (value.category == uint8_t(CustomTxType::AuctionBid)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->auctionFee += diff.second;
-                        }
-                        return true;
-                    }
-
-                    // dex fee burn
-                    if (value.category == uint8_t(CustomTxType::PoolSwap) ||
-                        value.category == uint8_t(CustomTxType::PoolSwapV2)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->dexfeeburn.Add({diff.first, diff.second});
-                        }
-                        return true;
-                    }
-
-                    // token burn with burnToken tx
-                    if (value.category == uint8_t(CustomTxType::BurnToken)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->nonConsortiumTokens.Add({diff.first, diff.second});
-                        }
-                        return true;
-                    }
-
-                    // Token burn
-                    for (auto const &diff : value.diff) {
-                        currentResult->burntTokens.Add({diff.first, diff.second});
-                    }
-
-                    return true;
-                },
-                {},
-                startHeight,
-                std::numeric_limits<uint32_t>::max());
-
-            resultsPool.Release(currentResult);
-            g.RemoveTask();
-        });
-
-        // perfect accuracy: processedHeight += (startHeight > height) ? chunksRemainder : chunkSize;
-        processedHeight += chunkSize;
-        i++;
-    }
-
-    g.WaitForCompletion();
-
-    for (const auto &r : resultsPool.GetBuffer()) {
-        totalResult->burntDFI += r->burntDFI;
-        totalResult->burntFee += r->burntFee;
-        totalResult->auctionFee += r->auctionFee;
-        totalResult->burntTokens.AddBalances(r->burntTokens.balances);
-        totalResult->nonConsortiumTokens.AddBalances(r->nonConsortiumTokens.balances);
-        totalResult->dexfeeburn.AddBalances(r->dexfeeburn.balances);
-        totalResult->paybackFee.AddBalances(r->paybackFee.balances);
-    }
-
-    GetMemoizedResultCache().Set(request, {height, hash, *totalResult});
+    // kept up to date as burn history is written and erased
+    auto totals = pburnHistoryDB->GetTotals();
 
     CDataStructureV0 liveKey = {AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::ConsortiumMinted};
     auto balances = attributes->GetValue(liveKey, CConsortiumGlobalMinted{});
 
-    for (const auto &token : totalResult->nonConsortiumTokens.balances) {
+    for (const auto &token : totals.nonConsortiumTokens.balances) {
         TAmounts amount;
         amount[token.first] = balances[token.first].burnt;
         consortiumTokens.AddBalances(amount);
     }
 
-    totalResult->nonConsortiumTokens.SubBalances(consortiumTokens.balances);
-    totalResult->burntTokens.AddBalances(totalResult->nonConsortiumTokens.balances);
+    totals.nonConsortiumTokens.SubBalances(consortiumTokens.balances);
+    totals.burntTokens.AddBalances(totals.nonConsortiumTokens.balances);
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("address", ScriptToString(burnAddress));
-    result.pushKV("amount", ValueFromAmount(totalResult->burntDFI));
+    result.pushKV("amount", ValueFromAmount(totals.burntDFI));
 
-    result.pushKV("tokens", AmountsToJSON(totalResult->burntTokens.balances));
+    result.pushKV("tokens", AmountsToJSON(totals.burntTokens.balances));
     result.pushKV("consortiumtokens", AmountsToJSON(consortiumTokens.balances));
-    result.pushKV("feeburn", ValueFromAmount(totalResult->burntFee));
-    result.pushKV("auctionburn", ValueFromAmount(totalResult->auctionFee));
-    result.pushKV("paybackburn", AmountsToJSON(totalResult->paybackFee.balances));
-    result.pushKV("dexfeetokens", AmountsToJSON(totalResult->dexfeeburn.balances));
+    result.pushKV("feeburn", ValueFromAmount(totals.burntFee));
+    result.pushKV("auctionburn", ValueFromAmount(totals.auctionFee));
+    result.pushKV("paybackburn", AmountsToJSON(totals.paybackFee.balances));
+    result.pushKV("dexfeetokens", AmountsToJSON(totals.dexfeeburn.balances));
 
     result.pushKV("dfipaybackfee", ValueFromAmount(dfiPaybackFee));
     result.pushKV("dfipaybacktokens", AmountsToJSON(dfipaybacktokens.balances));
@@ -1344,91 +1344,76 @@ UniValue getloaninfo(const JSONRPCRequest& request) {
     auto defaultScheme = view.GetDefaultLoanScheme();
     auto priceBlocks = GetFixedIntervalPriceBlocks(::ChainActive().Height(), view);
 
-    TaskGroup g;
-    g.AddTask();
+    view.ForEachLoanScheme([&](const std::string& identifier, const CLoanSchemeData& data) {
+        totalLoanSchemes++;
+        return true;
+    });
 
-    auto &pool = DfTxTaskPool->pool;
+    // First assume it's on the DB. For later, might be worth thinking if it's better to incorporate
+    // attributes right into the for each loop, so the interface remains consistent.
+    view.ForEachLoanCollateralToken([&](CollateralTokenKey const& key, uint256 const& collTokenTx) {
+        totalCollateralTokens++;
+        return true;
+    });
 
-    boost::asio::post(pool, [&] {
-        view.ForEachLoanScheme([&](const std::string& identifier, const CLoanSchemeData& data) {
-            totalLoanSchemes++;
-            return true;
-        });
+    view.ForEachLoanToken([&](DCT_ID const& key, CLoanView::CLoanSetLoanTokenImpl loanToken) {
+        totalLoanTokens++;
+        return true;
+    });
 
-        // First assume it's on the DB. For later, might be worth thinking if it's better to incorporate
-        // attributes right into the for each loop, so the interface remains consistent.
-        view.ForEachLoanCollateralToken([&](CollateralTokenKey const& key, uint256 const& collTokenTx) {
-            totalCollateralTokens++;
-            return true;
-        });
+    // Now, let's go over attributes. If it's on attributes, the above calls would have done nothing.
+    auto attributes = view.GetAttributes();
+    if (!attributes) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "attributes access failure");
+    }
 
-        view.ForEachLoanToken([&](DCT_ID const& key, CLoanView::CLoanSetLoanTokenImpl loanToken) {
+    attributes->ForEach([&](const CDataStructureV0& attr, const CAttributeValue&) {
+        if (attr.type != AttributeTypes::Token)
+            return false;
+        if (attr.key == TokenKeys::LoanCollateralEnabled)
+            totalCollateralTokens++;
+        else if (attr.key == TokenKeys::LoanMintingEnabled)
             totalLoanTokens++;
-            return true;
-        });
-
-        // Now, let's go over attributes. If it's on attributes, the above calls would have done nothing.
-        auto attributes = view.GetAttributes();
-        if (!attributes) {
-            throw JSONRPCError(RPC_INTERNAL_ERROR, "attributes access failure");
-        }
-
-        attributes->ForEach([&](const CDataStructureV0& attr, const CAttributeValue&) {
-            if (attr.type != AttributeTypes::Token)
-                return false;
-            if (attr.key == TokenKeys::LoanCollateralEnabled)
-                totalCollateralTokens++;
-            else if (attr.key == TokenKeys::LoanMintingEnabled)
-                totalLoanTokens++;
-            return true;
-        }, CDataStructureV0{AttributeTypes::Token});
+        return true;
+    }, CDataStructureV0{AttributeTypes::Token});
 
-        view.ForEachVaultAuction([&](const CVaultId& vaultId, const CAuctionData& data) {
-            totalAuctions += data.batchCount;
-            return true;
-        }, height);
+    view.ForEachVaultAuction([&](const CVaultId& vaultId, const CAuctionData& data) {
+        totalAuctions += data.batchCount;
+        return true;
+    }, height);
 
-        g.RemoveTask();
-    });
+    struct VaultTotals {
+        uint64_t vaults{};
+        uint64_t collaterals{};
+        uint64_t loans{};
+    };
 
-    std::atomic<uint64_t> vaultsTotal{0};
-    std::atomic<uint64_t> colsValTotal{0};
-    std::atomic<uint64_t> loansValTotal{0};
-
-    view.ForEachVault([&](const CVaultId &vaultId, const CVaultData &data) {
-        g.AddTask();
-        boost::asio::post(pool,
-                          [&,
-                           &colsValTotal    = colsValTotal,
-                           &loansValTotal   = loansValTotal,
-                           &vaultsTotal     = vaultsTotal,
-                           vaultId          = vaultId,
-                           height           = height,
-                           useNextPrice     = useNextPrice,
-                           requireLivePrice = requireLivePrice] {
-                              auto collaterals = view.GetVaultCollaterals(vaultId);
-                              if (!collaterals)
-                                  collaterals = CBalances{};
-                              auto rate = view.GetVaultAssets(
-                                  vaultId, *collaterals, height, lastBlockTime, useNextPrice, requireLivePrice);
-                              if (rate) {
-                                  colsValTotal.fetch_add(rate.val->totalCollaterals, std::memory_order_relaxed);
-                                  loansValTotal.fetch_add(rate.val->totalLoans, std::memory_order_relaxed);
-                              }
-                              vaultsTotal.fetch_add(1, std::memory_order_relaxed);
-                              g.RemoveTask();
-                          });
+    std::vector<CVaultId> vaultIds;
+    view.ForEachVault([&](const CVaultId &vaultId, const CVaultData &) {
+        vaultIds.push_back(vaultId);
         return true;
     });
 
-    g.WaitForCompletion();
-    // We use relaxed ordering to increment. Thread joins should in theory,
-    // resolve have resulted in full barriers, but we ensure
-    // to throw in a full barrier anyway. x86 arch might appear to work without
-    // but let's be extra cautious about RISC optimizers.
-    totalVaults = vaultsTotal.load();
-    totalLoanValue = loansValTotal.load();
-    totalCollateralValue = colsValTotal.load();
+    auto vaultTotals = DfTxTaskPool->ParallelReduce<VaultTotals>(0, vaultIds.size(), {"getloaninfo", 16},
+        [&](VaultTotals &totals, size_t i) {
+            const auto &vaultId = vaultIds[i];
+            auto collaterals = view.GetVaultCollaterals(vaultId);
+            if (!collaterals)
+                collaterals = CBalances{};
+            auto rate = view.GetVaultAssets(
+                vaultId, *collaterals, height, lastBlockTime, useNextPrice, requireLivePrice);
+            if (rate) {
+                totals.collaterals += rate.val->totalCollaterals;
+                totals.loans += rate.val->totalLoans;
+            }
+            ++totals.vaults;
+        });
+
+    vaultTotals.ForEach([&](const VaultTotals &totals) {
+        totalVaults += totals.vaults;
+        totalCollateralValue += totals.collaterals;
+        totalLoanValue += totals.loans;
+    });
 
     UniValue totalsObj{UniValue::VOBJ};
 
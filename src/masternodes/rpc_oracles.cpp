@@ -826,31 +826,38 @@ ResVal<CAmount> GetAggregatePrice(CCustomCSView& view, const std::string& token,
     }
     arith_uint256 weightedSum = 0;
     uint64_t numLiveOracles = 0, sumWeights = 0;
-    view.ForEachOracle([&](const COracleId&, COracle oracle) {
-        if (!oracle.SupportsPair(token, currency)) {
-            return true;
+    auto addPrice = [&](CAmount amount, int64_t timestamp, uint8_t weightage) {
+        if (!diffInHour(timestamp, lastBlockTime)) {
+            return;
         }
-        for (const auto& tokenPrice : oracle.tokenPrices) {
-            if (token != tokenPrice.first) {
-                continue;
+        ++numLiveOracles;
+        sumWeights += weightage;
+        weightedSum += arith_uint256(amount) * arith_uint256(weightage);
+    };
+    if (view.IsOraclePairIndexBuilt()) {
+        view.ForEachOraclePairSubmission({token, currency}, [&](const COracleId&, const COraclePairSubmission& submission) {
+            addPrice(submission.price, submission.timestamp, submission.weightage);
+            return true;
+        });
+    } else {
+        view.ForEachOracle([&](const COracleId&, COracle oracle) {
+            if (!oracle.SupportsPair(token, currency)) {
+                return true;
             }
-            for (const auto& price : tokenPrice.second) {
-                if (currency != price.first) {
+            for (const auto& tokenPrice : oracle.tokenPrices) {
+                if (token != tokenPrice.first) {
                     continue;
                 }
-                const auto& pricePair = price.second;
-                auto amount = pricePair.first;
-                auto timestamp = pricePair.second;
-                if (!diffInHour(timestamp, lastBlockTime)) {
-                    continue;
+                for (const auto& price : tokenPrice.second) {
+                    if (currency != price.first) {
+                        continue;
+                    }
+                    addPrice(price.second.first, price.second.second, oracle.weightage);
                 }
-                ++numLiveOracles;
-                sumWeights += oracle.weightage;
-                weightedSum += arith_uint256(amount) * arith_uint256(oracle.weightage);
             }
-        }
-        return true;
-    });
+            return true;
+        });
+    }
 
     static const uint64_t minimumLiveOracles = Params().NetworkIDString() == CBaseChainParams::REGTEST ? 1 : 2;
     Require(numLiveOracles >= minimumLiveOracles, []{ return "no live oracles for specified request"; });
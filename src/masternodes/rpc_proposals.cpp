@@ -1083,8 +1083,8 @@ UniValue getgovproposal(const JSONRPCRequest &request) {
     }
 
     std::set<uint256> activeMasternodes;
-    view.ForEachMasternode([&](const uint256 &mnId, CMasternode node) {
-        if (node.IsActive(targetHeight, view) && node.mintedBlocks) {
+    view.ForEachActiveMasternode(targetHeight, [&](const uint256 &mnId, const CMasternodeActivity &node) {
+        if (node.minted) {
             activeMasternodes.insert(mnId);
         }
         return true;
@@ -0,0 +1,239 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/snapshot.h>
+
+#include <chainparams.h>
+#include <clientversion.h>
+#include <consensus/merkle.h>
+#include <crypto/common.h>
+#include <hash.h>
+#include <masternodes/masternodes.h>
+#include <masternodes/threadpool.h>
+#include <shutdown.h>
+
+namespace {
+
+using SnapshotRecords = std::vector<std::pair<TBytes, TBytes>>;
+
+TBytes EncodeRecords(const SnapshotRecords &records) {
+    CDataStream s(SER_DISK, CLIENT_VERSION);
+    const TBytes *prev{nullptr};
+    for (const auto &[key, value] : records) {
+        size_t shared{0};
+        if (prev) {
+            const auto limit = std::min(prev->size(), key.size());
+            while (shared < limit && (*prev)[shared] == key[shared]) {
+                ++shared;
+            }
+        }
+        WriteCompactSize(s, shared);
+        WriteCompactSize(s, key.size() - shared);
+        s.write(reinterpret_cast<const char *>(key.data() + shared), key.size() - shared);
+        s << value;
+        prev = &key;
+    }
+    return {s.begin(), s.end()};
+}
+
+// Fails unless the payload holds exactly the records, in strictly ascending key order
+bool DecodeRecords(const TBytes &payload, uint32_t count, SnapshotRecords &records) {
+    records.clear();
+    records.reserve(count);
+    try {
+        CDataStream s(payload, SER_DISK, CLIENT_VERSION);
+        TBytes key;
+        while (count--) {
+            const auto shared = ReadCompactSize(s);
+            const auto suffix = ReadCompactSize(s);
+            if (shared > key.size()) {
+                return false;
+            }
+            key.resize(shared + suffix);
+            s.read(reinterpret_cast<char *>(key.data() + shared), suffix);
+            if (!records.empty() && !(records.back().first < key)) {
+                return false;
+            }
+            TBytes value;
+            s >> value;
+            records.emplace_back(key, std::move(value));
+        }
+        return s.empty();
+    } catch (const std::ios_base::failure &) {
+        return false;
+    }
+}
+
+uint256 RecordsRoot(const SnapshotRecords &records) {
+    std::vector<uint256> hashes;
+    hashes.reserve(records.size());
+    for (const auto &[key, value] : records) {
+        hashes.push_back(Hash2(key, value));
+    }
+    return ComputeMerkleRoot(std::move(hashes));
+}
+
+template <typename Body>
+void ForEachChunk(size_t count, const char *name, Body &&body) {
+    if (DfTxTaskPool) {
+        DfTxTaskPool->ParallelFor(0, count, {name}, body);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            body(i, 0);
+        }
+    }
+}
+
+}  // namespace
+
+uint32_t CDeFiStateSnapshotHeader::NetworkMagic(const CChainParams &params) {
+    return ReadLE32(reinterpret_cast<const unsigned char *>(params.MessageStart()));
+}
+
+Res CDeFiStateSnapshotHeader::Check(const CChainParams &params) const {
+    Require(version == VERSION, "unknown snapshot version %d", version);
+    Require(networkMagic == NetworkMagic(params), "snapshot of another network");
+    Require(dbVersion == CCustomCSView::DbVersion, "snapshot of database version %d, expected %d", dbVersion, CCustomCSView::DbVersion);
+    // the EVM state is kept apart from the databases a snapshot carries
+    Require(height < params.GetConsensus().NextNetworkUpgradeHeight,
+            "snapshots at or past height %d are not supported, the EVM state is not part of them",
+            params.GetConsensus().NextNetworkUpgradeHeight);
+    return Res::Ok();
+}
+
+uint256 CDeFiStateSnapshotChunk::Checksum() const {
+    CHashWriter hasher(SER_GETHASH, 0);
+    hasher << section << records << payload;
+    return hasher.GetHash();
+}
+
+ResVal<CDeFiStateSnapshotTrailer> DumpDeFiStateSnapshot(CAutoFile &file, const CDeFiStateSnapshotHeader &header, std::vector<CDeFiStateSnapshotSource> &sources) {
+    file << header;
+
+    CDeFiStateSnapshotTrailer trailer;
+    trailer.sectionRoots.resize(SNAPSHOT_SECTIONS);
+    for (auto &source : sources) {
+        const auto section = static_cast<uint8_t>(source.section);
+        std::vector<uint256> chunkRoots;
+        std::vector<SnapshotRecords> window;
+
+        auto writeWindow = [&]() {
+            std::vector<CDeFiStateSnapshotChunk> chunks(window.size());
+            std::vector<uint256> roots(window.size());
+            ForEachChunk(window.size(), "Snapshot chunks encode", [&](size_t i, size_t) {
+                auto &chunk = chunks[i];
+                chunk.section = section;
+                chunk.records = window[i].size();
+                chunk.payload = EncodeRecords(window[i]);
+                chunk.checksum = chunk.Checksum();
+                roots[i] = RecordsRoot(window[i]);
+            });
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                file << chunks[i];
+                chunkRoots.push_back(roots[i]);
+                trailer.records += chunks[i].records;
+            }
+            window.clear();
+        };
+
+        SnapshotRecords records;
+        for (source.it->Seek({}); source.it->Valid(); source.it->Next()) {
+            const auto key = source.it->KeyView();
+            if (source.exclude && source.exclude(key)) {
+                continue;
+            }
+            const auto value = source.it->ValueView();
+            records.emplace_back(TBytes(key.begin(), key.end()), TBytes(value.begin(), value.end()));
+            if (records.size() < SNAPSHOT_CHUNK_RECORDS) {
+                continue;
+            }
+            window.push_back(std::move(records));
+            records.clear();
+            if (window.size() == SNAPSHOT_WINDOW_CHUNKS) {
+                writeWindow();
+                Require(!ShutdownRequested(), "shutdown requested");
+            }
+        }
+        if (!records.empty()) {
+            window.push_back(std::move(records));
+        }
+        writeWindow();
+        trailer.sectionRoots[section] = ComputeMerkleRoot(std::move(chunkRoots));
+    }
+
+    CDeFiStateSnapshotChunk end;
+    end.section = SNAPSHOT_END;
+    end.checksum = end.Checksum();
+    file << end;
+
+    trailer.stateRoot = ComputeMerkleRoot(trailer.sectionRoots);
+    file << trailer;
+    return {trailer, Res::Ok()};
+}
+
+ResVal<CDeFiStateSnapshotTrailer> LoadDeFiStateSnapshot(CAutoFile &file, const std::array<CStorageKV *, SNAPSHOT_SECTIONS> &targets) {
+    std::array<std::vector<uint256>, SNAPSHOT_SECTIONS> chunkRoots;
+    std::array<TBytes, SNAPSHOT_SECTIONS> lastKeys;
+    uint8_t lastSection{0};
+    uint64_t records{0};
+    size_t chunksRead{0};
+
+    for (bool end = false; !end;) {
+        std::vector<CDeFiStateSnapshotChunk> chunks;
+        while (chunks.size() < SNAPSHOT_WINDOW_CHUNKS) {
+            CDeFiStateSnapshotChunk chunk;
+            file >> chunk;
+            if (chunk.section == SNAPSHOT_END) {
+                end = true;
+                break;
+            }
+            Require(chunk.section < SNAPSHOT_SECTIONS && chunk.section >= lastSection,
+                    "chunk %d of unknown or out of order section %d", chunksRead + chunks.size(), chunk.section);
+            Require(chunk.records > 0 && chunk.records <= SNAPSHOT_CHUNK_RECORDS,
+                    "chunk %d of %d records", chunksRead + chunks.size(), chunk.records);
+            lastSection = chunk.section;
+            chunks.push_back(std::move(chunk));
+        }
+
+        std::vector<SnapshotRecords> decoded(chunks.size());
+        std::vector<uint256> roots(chunks.size());
+        std::vector<char> valid(chunks.size());
+        ForEachChunk(chunks.size(), "Snapshot chunks decode", [&](size_t i, size_t) {
+            const auto &chunk = chunks[i];
+            valid[i] = chunk.checksum == chunk.Checksum() && DecodeRecords(chunk.payload, chunk.records, decoded[i]);
+            if (valid[i]) {
+                roots[i] = RecordsRoot(decoded[i]);
+            }
+        });
+
+        for (size_t i = 0; i < chunks.size(); ++i, ++chunksRead) {
+            Require(valid[i], "chunk %d is corrupted", chunksRead);
+            const auto section = chunks[i].section;
+            auto &lastKey = lastKeys[section];
+            Require(lastKey.empty() || lastKey < decoded[i].front().first, "chunk %d out of key order", chunksRead);
+            lastKey = decoded[i].back().first;
+            chunkRoots[section].push_back(roots[i]);
+            records += decoded[i].size();
+            if (const auto target = targets[section]) {
+                for (const auto &[key, value] : decoded[i]) {
+                    target->Write(key, value);
+                }
+            }
+        }
+        for (const auto target : targets) {
+            Require(!target || target->Flush(), "failed to write the records");
+        }
+        Require(!ShutdownRequested(), "shutdown requested");
+    }
+
+    CDeFiStateSnapshotTrailer trailer;
+    file >> trailer;
+    Require(trailer.records == records, "%d records in the snapshot, %d expected", records, trailer.records);
+    Require(trailer.sectionRoots.size() == SNAPSHOT_SECTIONS, "%d section roots", trailer.sectionRoots.size());
+    for (uint8_t section = 0; section < SNAPSHOT_SECTIONS; ++section) {
+        Require(ComputeMerkleRoot(std::move(chunkRoots[section])) == trailer.sectionRoots[section], "records of section %d do not match its root", section);
+    }
+    Require(ComputeMerkleRoot(trailer.sectionRoots) == trailer.stateRoot, "section roots do not match the state root");
+    return {trailer, Res::Ok()};
+}
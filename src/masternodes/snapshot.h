@@ -0,0 +1,120 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_SNAPSHOT_H
+#define DEFI_MASTERNODES_SNAPSHOT_H
+
+#include <flushablestorage.h>
+#include <masternodes/res.h>
+#include <serialize.h>
+#include <streams.h>
+#include <uint256.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class CChainParams;
+
+// Databases a DeFi state snapshot carries, their chunks are written in this order
+enum class SnapshotSection : uint8_t {
+    CustomCS = 0,
+    Coins = 1,
+    AccountHistory = 2,
+    BurnHistory = 3,
+    VaultHistory = 4,
+};
+
+static constexpr uint8_t SNAPSHOT_SECTIONS = 5;
+// Section of the chunk closing the snapshot, the trailer follows it
+static constexpr uint8_t SNAPSHOT_END = 0xff;
+// Records per chunk. Fixed, so the roots of a state do not depend on the node that dumped it.
+static constexpr uint32_t SNAPSHOT_CHUNK_RECORDS = 4096;
+// Chunks encoded or decoded at once on the DfTx pool
+static constexpr size_t SNAPSHOT_WINDOW_CHUNKS = 64;
+
+struct CDeFiStateSnapshotHeader {
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t version{VERSION};
+    uint32_t networkMagic{};
+    int32_t dbVersion{};
+    // block the state is at, the one the coins' best block is
+    int32_t height{};
+    uint256 blockHash;
+
+    // Whether a node of the network can load the snapshot
+    Res Check(const CChainParams &params) const;
+
+    static uint32_t NetworkMagic(const CChainParams &params);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(version);
+        READWRITE(networkMagic);
+        READWRITE(dbVersion);
+        READWRITE(height);
+        READWRITE(blockHash);
+    }
+};
+
+// Consecutive records of a section. Keys are front coded against the previous key of
+// the chunk, so every chunk decodes on its own.
+struct CDeFiStateSnapshotChunk {
+    uint8_t section{};
+    uint32_t records{};
+    TBytes payload;
+    uint256 checksum;
+
+    uint256 Checksum() const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(section);
+        READWRITE(records);
+        READWRITE(payload);
+        READWRITE(checksum);
+    }
+};
+
+// State commitment of the snapshot. A chunk's root is the merkle root of its records hashed
+// as the block's DeFi merkle root hashes them, a section's root the merkle root of its chunks'
+// roots and the state root the merkle root of the section roots.
+struct CDeFiStateSnapshotTrailer {
+    uint64_t records{};
+    std::vector<uint256> sectionRoots;
+    uint256 stateRoot;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(records);
+        READWRITE(sectionRoots);
+        READWRITE(stateRoot);
+    }
+};
+
+struct CDeFiStateSnapshotSource {
+    SnapshotSection section;
+    std::unique_ptr<CStorageKVIterator> it;
+    // records left out of the snapshot, empty to write all of them
+    std::function<bool(TBytesView)> exclude;
+};
+
+// Writes the header and the records of the sources, in section order, then the trailer
+ResVal<CDeFiStateSnapshotTrailer> DumpDeFiStateSnapshot(CAutoFile &file, const CDeFiStateSnapshotHeader &header, std::vector<CDeFiStateSnapshotSource> &sources);
+
+// Reads the chunks following the header and the trailer. Every chunk is checked before its
+// records are written to the storage of its section, sections without one are checked only.
+// The storages are flushed as the chunks are written, the caller has to clear them on failure.
+ResVal<CDeFiStateSnapshotTrailer> LoadDeFiStateSnapshot(CAutoFile &file, const std::array<CStorageKV *, SNAPSHOT_SECTIONS> &targets);
+
+#endif  // DEFI_MASTERNODES_SNAPSHOT_H
@@ -0,0 +1,450 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/speculative.h>
+
+#include <logging.h>
+#include <masternodes/accountshistory.h>
+#include <masternodes/mn_checks.h>
+#include <masternodes/threadpool.h>
+#include <masternodes/vaulthistory.h>
+#include <primitives/block.h>
+
+bool fDfTxSpeculation = DEFAULT_DFTX_SPECULATION;
+
+// Iterator which reports the contiguous key range it has walked to its storage
+class CReadTrackingIterator : public CStorageKVIterator {
+public:
+    CReadTrackingIterator(std::unique_ptr<CStorageKVIterator> &&it, CReadTrackingStorageKV &storage)
+        : it(std::move(it)), storage(storage) {}
+    CReadTrackingIterator(const CReadTrackingIterator &) = delete;
+    ~CReadTrackingIterator() override {
+        Report();
+    }
+
+    void Seek(const TBytes &key) override {
+        Report();
+        it->Seek(key);
+        range = CReadTrackingStorageKV::Range{key, key};
+        Visit(false);
+    }
+    void Next() override {
+        it->Next();
+        Visit(false);
+    }
+    void Prev() override {
+        it->Prev();
+        Visit(true);
+    }
+    bool Valid() override {
+        return it->Valid();
+    }
+    TBytesView KeyView() override {
+        return it->KeyView();
+    }
+    TBytesView ValueView() override {
+        return it->ValueView();
+    }
+
+private:
+    void Visit(bool backward) {
+        if (!range) {
+            return;
+        }
+        if (!it->Valid()) {
+            if (backward) {
+                range->begin.clear();
+            } else {
+                range->unbounded = true;
+            }
+            return;
+        }
+        auto key = it->KeyView();
+        if (CompareBytes(key, MakeBytesView(range->begin)) < 0) {
+            range->begin.assign(key.begin(), key.end());
+        } else if (CompareBytes(MakeBytesView(range->end), key) < 0) {
+            range->end.assign(key.begin(), key.end());
+        }
+    }
+    void Report() {
+        if (range) {
+            storage.AddRange(std::move(*range));
+            range.reset();
+        }
+    }
+
+    std::unique_ptr<CStorageKVIterator> it;
+    CReadTrackingStorageKV &storage;
+    std::optional<CReadTrackingStorageKV::Range> range;
+};
+
+bool CReadTrackingStorageKV::Exists(const TBytes &key) const {
+    reads.keys.insert(key);
+    return db.Exists(key);
+}
+
+bool CReadTrackingStorageKV::Read(const TBytes &key, TBytes &value) const {
+    reads.keys.insert(key);
+    return db.Read(key, value);
+}
+
+std::unique_ptr<CStorageKVIterator> CReadTrackingStorageKV::NewIterator() {
+    return std::make_unique<CReadTrackingIterator>(db.NewIterator(), *this);
+}
+
+bool CReadSet::Intersects(const std::set<TBytes> &written) const {
+    if (written.empty()) {
+        return false;
+    }
+    for (const auto &key : keys) {
+        if (written.count(key)) {
+            return true;
+        }
+    }
+    for (const auto &range : ranges) {
+        auto it = written.lower_bound(range.begin);
+        if (it != written.end() && (range.unbounded || !(range.end < *it))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CCoinsViewReadTracking::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    LOCK(cs);
+    reads.insert(outpoint);
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewReadTracking::HaveCoin(const COutPoint &outpoint) const {
+    LOCK(cs);
+    reads.insert(outpoint);
+    return base->HaveCoin(outpoint);
+}
+
+struct CDfTxSpeculativeExecutor::Result {
+    std::optional<Res> res;
+    std::unique_ptr<CReadTrackingStorageKV> tracker;
+    std::unique_ptr<CAccountHistoryStorage> historyView;
+    std::unique_ptr<CBurnHistoryStorage> burnView;
+    std::unique_ptr<CVaultHistoryStorage> vaultView;
+    std::unique_ptr<CCustomCSView> view;
+    std::set<COutPoint> coinReads;
+};
+
+static bool IsSpeculationAllowed(CustomTxType txType) {
+    switch (txType) {
+        case CustomTxType::None:
+        case CustomTxType::Reject:
+        // these queue work into the EVM, which has to happen strictly in block order
+        case CustomTxType::CreateToken:
+        case CustomTxType::TransferDomain:
+        case CustomTxType::EvmTx:
+            return false;
+        default:
+            return true;
+    }
+}
+
+CDfTxSpeculativeExecutor::CDfTxSpeculativeExecutor(const CBlock &block,
+                                                   uint32_t height,
+                                                   uint64_t time,
+                                                   const Consensus::Params &consensus,
+                                                   uint64_t evmQueueId,
+                                                   bool enabled)
+    : block(block),
+      height(height),
+      time(time),
+      consensus(consensus),
+      evmQueueId(evmQueueId),
+      enabled(enabled) {
+    if (!enabled) {
+        return;
+    }
+
+    const auto metadataValidation = height >= static_cast<uint32_t>(consensus.FortCanningHeight);
+
+    std::set<uint256> blockTxs;
+    txTypes.reserve(block.vtx.size());
+    results.resize(block.vtx.size());
+
+    size_t candidates{};
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const auto &tx = *block.vtx[i];
+        std::vector<unsigned char> metadata;
+        txTypes.push_back(tx.IsCoinBase() ? CustomTxType::None : GuessCustomTxType(tx, metadata, metadataValidation));
+
+        // txs spending outputs of the same block would see a different coins view
+        auto inBlockInputs = std::any_of(tx.vin.begin(), tx.vin.end(), [&](const CTxIn &in) {
+            return blockTxs.count(in.prevout.hash) > 0;
+        });
+        blockTxs.insert(tx.GetHash());
+
+        if (!inBlockInputs && IsSpeculationAllowed(txTypes.back())) {
+            results[i] = std::make_unique<Result>();
+            ++candidates;
+        }
+    }
+
+    // nothing to run in parallel with
+    this->enabled = candidates > 1;
+}
+
+CDfTxSpeculativeExecutor::~CDfTxSpeculativeExecutor() {
+    if (started) {
+        LogPrint(BCLog::BENCH, "    - DfTx speculation: %d speculated, %d committed, %d re-executed\n",
+                 stats.speculated, stats.committed, stats.reexecuted);
+    }
+}
+
+void CDfTxSpeculativeExecutor::SpeculateTx(Result &result, CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t txn) {
+    auto &writers = mnview.GetHistoryWriters();
+    result.tracker = std::make_unique<CReadTrackingStorageKV>(mnview.GetStorage());
+    if (auto historyView = writers.GetHistoryView()) {
+        result.historyView = std::make_unique<CAccountHistoryStorage>(*historyView);
+    }
+    if (auto burnView = writers.GetBurnView()) {
+        result.burnView = std::make_unique<CBurnHistoryStorage>(*burnView);
+    }
+    if (auto vaultView = writers.GetVaultView()) {
+        result.vaultView = std::make_unique<CVaultHistoryStorage>(*vaultView);
+    }
+    result.view = std::make_unique<CCustomCSView>(
+        *result.tracker, result.historyView.get(), result.burnView.get(), result.vaultView.get());
+
+    CCoinsViewReadTracking coinsTracker(&coins, cs_coins);
+    CCoinsViewCache coinsCache(&coinsTracker);
+
+    try {
+        result.res = ApplyCustomTx(*result.view, coinsCache, *block.vtx[txn], consensus, height, time, nullptr, txn, evmQueueId);
+    } catch (...) {
+        // left to the serial execution
+        result.res.reset();
+    }
+    result.coinReads = coinsTracker.GetReads();
+}
+
+void CDfTxSpeculativeExecutor::Speculate(CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t firstTxn) {
+    started = true;
+    trackedTxn = firstTxn;
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = firstTxn; i < results.size(); ++i) {
+        if (results[i]) {
+            candidates.push_back(i);
+        }
+    }
+    stats.speculated += candidates.size();
+
+    if (!DfTxTaskPool) {
+        for (const auto txn : candidates) {
+            SpeculateTx(*results[txn], mnview, coins, txn);
+        }
+        return;
+    }
+
+    DfTxTaskPool->ParallelFor(0, candidates.size(), {"DfTx speculation"}, [&](size_t i, size_t) {
+        const auto txn = candidates[i];
+        SpeculateTx(*results[txn], mnview, coins, txn);
+    });
+}
+
+void CDfTxSpeculativeExecutor::TrackCoinsUpTo(uint32_t txn) {
+    for (; trackedTxn < txn; ++trackedTxn) {
+        const auto &tx = *block.vtx[trackedTxn];
+        for (const auto &in : tx.vin) {
+            spent.insert(in.prevout);
+        }
+        created.insert(tx.GetHash());
+    }
+}
+
+bool CDfTxSpeculativeExecutor::Conflicts(const Result &result) const {
+    if (!result.res) {
+        return true;
+    }
+    for (const auto &outpoint : result.coinReads) {
+        if (spent.count(outpoint) || created.count(outpoint.hash)) {
+            return true;
+        }
+    }
+    return result.tracker->Intersects(written);
+}
+
+Res CDfTxSpeculativeExecutor::Commit(Result &result, CCustomCSView &mnview) {
+    auto &storage = mnview.GetStorage();
+    for (const auto &[key, value] : result.view->GetStorage().GetRaw()) {
+        auto &rawKey = *written.emplace(key.begin(), key.end()).first;
+        if (value) {
+            storage.Write(rawKey, TBytes(value->begin(), value->end()));
+        } else {
+            storage.Erase(rawKey);
+        }
+    }
+    if (result.historyView) {
+        result.historyView->Flush();
+    }
+    if (result.burnView) {
+        result.burnView->Flush();
+    }
+    if (result.vaultView) {
+        result.vaultView->Flush();
+    }
+    return *result.res;
+}
+
+Res CDfTxSpeculativeExecutor::Apply(CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t txn) {
+    const auto &tx = *block.vtx[txn];
+    if (!enabled) {
+        return ApplyCustomTx(mnview, coins, tx, consensus, height, time, nullptr, txn, evmQueueId);
+    }
+
+    if (!started) {
+        Speculate(mnview, coins, txn);
+    }
+    TrackCoinsUpTo(txn);
+
+    auto &result = results[txn];
+    if (result && !Conflicts(*result)) {
+        ++stats.committed;
+        auto res = Commit(*result, mnview);
+        result.reset();
+        return res;
+    }
+    if (result) {
+        ++stats.reexecuted;
+        result.reset();
+    }
+
+    if (txTypes[txn] == CustomTxType::None) {
+        return ApplyCustomTx(mnview, coins, tx, consensus, height, time, nullptr, txn, evmQueueId);
+    }
+
+    // serial execution on a layer of its own to learn what it writes
+    CCustomCSView view(mnview);
+    auto res = ApplyCustomTx(view, coins, tx, consensus, height, time, nullptr, txn, evmQueueId);
+    for (const auto &[key, value] : view.GetStorage().GetRaw()) {
+        written.emplace(key.begin(), key.end());
+    }
+    view.Flush();
+    return res;
+}
+
+void CMempoolDfTxTracker::BlockChanged(const std::vector<CTransactionRef> &vtx, const CKVWriteBuffer &writes) {
+    for (const auto &[key, value] : writes) {
+        changed.emplace(key.begin(), key.end());
+    }
+    for (const auto &tx : vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const auto &in : tx->vin) {
+                spent.insert(in.prevout);
+            }
+        }
+        changedTxs.insert(tx->GetHash());
+    }
+}
+
+void CMempoolDfTxTracker::Changed(const Effects &txEffects) {
+    for (const auto &[key, value] : txEffects.writes) {
+        changed.insert(key);
+    }
+}
+
+void CMempoolDfTxTracker::TxRemoved(const uint256 &txid) {
+    auto it = effects.find(txid);
+    if (it == effects.end()) {
+        return;
+    }
+    // its writes are gone from the view as well as its outputs
+    Changed(it->second);
+    changedTxs.insert(txid);
+    effects.erase(it);
+}
+
+void CMempoolDfTxTracker::Reset() {
+    effects.clear();
+    changed.clear();
+    spent.clear();
+    changedTxs.clear();
+    unknownChanges = false;
+}
+
+bool CMempoolDfTxTracker::Conflicts(const Effects &txEffects, uint32_t height) const {
+    if (unknownChanges || !txEffects.replayable || !txEffects.res) {
+        return true;
+    }
+    // balance changes accrue the owners' pool rewards up to the height, next to any fork checks
+    if (txEffects.height != height) {
+        return true;
+    }
+    for (const auto &outpoint : txEffects.coinReads) {
+        if (spent.count(outpoint) || changedTxs.count(outpoint.hash)) {
+            return true;
+        }
+    }
+    return txEffects.reads.Intersects(changed);
+}
+
+static void ReplayWrites(CCustomCSView &view, const std::vector<std::pair<TBytes, std::optional<TBytes>>> &writes) {
+    auto &storage = view.GetStorage();
+    for (const auto &[key, value] : writes) {
+        if (value) {
+            storage.Write(key, *value);
+        } else {
+            storage.Erase(key);
+        }
+    }
+}
+
+Res CMempoolDfTxTracker::Apply(CCustomCSView &view, CCoinsViewCache &coins, const CTransaction &tx, const Consensus::Params &consensus, uint32_t height) {
+    const auto &txid = tx.GetHash();
+    auto it = effects.find(txid);
+    if (it != effects.end() && !Conflicts(it->second, height)) {
+        ++stats.replayed;
+        ReplayWrites(view, it->second.writes);
+        return *it->second.res;
+    }
+    ++stats.reapplied;
+    if (it != effects.end()) {
+        // the writes replaced by this application may differ
+        Changed(it->second);
+        effects.erase(it);
+    } else {
+        unknownChanges = true;
+    }
+
+    std::vector<unsigned char> metadata;
+    const auto metadataValidation = height >= static_cast<uint32_t>(consensus.FortCanningHeight);
+    const auto replayable = IsSpeculationAllowed(GuessCustomTxType(tx, metadata, metadataValidation));
+
+    CReadTrackingStorageKV tracker(view.GetStorage());
+    CCustomCSView txView(tracker);
+    CCoinsViewReadTracking coinsTracker(&coins, cs_coins);
+    CCoinsViewCache txCoins(&coinsTracker);
+
+    Effects txEffects;
+    txEffects.replayable = replayable;
+    txEffects.height = height;
+    txEffects.res = ApplyCustomTx(txView, txCoins, tx, consensus, height);
+    for (const auto &[key, value] : txView.GetStorage().GetRaw()) {
+        txEffects.writes.emplace_back(TBytes(key.begin(), key.end()),
+                                      value ? std::make_optional<TBytes>(value->begin(), value->end()) : std::nullopt);
+    }
+    ReplayWrites(view, txEffects.writes);
+    Changed(txEffects);
+
+    auto res = *txEffects.res;
+    txEffects.reads = tracker.TakeReads();
+    txEffects.coinReads = coinsTracker.GetReads();
+    effects.emplace(txid, std::move(txEffects));
+    return res;
+}
+
+CMempoolDfTxTracker::Stats CMempoolDfTxTracker::Rebuilt() {
+    changed.clear();
+    spent.clear();
+    changedTxs.clear();
+    unknownChanges = false;
+    return std::exchange(stats, {});
+}
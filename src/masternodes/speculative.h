@@ -0,0 +1,199 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_SPECULATIVE_H
+#define DEFI_MASTERNODES_SPECULATIVE_H
+
+#include <coins.h>
+#include <flushablestorage.h>
+#include <masternodes/masternodes.h>
+#include <masternodes/res.h>
+#include <sync.h>
+
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+class CBlock;
+enum class CustomTxType : uint8_t;
+
+namespace Consensus {
+struct Params;
+}
+
+static const bool DEFAULT_DFTX_SPECULATION = false;
+
+extern bool fDfTxSpeculation;
+
+// Keys and key ranges read through a read tracking layer
+struct CReadSet {
+    struct Range {
+        TBytes begin;
+        TBytes end;
+        bool unbounded{false};
+    };
+
+    std::set<TBytes> keys;
+    std::vector<Range> ranges;
+
+    // Returns true if any of the keys read or any of the ranges iterated contains one of the written keys
+    bool Intersects(const std::set<TBytes> &written) const;
+};
+
+// Key-Value storage layer which records every key and key range read through it.
+// Writes are not expected, a flushable layer is always placed on top of it.
+class CReadTrackingStorageKV : public CStorageKV {
+public:
+    using Range = CReadSet::Range;
+
+    explicit CReadTrackingStorageKV(CStorageKV &db_) : db(db_) {}
+    CReadTrackingStorageKV(const CReadTrackingStorageKV &) = delete;
+    ~CReadTrackingStorageKV() override = default;
+
+    bool Exists(const TBytes &key) const override;
+    bool Write(const TBytes &, const TBytes &) override { return false; }
+    bool Erase(const TBytes &) override { return false; }
+    bool Read(const TBytes &key, TBytes &value) const override;
+    std::unique_ptr<CStorageKVIterator> NewIterator() override;
+    size_t SizeEstimate() const override { return 0; }
+    void Discard() override {}
+    bool Flush() override { return false; }
+    uint64_t PrefixVersion(uint8_t prefix) const override { return db.PrefixVersion(prefix); }
+
+    bool Intersects(const std::set<TBytes> &written) const { return reads.Intersects(written); }
+
+    void AddRange(Range &&range) { reads.ranges.push_back(std::move(range)); }
+    CReadSet TakeReads() { return std::move(reads); }
+
+private:
+    CStorageKV &db;
+    mutable CReadSet reads;
+};
+
+// Coins view which records every outpoint fetched from the shared base view.
+// Base access is serialized, CCoinsViewCache fills its cache even on reads.
+class CCoinsViewReadTracking : public CCoinsViewBacked {
+public:
+    CCoinsViewReadTracking(CCoinsView *viewIn, Mutex &cs) : CCoinsViewBacked(viewIn), cs(cs) {}
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+
+    const std::set<COutPoint> &GetReads() const { return reads; }
+
+private:
+    Mutex &cs;
+    mutable std::set<COutPoint> reads;
+};
+
+// Optimistic executor of a block's custom transactions. Independent DfTxs are applied
+// in parallel on the DfTx pool, each on top of the state preceding the first of them,
+// then committed in block order. A tx that read anything written by a preceding tx,
+// or a coin created or spent since, is re-executed serially instead.
+class CDfTxSpeculativeExecutor {
+public:
+    struct Stats {
+        uint32_t speculated{};
+        uint32_t committed{};
+        uint32_t reexecuted{};
+    };
+
+    CDfTxSpeculativeExecutor(const CBlock &block,
+                             uint32_t height,
+                             uint64_t time,
+                             const Consensus::Params &consensus,
+                             uint64_t evmQueueId,
+                             bool enabled);
+    ~CDfTxSpeculativeExecutor();
+
+    // Drop-in replacement of ApplyCustomTx for the block's tx at position txn.
+    // Has to be called in block order for all non-coinbase transactions.
+    Res Apply(CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t txn);
+
+    const Stats &GetStats() const { return stats; }
+    bool IsEnabled() const { return enabled; }
+
+private:
+    struct Result;
+
+    void Speculate(CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t firstTxn);
+    void SpeculateTx(Result &result, CCustomCSView &mnview, CCoinsViewCache &coins, uint32_t txn);
+    void TrackCoinsUpTo(uint32_t txn);
+    bool Conflicts(const Result &result) const;
+    Res Commit(Result &result, CCustomCSView &mnview);
+
+    const CBlock &block;
+    const uint32_t height;
+    const uint64_t time;
+    const Consensus::Params &consensus;
+    const uint64_t evmQueueId;
+    bool enabled;
+    bool started{false};
+
+    std::vector<CustomTxType> txTypes;
+    std::vector<std::unique_ptr<Result>> results;
+
+    // state changes made since the speculation snapshot
+    std::set<TBytes> written;
+    std::set<COutPoint> spent;
+    std::set<uint256> created;
+    uint32_t trackedTxn{0};
+
+    Mutex cs_coins;
+    Stats stats;
+};
+
+// Dependency tracking of the mempool's accounts view. Remembers what every mempool DfTx
+// read and wrote when it was last applied, so that a rebuild of the view only re-applies
+// the txs which read state changed since then, by blocks or by the txs preceding them.
+// The writes of all others are replayed as they are. Txs applied at another height are
+// all applied again, as their results depend on it.
+class CMempoolDfTxTracker {
+public:
+    struct Stats {
+        uint32_t replayed{};
+        uint32_t reapplied{};
+    };
+
+    // Records the state changed by connecting or disconnecting the block of vtx
+    void BlockChanged(const std::vector<CTransactionRef> &vtx, const CKVWriteBuffer &writes);
+    // Drops the effects of a tx leaving the mempool or failing to apply
+    void TxRemoved(const uint256 &txid);
+    // Forgets all effects, every tx is applied again by the next rebuild
+    void Reset();
+
+    // Drop-in replacement of ApplyCustomTx for the mempool txs in entry order
+    Res Apply(CCustomCSView &view, CCoinsViewCache &coins, const CTransaction &tx, const Consensus::Params &consensus, uint32_t height);
+    // Ends a rebuild, the effects now all relate to the rebuilt view
+    Stats Rebuilt();
+
+private:
+    struct Effects {
+        CReadSet reads;
+        std::set<COutPoint> coinReads;
+        std::vector<std::pair<TBytes, std::optional<TBytes>>> writes;
+        // unknown reads, the tx is always applied again
+        bool replayable{};
+        std::optional<Res> res;
+        uint32_t height{};
+    };
+
+    bool Conflicts(const Effects &effects, uint32_t height) const;
+    void Changed(const Effects &effects);
+
+    std::map<uint256, Effects> effects;
+
+    // state changed since the last rebuild
+    std::set<TBytes> changed;
+    std::set<COutPoint> spent;
+    std::set<uint256> changedTxs;
+    // a tx applied without known previous effects, its earlier writes are unknown
+    bool unknownChanges{false};
+
+    Mutex cs_coins;
+    Stats stats;
+};
+
+#endif  // DEFI_MASTERNODES_SPECULATIVE_H
@@ -0,0 +1,39 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/statediff.h>
+
+#include <chain.h>
+#include <masternodes/undos.h>
+
+bool fDeFiStateDiffs = false;
+
+CDeFiStateDiff CDeFiStateDiff::Construct(const CBlockIndex *pindex, bool connected, const CStorageKV &before, const CKVWriteBuffer &diff) {
+    CDeFiStateDiff result;
+    result.connected = connected;
+    result.height = pindex->nHeight;
+    result.blockHash = pindex->GetBlockHash();
+    if (pindex->pprev) {
+        result.prevBlockHash = pindex->pprev->GetBlockHash();
+    }
+
+    for (const auto &kv : diff) {
+        if (kv.key.size() > 0 && kv.key[0] == CUndosView::ByUndoKey::prefix()) {
+            continue;
+        }
+        CDeFiStateChange change;
+        change.key.assign(kv.key.begin(), kv.key.end());
+        TBytes value;
+        if (before.Read(change.key, value)) {
+            change.before = std::move(value);
+        }
+        if (kv.value) {
+            change.after = TBytes(kv.value->begin(), kv.value->end());
+        }
+        if (change.before != change.after) {
+            result.changes.push_back(std::move(change));
+        }
+    }
+    return result;
+}
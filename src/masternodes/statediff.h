@@ -0,0 +1,79 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_STATEDIFF_H
+#define DEFI_MASTERNODES_STATEDIFF_H
+
+#include <flushablestorage.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class CBlockIndex;
+
+// Set while the state diffs of connected and disconnected blocks are published
+extern bool fDeFiStateDiffs;
+
+// A consensus state record a block changed, keys start with the prefix tag of their view
+struct CDeFiStateChange {
+    TBytes key;
+    // nullopt if the record did not exist before or does not exist after the block
+    std::optional<TBytes> before;
+    std::optional<TBytes> after;
+
+    // a byte flagging which values follow the key
+    template <typename Stream>
+    void Serialize(Stream &s) const {
+        s << static_cast<uint8_t>((before ? 1 : 0) | (after ? 2 : 0)) << key;
+        if (before) {
+            s << *before;
+        }
+        if (after) {
+            s << *after;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream &s) {
+        uint8_t flags;
+        s >> flags >> key;
+        before.reset();
+        after.reset();
+        if (flags & 1) {
+            s >> before.emplace();
+        }
+        if (flags & 2) {
+            s >> after.emplace();
+        }
+    }
+};
+
+// Changes connecting or disconnecting a block made to the consensus state, in key order.
+// A disconnect carries the changes of its block reversed, the block's own undo records
+// are left out as their contents are the before values.
+struct CDeFiStateDiff {
+    bool connected{};
+    int32_t height{};
+    uint256 blockHash;
+    uint256 prevBlockHash;
+    std::vector<CDeFiStateChange> changes;
+
+    static CDeFiStateDiff Construct(const CBlockIndex *pindex, bool connected, const CStorageKV &before, const CKVWriteBuffer &diff);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(connected);
+        READWRITE(height);
+        READWRITE(blockHash);
+        READWRITE(prevBlockHash);
+        READWRITE(changes);
+    }
+};
+
+#endif  // DEFI_MASTERNODES_STATEDIFF_H
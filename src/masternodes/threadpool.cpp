@@ -1,13 +1,180 @@
 #include <masternodes/threadpool.h>
 
 #include <logging.h>
+#include <shutdown.h>
 #include <util/system.h>
+#include <util/time.h>
 
+#define MILLI 0.001
 
-TaskPool::TaskPool(size_t size): pool{size}, size{size} {}
+// index of the scheduler worker running on this thread, if any
+static thread_local const TaskScheduler *currentScheduler{nullptr};
+static thread_local size_t currentWorker{0};
 
-void TaskPool::Shutdown() {
-    pool.wait();
+TaskScheduler::TaskScheduler(size_t size) {
+    queues.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    threads.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        threads.emplace_back([this, i] { WorkerThread(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    Shutdown();
+}
+
+void TaskScheduler::Shutdown() {
+    {
+        std::unique_lock l{wakeMutex};
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto &thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads.clear();
+}
+
+size_t TaskScheduler::CurrentSlot() const {
+    return currentScheduler == this ? currentWorker : queues.size();
+}
+
+void TaskScheduler::Post(std::function<void()> task) {
+    // workers keep their own tasks local, outside posts are spread round robin
+    auto index = currentScheduler == this ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        auto &queue = *queues[index];
+        std::unique_lock l{queue.m};
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::unique_lock l{wakeMutex};
+        ++pending;
+    }
+    wakeCv.notify_one();
+}
+
+bool TaskScheduler::RunQueued(size_t worker) {
+    std::function<void()> task;
+    // newest own task first, then the oldest of the others
+    for (size_t i = 0; i < queues.size() && !task; ++i) {
+        auto &queue = *queues[(worker + i) % queues.size()];
+        std::unique_lock l{queue.m};
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    {
+        std::unique_lock l{wakeMutex};
+        --pending;
+    }
+    task();
+    return true;
+}
+
+void TaskScheduler::WorkerThread(size_t worker) {
+    currentScheduler = this;
+    currentWorker = worker;
+    while (true) {
+        if (RunQueued(worker)) {
+            continue;
+        }
+        std::unique_lock l{wakeMutex};
+        wakeCv.wait(l, [&] { return stopping || pending > 0; });
+        if (stopping && pending <= 0) {
+            return;
+        }
+    }
+}
+
+void TaskScheduler::RunChunks(Loop &loop, size_t slot) {
+    while (true) {
+        const auto chunk = loop.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= loop.chunks) {
+            return;
+        }
+        if (loop.options.cancelOnShutdown && ShutdownRequested()) {
+            loop.cancelled.store(true);
+        }
+        if (!loop.cancelled.load()) {
+            const auto start = GetTimeMicros();
+            try {
+                loop.run(chunk, slot);
+            } catch (...) {
+                std::unique_lock l{loop.m};
+                if (!loop.error) {
+                    loop.error = std::current_exception();
+                }
+                loop.cancelled.store(true);
+            }
+            const auto elapsed = GetTimeMicros() - start;
+            loop.busyMicros.fetch_add(elapsed, std::memory_order_relaxed);
+            auto max = loop.maxChunkMicros.load(std::memory_order_relaxed);
+            while (elapsed > max && !loop.maxChunkMicros.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {
+            }
+        }
+        if (loop.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::unique_lock l{loop.m};
+            loop.cv.notify_all();
+        }
+    }
+}
+
+bool TaskScheduler::Run(const std::shared_ptr<Loop> &loop) {
+    const auto start = GetTimeMicros();
+
+    // late helpers only find the chunks exhausted, the loop state is kept alive for them
+    auto helpers = std::min(queues.size(), loop->chunks - 1);
+    if (loop->options.maxParallelism > 0) {
+        helpers = std::min(helpers, loop->options.maxParallelism - 1);
+    }
+    for (size_t i = 0; i < helpers; ++i) {
+        Post([this, loop] { RunChunks(*loop, CurrentSlot()); });
+    }
+    RunChunks(*loop, CurrentSlot());
+    {
+        std::unique_lock l{loop->m};
+        loop->cv.wait(l, [&] { return loop->remaining.load() == 0; });
+    }
+
+    const auto wallMicros = GetTimeMicros() - start;
+    {
+        std::unique_lock l{statsMutex};
+        auto &entry = stats[loop->options.name];
+        ++entry.runs;
+        entry.chunks += loop->chunks;
+        entry.wallMicros += wallMicros;
+        entry.busyMicros += loop->busyMicros.load();
+        entry.maxChunkMicros = std::max(entry.maxChunkMicros, loop->maxChunkMicros.load());
+    }
+    LogPrint(BCLog::BENCH, "    - %s: %d chunks on %d threads, %.2fms (busy %.2fms)%s\n",
+             loop->options.name, loop->chunks, helpers + 1, wallMicros * MILLI, loop->busyMicros.load() * MILLI,
+             loop->cancelled.load() ? ", cancelled" : "");
+
+    if (loop->error) {
+        std::rethrow_exception(loop->error);
+    }
+    return !loop->cancelled.load();
+}
+
+std::map<std::string, TaskTimingStats> TaskScheduler::GetTimingStats() const {
+    std::unique_lock l{statsMutex};
+    return stats;
 }
 
 void InitDfTxGlobalTaskPool() {
@@ -18,7 +185,7 @@ void InitDfTxGlobalTaskPool() {
         threadPoolThreads = std::max(1, n);
     }
     LogPrintf("DfTxTaskPool: Size: %d\n", threadPoolThreads);
-    DfTxTaskPool = std::make_unique<TaskPool>(static_cast<size_t>(threadPoolThreads));
+    DfTxTaskPool = std::make_unique<TaskScheduler>(static_cast<size_t>(threadPoolThreads));
 }
 
 void ShutdownDfTxGlobalTaskPool() {
@@ -29,21 +196,4 @@ void ShutdownDfTxGlobalTaskPool() {
     LogPrintf("DfTxTaskPool: Shutdown\n");
 }
 
-
-void TaskGroup::AddTask() { 
-    tasks.fetch_add(1, std::memory_order_release);
-}
-
-void TaskGroup::RemoveTask() {
-    if (tasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-        cv.notify_all();
-    }
-}
-
-void TaskGroup::WaitForCompletion(bool checkForPrematureCompletion) {
-    if (checkForPrematureCompletion && tasks.load() == 0) return;
-    std::unique_lock<std::mutex> l(cv_m);
-    cv.wait(l, [&] { return tasks.load() == 0; });
-}
-
-std::unique_ptr<TaskPool> DfTxTaskPool;
+std::unique_ptr<TaskScheduler> DfTxTaskPool;
@@ -1,80 +1,160 @@
 #ifndef DEFI_MASTERNODES_THREADPOOL_H
 #define DEFI_MASTERNODES_THREADPOOL_H
 
-#include <boost/asio.hpp>
+#include <sync.h>
+
 #include <atomic>
 #include <condition_variable>
-#include <sync.h>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 static const int DEFAULT_DFTX_WORKERS=0;
 
-// Until C++20x concurrency impls make it into standard, std::future and std::async impls
-// doesn't have the primitives needed for working with many at the same time efficiently
-// So, for now, we use a queue based approach for the thread pool
-
-// Simple boost thread pool with N threads that's kept around for now
-// Additionally, later task pool can abstract task group entirely, by
-// forwarding the post args into Post method of a child group created
-// from the TaskPool
+// Accumulated timings of the parallel loops run under one name
+struct TaskTimingStats {
+    uint64_t runs{};
+    uint64_t chunks{};
+    int64_t wallMicros{};
+    int64_t busyMicros{};
+    int64_t maxChunkMicros{};
+};
 
-class TaskPool {
+// Thread confined state of a parallel loop, e.g. partial results, one per worker slot.
+// A slot is only ever touched by the thread running as that worker, so no locking is needed.
+template <typename T>
+class WorkerBuffers {
     public:
-        explicit TaskPool(size_t size);
-        void Shutdown();
-        [[nodiscard]] size_t GetAvailableThreads() const { return size; }
-        boost::asio::thread_pool pool;
+    explicit WorkerBuffers(size_t slots) : slots(slots) {}
 
-    private:
-        size_t size;
-};
-
-void InitDfTxGlobalTaskPool();
-void ShutdownDfTxGlobalTaskPool();
+    T &Get(size_t slot) { return slots[slot].value; }
 
-class TaskGroup {
-    public:
-        void AddTask();
-        void RemoveTask();
-        void WaitForCompletion(bool checkForPrematureCompletion = true);
-        void MarkCancellation() { is_cancelled.store(true); }
-        bool IsCancelled() { return is_cancelled.load(); }
+    template <typename F>
+    void ForEach(F &&f) {
+        for (auto &slot : slots) {
+            f(slot.value);
+        }
+    }
 
     private:
-        std::atomic<uint64_t> tasks{0};
-        std::mutex cv_m;
-        std::condition_variable cv;
-        std::atomic_bool is_cancelled{false};
+    // own cache line per slot, neighbours get written concurrently
+    struct alignas(64) Slot {
+        T value{};
+    };
+    std::vector<Slot> slots;
 };
 
-template <typename T>
-class BufferPool {
+// Work stealing scheduler of the DfTx related parallel work. Every worker owns a deque it
+// pushes to and pops from at the back, idle workers steal from the front of the others.
+// Parallel loops are split into chunks claimed by the calling thread and by helper tasks
+// posted to the workers, so a loop never waits on a queue and can be nested.
+class TaskScheduler {
     public:
-    explicit BufferPool(size_t size) {
-        pool.reserve(size);
-        for (size_t i = 0; i < size; i++) {
-            pool.push_back(std::make_shared<T>());
-        }
-    }
+        struct LoopOptions {
+            // key of the loop's timing stats
+            const char *name;
+            size_t chunkSize{1};
+            // upper bound of threads running the loop including the caller, 0 for all
+            size_t maxParallelism{0};
+            // skip the chunks not yet started once a shutdown was requested
+            bool cancelOnShutdown{false};
+        };
+
+        explicit TaskScheduler(size_t size);
+        ~TaskScheduler();
+        TaskScheduler(const TaskScheduler &) = delete;
+
+        // Waits for the queued tasks and joins the workers
+        void Shutdown();
 
-    std::shared_ptr<T> Acquire() {
-        std::unique_lock l{m};
-        auto res = pool.back();
-        pool.pop_back();
-        return res;
-    }
+        [[nodiscard]] size_t GetAvailableThreads() const { return queues.size(); }
+        // Slots handed to loop bodies: the workers and the calling thread
+        [[nodiscard]] size_t GetSlotsCount() const { return queues.size() + 1; }
+
+        // Runs body(i, slot) for every i in [begin, end). slot is in [0, GetSlotsCount()) and
+        // unique among the threads running the loop at the same time. Returns false if the loop
+        // was cancelled, rethrows the first exception thrown by the body.
+        template <typename Body>
+        bool ParallelFor(size_t begin, size_t end, const LoopOptions &options, Body &&body) {
+            if (begin >= end) {
+                return true;
+            }
+            auto chunkSize = std::max<size_t>(options.chunkSize, 1);
+            auto loop = std::make_shared<Loop>(options, (end - begin + chunkSize - 1) / chunkSize);
+            loop->run = [&body, begin, end, chunkSize](size_t chunk, size_t slot) {
+                const auto first = begin + chunk * chunkSize;
+                const auto last = std::min(end, first + chunkSize);
+                for (auto i = first; i < last; ++i) {
+                    body(i, slot);
+                }
+            };
+            return Run(loop);
+        }
 
-    void Release(std::shared_ptr<T> res) {
-        std::unique_lock l{m};
-        pool.push_back(res);
-    }
+        // Folds every item into the accumulator of the slot running it.
+        // The partial results are left to the caller to combine.
+        template <typename T, typename Body>
+        WorkerBuffers<T> ParallelReduce(size_t begin, size_t end, const LoopOptions &options, Body &&body) {
+            WorkerBuffers<T> partials(GetSlotsCount());
+            ParallelFor(begin, end, options, [&](size_t i, size_t slot) {
+                body(partials.Get(slot), i);
+            });
+            return partials;
+        }
 
-    std::vector<std::shared_ptr<T>> &GetBuffer() { return pool; }
+        std::map<std::string, TaskTimingStats> GetTimingStats() const;
 
     private:
-    AtomicMutex m{};
-    std::vector<std::shared_ptr<T>> pool;
+        struct Queue {
+            AtomicMutex m;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct Loop {
+            Loop(const LoopOptions &options, size_t chunks) : options(options), chunks(chunks), remaining(chunks) {}
+
+            const LoopOptions options;
+            const size_t chunks;
+            std::function<void(size_t, size_t)> run;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> remaining;
+            std::atomic_bool cancelled{false};
+            std::atomic<int64_t> busyMicros{0};
+            std::atomic<int64_t> maxChunkMicros{0};
+            std::mutex m;
+            std::condition_variable cv;
+            std::exception_ptr error;
+        };
+
+        bool Run(const std::shared_ptr<Loop> &loop);
+        void RunChunks(Loop &loop, size_t slot);
+        void Post(std::function<void()> task);
+        bool RunQueued(size_t worker);
+        void WorkerThread(size_t worker);
+        size_t CurrentSlot() const;
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> nextQueue{0};
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCv;
+        int64_t pending{0};
+        bool stopping{false};
+
+        mutable std::mutex statsMutex;
+        std::map<std::string, TaskTimingStats> stats;
 };
 
-extern std::unique_ptr<TaskPool> DfTxTaskPool;
+void InitDfTxGlobalTaskPool();
+void ShutdownDfTxGlobalTaskPool();
+
+extern std::unique_ptr<TaskScheduler> DfTxTaskPool;
 
 #endif  // DEFI_MASTERNODES_THREADPOOL_H
@@ -204,6 +204,20 @@ Res CTokensView::AddMintedTokens(DCT_ID const &id, const CAmount &amount) {
     return Res::Ok();
 }
 
+Res CTokensView::AddMintedTokens(DCT_ID const &id, const std::vector<CAmount> &amounts) {
+    auto tokenImpl = GetToken(id);
+    Require(tokenImpl, [=]{ return strprintf("token with id %d does not exist!", id.v); });
+
+    for (const auto &amount : amounts) {
+        if (auto resMinted = SafeAdd(tokenImpl->minted, amount)) {
+            tokenImpl->minted = resMinted;
+        }
+    }
+
+    WriteBy<ID>(id, *tokenImpl);
+    return Res::Ok();
+}
+
 Res CTokensView::SubMintedTokens(DCT_ID const &id, const CAmount &amount) {
     auto tokenImpl = GetToken(id);
     Require(tokenImpl, [=]{ return strprintf("token with id %d does not exist!", id.v); });
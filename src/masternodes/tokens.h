@@ -113,7 +113,7 @@ public:
     static const unsigned char DB_TOKEN_LASTID;  // = 'L';
 
     using CTokenImpl = CTokenImplementation;
-    std::optional<CTokenImpl> GetToken(DCT_ID id) const;
+    virtual std::optional<CTokenImpl> GetToken(DCT_ID id) const;
     std::optional<std::pair<DCT_ID, std::optional<CTokensView::CTokenImpl>>> GetToken(const std::string &symbol) const;
     // the only possible type of token (with creationTx) is CTokenImpl
     std::optional<std::pair<DCT_ID, CTokenImpl>> GetTokenByCreationTx(const uint256 &txid) const;
@@ -128,6 +128,9 @@ public:
 
     Res BayfrontFlagsCleanup();
     Res AddMintedTokens(DCT_ID const &id, const CAmount &amount);
+    // Adds the amounts in turn with a single token write, an amount that would overflow
+    // the minted total is left out as its own AddMintedTokens call would fail.
+    Res AddMintedTokens(DCT_ID const &id, const std::vector<CAmount> &amounts);
     Res SubMintedTokens(DCT_ID const &id, const CAmount &amount);
 
     // tags
@@ -5,6 +5,7 @@
 #ifndef DEFI_MASTERNODES_UNDO_H
 #define DEFI_MASTERNODES_UNDO_H
 
+#include <crypto/common.h>
 #include <flushablestorage.h>
 #include <serialize.h>
 #include <serialize_optional.h>
@@ -27,15 +28,16 @@ struct UndoKey {
 struct CUndo {
     MapKV before;
 
-    static CUndo Construct(const CStorageKV &before, const MapKV &diff) {
+    static CUndo Construct(const CStorageKV &before, const CKVWriteBuffer &diff) {
         CUndo result;
+        // diff is walked in key order, every key goes to the end of the map
         for (const auto &kv : diff) {
-            const auto &beforeKey = kv.first;
+            TBytes beforeKey(kv.key.begin(), kv.key.end());
             TBytes beforeVal;
             if (before.Read(beforeKey, beforeVal)) {
-                result.before[beforeKey] = std::move(beforeVal);
+                result.before.emplace_hint(result.before.end(), std::move(beforeKey), std::move(beforeVal));
             } else {
-                result.before[beforeKey] = {};
+                result.before.emplace_hint(result.before.end(), std::move(beforeKey), std::nullopt);
             }
         }
         return result;
@@ -51,12 +53,116 @@ struct CUndo {
         }
     }
 
-    ADD_SERIALIZE_METHODS;
+    // Plain map encoding, the form undos are hashed into the block's merkle root in
+    template <typename Stream>
+    void Serialize(Stream &s) const {
+        s << before;
+    }
 
-    template <typename Stream, typename Operation>
-    inline void SerializationOp(Stream &s, Operation ser_action) {
-        READWRITE(before);
+    // Reads both the plain and the compact encoding
+    template <typename Stream>
+    void Unserialize(Stream &s);
+};
+
+// Encoding undos are stored in. Keys are front coded against the previous key and
+// values of eight bytes, mostly amounts, are written as varints. It starts with the
+// size of an empty map, which is never stored as a plain undo, then the version and
+// the size of the plain encoding.
+struct CCompactUndo {
+    static constexpr uint8_t VERSION = 1;
+    // value tags, erased and raw the same as in the plain optional encoding
+    enum : uint8_t { Erased = 0, Raw = 1, VarInt = 2 };
+
+    const CUndo &undo;
+
+    template <typename Stream>
+    void Serialize(Stream &s) const {
+        WriteCompactSize(s, 0);
+        ser_writedata8(s, VERSION);
+        WriteVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s, GetSerializeSize(undo, s.GetVersion()));
+        WriteCompactSize(s, undo.before.size());
+        const TBytes *prev{nullptr};
+        for (const auto &[key, value] : undo.before) {
+            size_t shared{0};
+            if (prev) {
+                const auto limit = std::min(prev->size(), key.size());
+                while (shared < limit && (*prev)[shared] == key[shared]) {
+                    ++shared;
+                }
+            }
+            WriteCompactSize(s, shared);
+            WriteCompactSize(s, key.size() - shared);
+            s.write(reinterpret_cast<const char *>(key.data() + shared), key.size() - shared);
+            prev = &key;
+
+            if (!value) {
+                ser_writedata8(s, Erased);
+            } else if (value->size() == 8 && GetSizeOfVarInt<VarIntMode::DEFAULT>(ReadLE64(value->data())) < 9) {
+                ser_writedata8(s, VarInt);
+                WriteVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s, ReadLE64(value->data()));
+            } else {
+                ser_writedata8(s, Raw);
+                s << *value;
+            }
+        }
     }
+
+    // Size of the plain encoding of a stored undo, read from the header only
+    static std::optional<uint64_t> PlainSize(TBytesView stored);
 };
 
+template <typename Stream>
+void CUndo::Unserialize(Stream &s) {
+    before.clear();
+    auto count = ReadCompactSize(s);
+    if (count) {
+        // plain
+        while (count--) {
+            TBytes key;
+            std::optional<TBytes> value;
+            ::Unserialize(s, key);
+            ::Unserialize(s, value);
+            before.emplace_hint(before.end(), std::move(key), std::move(value));
+        }
+        return;
+    }
+    if (s.empty()) {
+        // plain empty map
+        return;
+    }
+
+    if (ser_readdata8(s) != CCompactUndo::VERSION) {
+        throw std::ios_base::failure("unknown undo encoding");
+    }
+    ReadVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s);
+    count = ReadCompactSize(s);
+    TBytes key;
+    while (count--) {
+        const auto shared = ReadCompactSize(s);
+        const auto suffix = ReadCompactSize(s);
+        if (shared > key.size()) {
+            throw std::ios_base::failure("undo key shares more than the previous key");
+        }
+        key.resize(shared + suffix);
+        s.read(reinterpret_cast<char *>(key.data() + shared), suffix);
+
+        std::optional<TBytes> value;
+        switch (ser_readdata8(s)) {
+            case CCompactUndo::Erased:
+                break;
+            case CCompactUndo::Raw:
+                value.emplace();
+                ::Unserialize(s, *value);
+                break;
+            case CCompactUndo::VarInt:
+                value.emplace(8);
+                WriteLE64(value->data(), ReadVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s));
+                break;
+            default:
+                throw std::ios_base::failure("unknown undo value tag");
+        }
+        before.emplace_hint(before.end(), key, std::move(value));
+    }
+}
+
 #endif  // DEFI_MASTERNODES_UNDO_H
@@ -4,13 +4,30 @@
 
 #include <masternodes/undos.h>
 
+CUndoStats undoStats;
+
+std::optional<uint64_t> CCompactUndo::PlainSize(TBytesView stored) {
+    try {
+        SpanReader stream(SER_DISK, CLIENT_VERSION, stored);
+        if (ReadCompactSize(stream) != 0) {
+            return stored.size();
+        }
+        if (ser_readdata8(stream) != VERSION) {
+            return {};
+        }
+        return ReadVarInt<SpanReader, VarIntMode::DEFAULT, uint64_t>(stream);
+    } catch (const std::ios_base::failure &) {
+        return {};
+    }
+}
+
 void CUndosView::ForEachUndo(std::function<bool(const UndoKey &, CLazySerialize<CUndo>)> callback,
                              const UndoKey &start) {
     ForEach<ByUndoKey, UndoKey, CUndo>(callback, start);
 }
 
 Res CUndosView::SetUndo(const UndoKey &key, const CUndo &undo) {
-    WriteBy<ByUndoKey>(key, undo);
+    WriteBy<ByUndoKey>(key, CCompactUndo{undo});
     return Res::Ok();
 }
 
@@ -19,6 +36,46 @@ Res CUndosView::DelUndo(const UndoKey &key) {
     return Res::Ok();
 }
 
+CUndoPruneResult CUndosView::PruneUndos(uint32_t height) {
+    CUndoPruneResult result;
+    std::vector<UndoKey> keys;
+    ForEachUndo([&](const UndoKey &key, CLazySerialize<CUndo> undo) {
+        if (key.height >= height) {
+            return false;
+        }
+        const auto stored = undo.raw();
+        result.bytes += stored.size();
+        result.plainBytes += CCompactUndo::PlainSize(stored).value_or(stored.size());
+        keys.push_back(key);
+        return true;
+    });
+    if (keys.empty()) {
+        return result;
+    }
+    for (const auto &key : keys) {
+        DelUndo(key);
+    }
+    result.records = keys.size();
+    result.firstKey = DbTypeToBytes(std::make_pair(ByUndoKey::prefix(), keys.front()));
+    result.lastKey = DbTypeToBytes(std::make_pair(ByUndoKey::prefix(), keys.back()));
+
+    undoStats.pruned += result.records;
+    undoStats.prunedBytes += result.bytes;
+    undoStats.prunedPlainBytes += result.plainBytes;
+    return result;
+}
+
+void CUndosView::CountWrittenUndos(const CKVWriteBuffer &changes) {
+    for (const auto &kv : changes) {
+        if (kv.key.size() == 0 || kv.key[0] != ByUndoKey::prefix() || !kv.value) {
+            continue;
+        }
+        ++undoStats.written;
+        undoStats.writtenBytes += kv.value->size();
+        undoStats.writtenPlainBytes += CCompactUndo::PlainSize(*kv.value).value_or(kv.value->size());
+    }
+}
+
 std::optional<CUndo> CUndosView::GetUndo(const UndoKey &key) const {
     CUndo val;
     bool ok = ReadBy<ByUndoKey>(key, val);
@@ -9,14 +9,44 @@
 #include <masternodes/res.h>
 #include <masternodes/undo.h>
 
+#include <atomic>
+
+// Undo data of connected blocks since startup, stored and as plain encoded
+struct CUndoStats {
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> writtenBytes{0};
+    std::atomic<uint64_t> writtenPlainBytes{0};
+    std::atomic<uint64_t> pruned{0};
+    std::atomic<uint64_t> prunedBytes{0};
+    std::atomic<uint64_t> prunedPlainBytes{0};
+};
+
+extern CUndoStats undoStats;
+
+struct CUndoPruneResult {
+    uint64_t records{0};
+    uint64_t bytes{0};
+    uint64_t plainBytes{0};
+    // raw key range erased, to compact afterwards
+    TBytes firstKey;
+    TBytes lastKey;
+};
+
 class CUndosView : public virtual CStorageView {
 public:
     void ForEachUndo(std::function<bool(const UndoKey &, CLazySerialize<CUndo>)> callback, const UndoKey &start = {});
 
     std::optional<CUndo> GetUndo(const UndoKey &key) const;
+    // stored in the compact encoding
     Res SetUndo(const UndoKey &key, const CUndo &undo);
     Res DelUndo(const UndoKey &key);
 
+    // Erases the undos below the height, reading only their sizes
+    CUndoPruneResult PruneUndos(uint32_t height);
+
+    // Adds the undos written in a block's changes to the stats
+    static void CountWrittenUndos(const CKVWriteBuffer &changes);
+
     // tags
     struct ByUndoKey {
         static constexpr uint8_t prefix() { return 'u'; }
@@ -5,6 +5,7 @@
 #include <ain_rs_exports.h>
 #include <chain.h>
 #include <masternodes/accountshistory.h>
+#include <masternodes/dftxstats.h>
 #include <masternodes/govvariables/attributes.h>
 #include <masternodes/govvariables/loan_daily_reward.h>
 #include <masternodes/govvariables/lp_daily_dfi_reward.h>
@@ -17,12 +18,15 @@
 #include <masternodes/validation.h>
 #include <masternodes/threadpool.h>
 #include <masternodes/vaulthistory.h>
+#include <masternodes/vaultrisk.h>
 #include <validation.h>
 
 #include <boost/asio.hpp>
 
 #define MILLI 0.001
 
+int nTokenSplitWorkers = DEFAULT_TOKEN_SPLIT_WORKERS;
+
 template<typename GovVar>
 static void UpdateDailyGovVariables(const std::map<CommunityAccountType, uint32_t>::const_iterator& incentivePair, CCustomCSView& cache, int nHeight) {
     if (incentivePair != Params().GetConsensus().newNonUTXOSubsidies.end())
@@ -329,11 +333,30 @@ static void ProcessOracleEvents(const CBlockIndex* pindex, CCustomCSView& cache,
     if (pindex->nHeight < chainparams.GetConsensus().FortCanningHeight) {
         return;
     }
+    // Built as part of a block, disconnecting it drops the index again
+    if (!cache.IsOraclePairIndexBuilt()) {
+        cache.BuildOraclePairIndex();
+    }
     auto blockInterval = cache.GetIntervalBlock();
     if (pindex->nHeight % blockInterval != 0) {
         return;
     }
+
+    std::vector<CFixedIntervalPrice> fixedIntervalPrices;
     cache.ForEachFixedIntervalPrice([&](const CTokenCurrencyPair&, CFixedIntervalPrice fixedIntervalPrice){
+        fixedIntervalPrices.push_back(std::move(fixedIntervalPrice));
+        return true;
+    });
+
+    // pairs are aggregated independently, the view is only read
+    std::vector<ResVal<CAmount>> aggregatePrices(fixedIntervalPrices.size(), Res::Err(""));
+    DfTxTaskPool->ParallelFor(0, fixedIntervalPrices.size(), {"Oracle aggregation", 4}, [&](size_t i, size_t) {
+        const auto& priceFeedId = fixedIntervalPrices[i].priceFeedId;
+        aggregatePrices[i] = GetAggregatePrice(cache, priceFeedId.first, priceFeedId.second, pindex->nTime);
+    });
+
+    for (size_t i = 0; i < fixedIntervalPrices.size(); ++i) {
+        auto& fixedIntervalPrice = fixedIntervalPrices[i];
         // Ensure that we update active and next regardless of state of things
         // And SetFixedIntervalPrice on each evaluation of this block.
 
@@ -355,12 +378,9 @@ static void ProcessOracleEvents(const CBlockIndex* pindex, CCustomCSView& cache,
         fixedIntervalPrice.timestamp = pindex->nTime;
         // Use -1 to indicate empty price
         fixedIntervalPrice.priceRecord[1] = -1;
-        auto aggregatePrice = GetAggregatePrice(cache,
-                                                fixedIntervalPrice.priceFeedId.first,
-                                                fixedIntervalPrice.priceFeedId.second,
-                                                pindex->nTime);
+        const auto& aggregatePrice = aggregatePrices[i];
         if (aggregatePrice) {
-            fixedIntervalPrice.priceRecord[1] = aggregatePrice;
+            fixedIntervalPrice.priceRecord[1] = *aggregatePrice;
         } else {
             LogPrint(BCLog::ORACLE,"ProcessOracleEvents(): No aggregate price available: %s\n", aggregatePrice.msg);
         }
@@ -368,8 +388,7 @@ static void ProcessOracleEvents(const CBlockIndex* pindex, CCustomCSView& cache,
         if (!res) {
             LogPrintf("Error: SetFixedIntervalPrice failed: %s\n", res.msg);
         }
-        return true;
-    });
+    }
 }
 
 std::vector<CAuctionBatch> CollectAuctionBatches(const CVaultAssets& vaultAssets, const TAmounts& collBalances, const TAmounts& loanBalances)
@@ -441,7 +460,7 @@ std::vector<CAuctionBatch> CollectAuctionBatches(const CVaultAssets& vaultAssets
     return batches;
 }
 
-static void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, const CChainParams& chainparams)
+void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, const CChainParams& chainparams)
 {
     if (pindex->nHeight < chainparams.GetConsensus().FortCanningHeight) {
         return;
@@ -492,8 +511,6 @@ static void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, c
     if (pindex->nHeight % chainparams.GetConsensus().blocksCollateralizationRatioCalculation() == 0) {
         bool useNextPrice = false, requireLivePrice = true;
 
-        auto &pool = DfTxTaskPool->pool;
-
         struct VaultWithCollateralInfo {
             CVaultId vaultId;
             CBalances collaterals;
@@ -501,178 +518,200 @@ static void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, c
             CVaultData vault;
         };
 
-        struct LiquidationVaults {
-            public:
-                AtomicMutex m;
-                std::vector<VaultWithCollateralInfo> vaults;
-        };
-        LiquidationVaults lv;
-
-        TaskGroup g;
-
-        const auto markCompleted = [&g] { g.RemoveTask(); };
-
-        cache.ForEachVaultCollateral(
-            [&](const CVaultId &vaultId, const CBalances &collaterals) {
-                g.AddTask();
+        // vaults still above their ratio since the last interval are skipped
+        std::optional<CVaultRiskUpdate> riskUpdate;
+        if (fVaultRiskIndex && pindex->nHeight >= chainparams.GetConsensus().FortCanningGreatWorldHeight) {
+            riskUpdate.emplace(pindex, cache, chainparams);
+        }
 
-                CVaultId vaultIdCopy = vaultId;
-                CBalances collateralsCopy = collaterals;
+        std::vector<std::pair<CVaultId, CBalances>> vaultCollaterals;
+        if (riskUpdate && riskUpdate->IsIncremental()) {
+            for (const auto &vaultId : riskUpdate->GetCandidates()) {
+                if (auto collaterals = cache.GetVaultCollaterals(vaultId)) {
+                    vaultCollaterals.emplace_back(vaultId, std::move(*collaterals));
+                }
+            }
+        } else {
+            cache.ForEachVaultCollateral([&](const CVaultId &vaultId, const CBalances &collaterals) {
+                vaultCollaterals.emplace_back(vaultId, collaterals);
+                return true;
+            });
+        }
 
-                boost::asio::post(pool, [
-                    vaultIdCopy, collateralsCopy,
-                    &cache, pindex,
-                    useNextPrice, requireLivePrice,
-                    &lv, &markCompleted] {
+        struct VaultEvaluations {
+            // vaults to liquidate, tagged with their position in the collateral index
+            std::vector<std::pair<size_t, VaultWithCollateralInfo>> liquidations;
+            std::vector<std::pair<CVaultId, CVaultRiskEntry>> riskEntries;
+        };
 
-                    auto vaultId = vaultIdCopy;
-                    auto collaterals = collateralsCopy;
+        auto found = DfTxTaskPool->ParallelReduce<VaultEvaluations>(
+            0, vaultCollaterals.size(), {"Vault collateralization", 16},
+            [&](VaultEvaluations &evaluations, size_t i) {
+                const auto &[vaultId, collaterals] = vaultCollaterals[i];
 
-                    auto vaultAssets  = cache.GetVaultAssets(
-                        vaultId, collaterals, pindex->nHeight, pindex->nTime, useNextPrice, requireLivePrice);
+                auto vaultAssets  = cache.GetVaultAssets(
+                    vaultId, collaterals, pindex->nHeight, pindex->nTime, useNextPrice, requireLivePrice);
 
-                    if (!vaultAssets) {
-                        markCompleted();
-                        return;
+                if (!vaultAssets) {
+                    // evaluated again next interval, unless it waits for its auctions
+                    if (riskUpdate) {
+                        if (auto vault = cache.GetVault(vaultId); vault && !vault->isUnderLiquidation) {
+                            evaluations.riskEntries.emplace_back(
+                                vaultId, CVaultRiskEntry{collaterals, {}, static_cast<uint32_t>(pindex->nHeight)});
+                        }
                     }
+                    return;
+                }
 
-                    auto vault = cache.GetVault(vaultId);
-                    assert(vault);
+                auto vault = cache.GetVault(vaultId);
+                assert(vault);
 
-                    auto scheme = cache.GetLoanScheme(vault->schemeId);
-                    assert(scheme);
+                auto scheme = cache.GetLoanScheme(vault->schemeId);
+                assert(scheme);
 
-                    if (scheme->ratio <= vaultAssets.val->ratio()) {
-                        // All good, within ratio, nothing more to do.
-                        markCompleted();
-                        return;
+                if (scheme->ratio <= vaultAssets.val->ratio()) {
+                    // All good, within ratio, nothing more to do.
+                    if (riskUpdate) {
+                        evaluations.riskEntries.emplace_back(vaultId,
+                                                             riskUpdate->MakeEntry(vaultId, collaterals, scheme->ratio));
                     }
+                    return;
+                }
 
-                    {
-                        std::unique_lock lock{lv.m};
-                        lv.vaults.push_back(VaultWithCollateralInfo{vaultId, collaterals, vaultAssets, *vault});
-                    }
-                    markCompleted();
-                });
-                return true;
+                evaluations.liquidations.emplace_back(i, VaultWithCollateralInfo{vaultId, collaterals, vaultAssets, *vault});
             });
 
-        g.WaitForCompletion();
+        // liquidate in index order, independent of the workers' scheduling
+        std::vector<std::pair<size_t, VaultWithCollateralInfo>> liquidations;
+        found.ForEach([&](VaultEvaluations &evaluations) {
+            std::move(evaluations.liquidations.begin(), evaluations.liquidations.end(), std::back_inserter(liquidations));
+            if (riskUpdate) {
+                for (auto &[vaultId, entry] : evaluations.riskEntries) {
+                    riskUpdate->Add(vaultId, std::move(entry));
+                }
+            }
+        });
+        std::sort(liquidations.begin(), liquidations.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
 
-        {
-            std::unique_lock lock{lv.m};
-            for (auto &[vaultId, collaterals, vaultAssets, vault]: lv.vaults) {
-
-                // Time to liquidate vault.
-                vault.isUnderLiquidation = true;
-                cache.StoreVault(vaultId, vault);
-                auto loanTokens = cache.GetLoanTokens(vaultId);
-                assert(loanTokens);
-
-                // Get the interest rate for each loan token in the vault, find
-                // the interest value and move it to the totals, removing it from the
-                // vault, while also stopping the vault from accumulating interest
-                // further. Note, however, it's added back so that it's accurate
-                // for auction calculations.
-                CBalances totalInterest;
-                for (auto it = loanTokens->balances.begin(); it != loanTokens->balances.end();) {
-                    const auto &[tokenId, tokenValue] = *it;
-
-                    auto rate = cache.GetInterestRate(vaultId, tokenId, pindex->nHeight);
-                    assert(rate);
-
-                    auto subInterest = TotalInterest(*rate, pindex->nHeight);
-                    if (subInterest > 0) {
-                        totalInterest.Add({tokenId, subInterest});
-                    }
+        // the token valuations are taken before the liquidations write to the view
+        if (riskUpdate) {
+            riskUpdate->Commit();
+        }
 
-                    // Remove loan from the vault
-                    cache.SubLoanToken(vaultId, {tokenId, tokenValue});
+        for (auto &[index, info]: liquidations) {
+            auto &[vaultId, collaterals, vaultAssets, vault] = info;
 
-                    if (const auto token = cache.GetToken("DUSD"); token && token->first == tokenId) {
-                        TrackDUSDSub(cache, {tokenId, tokenValue});
-                    }
+            // Time to liquidate vault.
+            vault.isUnderLiquidation = true;
+            cache.StoreVault(vaultId, vault);
+            auto loanTokens = cache.GetLoanTokens(vaultId);
+            assert(loanTokens);
 
-                    // Remove interest from the vault
-                    cache.DecreaseInterest(pindex->nHeight,
-                                            vaultId,
-                                            vault.schemeId,
-                                            tokenId,
-                                            tokenValue,
-                                            subInterest < 0 || (!subInterest && rate->interestPerBlock.negative)
-                                                ? std::numeric_limits<CAmount>::max()
-                                                : subInterest);
-
-                    // Putting this back in now for auction calculations.
-                    it->second += subInterest;
-
-                    // If loan amount fully negated then remove it
-                    if (it->second < 0) {
-                        TrackNegativeInterest(cache, {tokenId, tokenValue});
-
-                        it = loanTokens->balances.erase(it);
-                    } else {
-                        if (subInterest < 0) {
-                            TrackNegativeInterest(cache, {tokenId, std::abs(subInterest)});
-                        }
+            // Get the interest rate for each loan token in the vault, find
+            // the interest value and move it to the totals, removing it from the
+            // vault, while also stopping the vault from accumulating interest
+            // further. Note, however, it's added back so that it's accurate
+            // for auction calculations.
+            CBalances totalInterest;
+            for (auto it = loanTokens->balances.begin(); it != loanTokens->balances.end();) {
+                const auto &[tokenId, tokenValue] = *it;
 
-                        ++it;
-                    }
+                auto rate = cache.GetInterestRate(vaultId, tokenId, pindex->nHeight);
+                assert(rate);
+
+                auto subInterest = TotalInterest(*rate, pindex->nHeight);
+                if (subInterest > 0) {
+                    totalInterest.Add({tokenId, subInterest});
                 }
 
-                // Remove the collaterals out of the vault.
-                // (Prep to get the auction batches instead)
-                for (const auto &col : collaterals.balances) {
-                    auto tokenId    = col.first;
-                    auto tokenValue = col.second;
-                    cache.SubVaultCollateral(vaultId, {tokenId, tokenValue});
+                // Remove loan from the vault
+                cache.SubLoanToken(vaultId, {tokenId, tokenValue});
+
+                if (const auto token = cache.GetToken("DUSD"); token && token->first == tokenId) {
+                    TrackDUSDSub(cache, {tokenId, tokenValue});
                 }
 
-                auto batches = CollectAuctionBatches(vaultAssets, collaterals.balances, loanTokens->balances);
-
-                // Now, let's add the remaining amounts and store the batch.
-                CBalances totalLoanInBatches{};
-                for (auto i = 0u; i < batches.size(); i++) {
-                    auto &batch = batches[i];
-                    totalLoanInBatches.Add(batch.loanAmount);
-                    auto tokenId  = batch.loanAmount.nTokenId;
-                    auto interest = totalInterest.balances[tokenId];
-                    if (interest > 0) {
-                        auto balance       = loanTokens->balances[tokenId];
-                        auto interestPart  = DivideAmounts(batch.loanAmount.nValue, balance);
-                        batch.loanInterest = MultiplyAmounts(interestPart, interest);
-                        totalLoanInBatches.Sub({tokenId, batch.loanInterest});
+                // Remove interest from the vault
+                cache.DecreaseInterest(pindex->nHeight,
+                                        vaultId,
+                                        vault.schemeId,
+                                        tokenId,
+                                        tokenValue,
+                                        subInterest < 0 || (!subInterest && rate->interestPerBlock.negative)
+                                            ? std::numeric_limits<CAmount>::max()
+                                            : subInterest);
+
+                // Putting this back in now for auction calculations.
+                it->second += subInterest;
+
+                // If loan amount fully negated then remove it
+                if (it->second < 0) {
+                    TrackNegativeInterest(cache, {tokenId, tokenValue});
+
+                    it = loanTokens->balances.erase(it);
+                } else {
+                    if (subInterest < 0) {
+                        TrackNegativeInterest(cache, {tokenId, std::abs(subInterest)});
                     }
-                    cache.StoreAuctionBatch({vaultId, i}, batch);
+
+                    ++it;
                 }
+            }
 
-                // Check if more than loan amount was generated.
-                CBalances balances;
-                for (const auto &[tokenId, amount] : loanTokens->balances) {
-                    if (totalLoanInBatches.balances.count(tokenId)) {
-                        const auto interest =
-                            totalInterest.balances.count(tokenId) ? totalInterest.balances[tokenId] : 0;
-                        if (totalLoanInBatches.balances[tokenId] > amount - interest) {
-                            balances.Add({tokenId, totalLoanInBatches.balances[tokenId] - (amount - interest)});
-                        }
-                    }
+            // Remove the collaterals out of the vault.
+            // (Prep to get the auction batches instead)
+            for (const auto &col : collaterals.balances) {
+                auto tokenId    = col.first;
+                auto tokenValue = col.second;
+                cache.SubVaultCollateral(vaultId, {tokenId, tokenValue});
+            }
+
+            auto batches = CollectAuctionBatches(vaultAssets, collaterals.balances, loanTokens->balances);
+
+            // Now, let's add the remaining amounts and store the batch.
+            CBalances totalLoanInBatches{};
+            for (auto i = 0u; i < batches.size(); i++) {
+                auto &batch = batches[i];
+                totalLoanInBatches.Add(batch.loanAmount);
+                auto tokenId  = batch.loanAmount.nTokenId;
+                auto interest = totalInterest.balances[tokenId];
+                if (interest > 0) {
+                    auto balance       = loanTokens->balances[tokenId];
+                    auto interestPart  = DivideAmounts(batch.loanAmount.nValue, balance);
+                    batch.loanInterest = MultiplyAmounts(interestPart, interest);
+                    totalLoanInBatches.Sub({tokenId, batch.loanInterest});
                 }
+                cache.StoreAuctionBatch({vaultId, i}, batch);
+            }
 
-                // Only store to attributes if there has been a rounding error.
-                if (!balances.balances.empty()) {
-                    TrackLiveBalances(cache, balances, EconomyKeys::BatchRoundingExcess);
+            // Check if more than loan amount was generated.
+            CBalances balances;
+            for (const auto &[tokenId, amount] : loanTokens->balances) {
+                if (totalLoanInBatches.balances.count(tokenId)) {
+                    const auto interest =
+                        totalInterest.balances.count(tokenId) ? totalInterest.balances[tokenId] : 0;
+                    if (totalLoanInBatches.balances[tokenId] > amount - interest) {
+                        balances.Add({tokenId, totalLoanInBatches.balances[tokenId] - (amount - interest)});
+                    }
                 }
+            }
 
-                // All done. Ready to save the overall auction.
-                cache.StoreAuction(vaultId,
-                                    CAuctionData{uint32_t(batches.size()),
-                                                pindex->nHeight + chainparams.GetConsensus().blocksCollateralAuction(),
-                                                cache.GetLoanLiquidationPenalty()});
+            // Only store to attributes if there has been a rounding error.
+            if (!balances.balances.empty()) {
+                TrackLiveBalances(cache, balances, EconomyKeys::BatchRoundingExcess);
+            }
 
-                // Store state in vault DB
-                if (pvaultHistoryDB) {
-                    pvaultHistoryDB->WriteVaultState(cache, *pindex, vaultId, vaultAssets.ratio());
-                }
+            // All done. Ready to save the overall auction.
+            cache.StoreAuction(vaultId,
+                                CAuctionData{uint32_t(batches.size()),
+                                            pindex->nHeight + chainparams.GetConsensus().blocksCollateralAuction(),
+                                            cache.GetLoanLiquidationPenalty()});
+
+            // Store state in vault DB
+            if (pvaultHistoryDB) {
+                pvaultHistoryDB->WriteVaultState(cache, *pindex, vaultId, vaultAssets.ratio());
             }
         }
 
@@ -779,6 +818,20 @@ static void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, c
     view.Flush();
 }
 
+// Pays out settled future swaps with one write per minted token and per balance, the amounts
+// are added in order as separate writes would. Returns whether each payout was added.
+static std::vector<bool> AddFuturesPayouts(CCustomCSView& cache, const std::vector<std::pair<CScript, CTokenAmount>>& payouts)
+{
+    std::map<DCT_ID, std::vector<CAmount>> mintedAmounts;
+    for (const auto& [owner, amount] : payouts) {
+        mintedAmounts[amount.nTokenId].push_back(amount.nValue);
+    }
+    for (const auto& [id, amounts] : mintedAmounts) {
+        cache.AddMintedTokens(id, amounts);
+    }
+    return cache.AddBalancesInBatch(payouts);
+}
+
 static void ProcessFutures(const CBlockIndex* pindex, CCustomCSView& cache, const CChainParams& chainparams)
 {
     if (pindex->nHeight < chainparams.GetConsensus().FortCanningRoadHeight) {
@@ -875,66 +928,117 @@ static void ProcessFutures(const CBlockIndex* pindex, CCustomCSView& cache, cons
     auto burned = attributes->GetValue(burnKey, CBalances{});
     auto minted = attributes->GetValue(mintedKey, CBalances{});
 
-    std::map<CFuturesUserKey, CFuturesUserValue> unpaidContracts;
-    std::set<CFuturesUserKey> deletionPending;
-
-    auto dUsdToTokenSwapsCounter = 0;
-    auto tokenTodUsdSwapsCounter = 0;
-
+    std::vector<std::pair<CFuturesUserKey, CFuturesUserValue>> contracts;
     cache.ForEachFuturesUserValues([&](const CFuturesUserKey& key, const CFuturesUserValue& futuresValues){
+        contracts.emplace_back(key, futuresValues);
+        return true;
+    }, {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
 
-        CAccountsHistoryWriter view(cache, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::FutureSwapExecution));
+    struct FuturesSettlement {
+        std::optional<CTokenAmount> destination;
+        bool toDUSD{};
+        bool refund{};
+    };
+    std::vector<FuturesSettlement> settlements(contracts.size());
 
-        deletionPending.insert(key);
+    // Contracts are settled per source and destination pair, its price is looked up once
+    std::map<std::pair<DCT_ID, uint32_t>, std::vector<size_t>> contractsByPair;
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        const auto& futuresValues = contracts[i].second;
+        contractsByPair[{futuresValues.source.nTokenId, futuresValues.destination}].push_back(i);
+    }
 
-        const auto source = view.GetLoanTokenByID(futuresValues.source.nTokenId);
+    for (const auto& [pair, indexes] : contractsByPair) {
+        const auto& [sourceId, destination] = pair;
+        const auto source = cache.GetLoanTokenByID(sourceId);
         assert(source);
 
         if (source->symbol == "DUSD") {
-            const DCT_ID destId{futuresValues.destination};
-            const auto destToken = view.GetLoanTokenByID(destId);
+            const DCT_ID destId{destination};
+            const auto destToken = cache.GetLoanTokenByID(destId);
             assert(destToken);
-            try {
-                const auto& premiumPrice = futuresPrices.at(destId).premium;
-                if (premiumPrice > 0) {
-                    const auto total = DivideAmounts(futuresValues.source.nValue, premiumPrice);
-                    view.AddMintedTokens(destId, total);
-                    CTokenAmount destination{destId, total};
-                    view.AddBalance(key.owner, destination);
-                    burned.Add(futuresValues.source);
-                    minted.Add(destination);
-                    dUsdToTokenSwapsCounter++;
-                    LogPrint(BCLog::FUTURESWAP, "ProcessFutures (): Owner %s source %s destination %s\n",
-                             key.owner.GetHex(), futuresValues.source.ToString(), destination.ToString());
+            const auto price = futuresPrices.find(destId);
+            if (price == futuresPrices.end()) {
+                for (const auto i : indexes) {
+                    settlements[i].refund = true;
                 }
-            } catch (const std::out_of_range&) {
-                unpaidContracts.emplace(key, futuresValues);
+                continue;
+            }
+            const auto& premiumPrice = price->second.premium;
+            if (premiumPrice <= 0) {
+                continue;
+            }
+            for (const auto i : indexes) {
+                const auto total = DivideAmounts(contracts[i].second.source.nValue, premiumPrice);
+                settlements[i].destination = CTokenAmount{destId, total};
             }
 
         } else {
-            const auto tokenDUSD = view.GetToken("DUSD");
+            const auto tokenDUSD = cache.GetToken("DUSD");
             assert(tokenDUSD);
-
-            try {
-                const auto& discountPrice = futuresPrices.at(futuresValues.source.nTokenId).discount;
-                const auto total = MultiplyAmounts(futuresValues.source.nValue, discountPrice);
-                view.AddMintedTokens(tokenDUSD->first, total);
-                CTokenAmount destination{tokenDUSD->first, total};
-                view.AddBalance(key.owner, destination);
-                burned.Add(futuresValues.source);
-                minted.Add(destination);
-                tokenTodUsdSwapsCounter++;
-                LogPrint(BCLog::FUTURESWAP, "ProcessFutures (): Payment Owner %s source %s destination %s\n",
-                         key.owner.GetHex(), futuresValues.source.ToString(), destination.ToString());
-            } catch (const std::out_of_range&) {
-                unpaidContracts.emplace(key, futuresValues);
+            const auto price = futuresPrices.find(sourceId);
+            if (price == futuresPrices.end()) {
+                for (const auto i : indexes) {
+                    settlements[i].refund = true;
+                }
+                continue;
+            }
+            const auto& discountPrice = price->second.discount;
+            for (const auto i : indexes) {
+                const auto total = MultiplyAmounts(contracts[i].second.source.nValue, discountPrice);
+                settlements[i].destination = CTokenAmount{tokenDUSD->first, total};
+                settlements[i].toDUSD = true;
             }
         }
+    }
 
-        view.Flush();
+    std::vector<std::pair<CScript, CTokenAmount>> payouts;
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        if (const auto& destination = settlements[i].destination) {
+            payouts.emplace_back(contracts[i].first.owner, *destination);
+        }
+    }
+    const auto paid = AddFuturesPayouts(cache, payouts);
 
-        return true;
-    }, {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
+    std::map<CFuturesUserKey, CFuturesUserValue> unpaidContracts;
+
+    auto dUsdToTokenSwapsCounter = 0;
+    auto tokenTodUsdSwapsCounter = 0;
+
+    // history positions are handed out in contract order, as if the contracts were settled one by one
+    auto& writers = cache.GetHistoryWriters();
+    size_t payout{};
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        const auto& [key, futuresValues] = contracts[i];
+        const auto& settlement = settlements[i];
+        const auto txn = GetNextAccPosition();
+
+        if (settlement.refund) {
+            unpaidContracts.emplace(key, futuresValues);
+            continue;
+        }
+        if (!settlement.destination) {
+            continue;
+        }
+
+        const auto& destination = *settlement.destination;
+        if (paid[payout++] && destination.nValue != 0) {
+            writers.AddBalance(key.owner, destination, {});
+        }
+        writers.Flush(pindex->nHeight, pindex->GetBlockHash(), txn, uint8_t(CustomTxType::FutureSwapExecution), {});
+
+        burned.Add(futuresValues.source);
+        minted.Add(destination);
+        if (settlement.toDUSD) {
+            tokenTodUsdSwapsCounter++;
+            LogPrint(BCLog::FUTURESWAP, "ProcessFutures (): Payment Owner %s source %s destination %s\n",
+                     key.owner.GetHex(), futuresValues.source.ToString(), destination.ToString());
+        } else {
+            dUsdToTokenSwapsCounter++;
+            LogPrint(BCLog::FUTURESWAP, "ProcessFutures (): Owner %s source %s destination %s\n",
+                     key.owner.GetHex(), futuresValues.source.ToString(), destination.ToString());
+        }
+    }
 
     const auto contractAddressValue = GetFutureSwapContractAddress(SMART_CONTRACT_DFIP_2203);
     assert(contractAddressValue);
@@ -961,7 +1065,7 @@ static void ProcessFutures(const CBlockIndex* pindex, CCustomCSView& cache, cons
         balances.Sub(value.source);
     }
 
-    for (const auto& key : deletionPending) {
+    for (const auto& [key, value] : contracts) {
         cache.EraseFuturesUserValues(key);
     }
 
@@ -1156,51 +1260,115 @@ size_t RewardConsolidationWorkersCount() {
 // in lower versions of gcc or across clang.
 void ConsolidateRewards(CCustomCSView &view, int height,
                         const std::vector<std::pair<CScript, CAmount>> &items, bool interruptOnShutdown, int numWorkers) {
-    int nWorkers = numWorkers < 1 ? RewardConsolidationWorkersCount() : numWorkers;
+    size_t nWorkers = numWorkers < 1 ? RewardConsolidationWorkersCount() : numWorkers;
     auto rewardsTime = GetTimeMicros();
-    boost::asio::thread_pool workerPool(nWorkers);
-    boost::asio::thread_pool mergeWorker(1);
-    std::atomic<uint64_t> tasksCompleted{0};
-    std::atomic<uint64_t> reportedTs{0};
-
-    for (auto& [owner, amount] : items) {
-        // See https://github.com/DeFiCh/ain/pull/1291
-        // https://github.com/DeFiCh/ain/pull/1291#issuecomment-1137638060
-        // Technically not fully synchronized, but avoid races
-        // due to the segregated areas of operation.
-        boost::asio::post(workerPool, [&, &account = owner]() {
-            if (interruptOnShutdown && ShutdownRequested()) return;
-            auto tempView = std::make_unique<CCustomCSView>(view);
-            tempView->CalculateOwnerRewards(account, height);
-
-            boost::asio::post(mergeWorker, [&, tempView = std::move(tempView)]() {
-                if (interruptOnShutdown && ShutdownRequested()) return;
+    int64_t reportedTs{0};
+    size_t itemsCompleted{0};
+
+    // Owners' rewards are calculated in parallel on views of their own, then merged in
+    // batches while no worker reads the shared view.
+    constexpr size_t batchSize = 4096;
+    std::vector<std::unique_ptr<CCustomCSView>> tempViews;
+    for (size_t batchBegin = 0; batchBegin < items.size(); batchBegin += batchSize) {
+        const auto batchEnd = std::min(items.size(), batchBegin + batchSize);
+        tempViews.clear();
+        tempViews.resize(batchEnd - batchBegin);
+
+        auto completed = DfTxTaskPool->ParallelFor(batchBegin, batchEnd,
+            {"Reward consolidation", 16, nWorkers, interruptOnShutdown},
+            [&](size_t i, size_t) {
+                auto tempView = std::make_unique<CCustomCSView>(view);
+                tempView->CalculateOwnerRewards(items[i].first, height);
+                tempViews[i - batchBegin] = std::move(tempView);
+            });
+
+        for (auto &tempView : tempViews) {
+            if (tempView) {
                 tempView->Flush();
+                ++itemsCompleted;
+            }
+        }
+        if (!completed) {
+            break;
+        }
 
-                // This entire block is already serialized with single merge worker.
-                // So, relaxed ordering is more than sufficient - don't even need
-                // atomics really.
-                auto itemsCompleted = tasksCompleted.fetch_add(1,
-                                                               std::memory_order::memory_order_relaxed);
-                const auto logTimeIntervalMillis = 3 * 1000;
-                if (GetTimeMillis() - reportedTs > logTimeIntervalMillis) {
-                    LogPrintf("Reward consolidation: %.2f%% completed (%d/%d)\n",
-                              (itemsCompleted * 1.f / items.size()) * 100.0,
-                              itemsCompleted, items.size());
-                    reportedTs.store(GetTimeMillis(),
-                                     std::memory_order::memory_order_relaxed);
-                }
-            });
-        });
+        const auto logTimeIntervalMillis = 3 * 1000;
+        if (GetTimeMillis() - reportedTs > logTimeIntervalMillis) {
+            LogPrintf("Reward consolidation: %.2f%% completed (%d/%d)\n",
+                      (itemsCompleted * 1.f / items.size()) * 100.0,
+                      itemsCompleted, items.size());
+            reportedTs = GetTimeMillis();
+        }
     }
-    workerPool.join();
-    mergeWorker.join();
+    tempViews.clear();
 
-    auto itemsCompleted = tasksCompleted.load();
     LogPrintf("Reward consolidation: 100%% completed (%d/%d, time: %dms)\n",
               itemsCompleted, itemsCompleted, MILLI * (GetTimeMicros() - rewardsTime));
 }
 
+// Applies a step of a token split to every item, the items are split into contiguous shards
+// applied in parallel on views of their own. Items must not touch each other's keys, the
+// shards are then merged in item order and the result is the same as applying them serially.
+// Nothing is merged if an item fails, its error is returned.
+template <typename Item, typename Apply>
+static Res ApplyTokenSplitShards(CCustomCSView &view, const char *name, const std::vector<Item> &items, Apply &&apply) {
+    if (items.empty()) {
+        return Res::Ok();
+    }
+    const auto time = GetTimeMicros();
+    int64_t reportedTs{0};
+
+    const size_t workers = nTokenSplitWorkers;
+    const auto threads = workers > 0 ? workers : DfTxTaskPool->GetSlotsCount();
+    // a few shards per thread to even out their cost, small enough to be held in memory per batch
+    const auto shardSize = std::clamp<size_t>(items.size() / (threads * 4), 16, 1024);
+    const auto shards = (items.size() + shardSize - 1) / shardSize;
+    const auto batchShards = threads * 4;
+
+    std::vector<std::unique_ptr<CCustomCSView>> shardViews;
+    std::vector<Res> results;
+    for (size_t batchBegin = 0; batchBegin < shards; batchBegin += batchShards) {
+        const auto batchEnd = std::min(shards, batchBegin + batchShards);
+        shardViews.clear();
+        shardViews.resize(batchEnd - batchBegin);
+        results.assign(batchEnd - batchBegin, Res::Ok());
+
+        DfTxTaskPool->ParallelFor(batchBegin, batchEnd, {name, 1, workers}, [&](size_t shard, size_t) {
+            auto shardView = std::make_unique<CCustomCSView>(view);
+            const auto end = std::min(items.size(), (shard + 1) * shardSize);
+            for (auto i = shard * shardSize; i < end; ++i) {
+                if (auto res = apply(*shardView, items[i]); !res) {
+                    results[shard - batchBegin] = res;
+                    return;
+                }
+            }
+            shardViews[shard - batchBegin] = std::move(shardView);
+        });
+
+        for (const auto &res : results) {
+            if (!res) {
+                return res;
+            }
+        }
+        for (auto &shardView : shardViews) {
+            shardView->Flush();
+        }
+
+        const auto itemsCompleted = std::min(items.size(), batchEnd * shardSize);
+        const auto logTimeIntervalMillis = 3 * 1000;
+        if (GetTimeMillis() - reportedTs > logTimeIntervalMillis) {
+            LogPrintf("%s: %.2f%% completed (%d/%d)\n", name,
+                      (itemsCompleted * 1.f / items.size()) * 100.0,
+                      itemsCompleted, items.size());
+            reportedTs = GetTimeMillis();
+        }
+    }
+
+    LogPrintf("%s: 100%% completed (%d/%d, %d shards, time: %dms)\n", name,
+              items.size(), items.size(), shards, MILLI * (GetTimeMicros() - time));
+    return Res::Ok();
+}
+
 template<typename GovVar>
 static Res UpdateLiquiditySplits(CCustomCSView& view, const DCT_ID oldPoolId, const DCT_ID newPoolId, const uint32_t height) {
     if (auto var = view.GetVariable(GovVar::TypeName())) {
@@ -1220,6 +1388,24 @@ static Res UpdateLiquiditySplits(CCustomCSView& view, const DCT_ID oldPoolId, co
     return Res::Ok();
 }
 
+// Liquidity of an owner moved to the new pool of a token split
+struct PoolShareMigration {
+    CScript owner;
+    // old pool tokens taken from the owner, none from the burn address
+    CAmount subAmount{};
+    CAmount amount{};
+    CAmount amountA{};
+    CAmount amountB{};
+    CAmount liquidity{};
+    bool addLiquidity{};
+};
+
+struct PoolShareOutcome {
+    bool liquidityAdded{};
+    bool refundedA{};
+    bool refundedB{};
+};
+
 static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& attributes, const DCT_ID oldTokenId, const DCT_ID newTokenId,
                       const CBlockIndex* pindex, const CreationTxs& creationTxs, const int32_t multiplier) {
 
@@ -1327,15 +1513,15 @@ static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& at
                 balancesToMigrate.emplace_back(Params().GetConsensus().burnAddress, CAmount{CPoolPair::MINIMUM_LIQUIDITY});
             }
 
+            // The reserves move from owner to owner, so the amounts of every owner are worked
+            // out in order first. Their balances are then changed in shards.
+            std::vector<PoolShareMigration> migrations;
+            migrations.reserve(balancesToMigrate.size());
             for (auto& [owner, amount] : balancesToMigrate) {
+                auto& migration = migrations.emplace_back();
+                migration.owner = owner;
                 if (owner != Params().GetConsensus().burnAddress) {
-                    CAccountsHistoryWriter subView(view, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::TokenSplit));
-
-                    res = subView.SubBalance(owner, CTokenAmount{oldPoolId, amount});
-                    if (!res.ok) {
-                        throw std::runtime_error(strprintf("SubBalance failed: %s", res.msg));
-                    }
-                    subView.Flush();
+                    migration.subAmount = amount;
                 }
 
                 if (oldPoolPair->totalLiquidity < CPoolPair::MINIMUM_LIQUIDITY) {
@@ -1347,6 +1533,7 @@ static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& at
                 if (oldPoolPair->totalLiquidity - amount == CPoolPair::MINIMUM_LIQUIDITY) {
                     amount += CPoolPair::MINIMUM_LIQUIDITY;
                 }
+                migration.amount = amount;
 
                 CAmount resAmountA = (arith_uint256(amount) * oldPoolPair->reserveA / oldPoolPair->totalLiquidity).GetLow64();
                 CAmount resAmountB = (arith_uint256(amount) * oldPoolPair->reserveB / oldPoolPair->totalLiquidity).GetLow64();
@@ -1364,17 +1551,11 @@ static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& at
                     amountB = CalculateNewAmount(multiplier, resAmountB);
                     totalBalance += amountB;
                 }
+                migration.amountA = amountA;
+                migration.amountB = amountB;
 
-                CAccountsHistoryWriter addView(view, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::TokenSplit));
-
-                auto refundBalances = [&, owner = owner]() {
-                    addView.AddBalance(owner, {newPoolPair.idTokenA, amountA});
-                    addView.AddBalance(owner, {newPoolPair.idTokenB, amountB});
-                    addView.Flush();
-                };
-
+                // the owner is refunded the pair's tokens unless liquidity is added
                 if (amountA <= 0 || amountB <= 0 || owner == Params().GetConsensus().burnAddress) {
-                    refundBalances();
                     continue;
                 }
 
@@ -1389,14 +1570,12 @@ static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& at
                     liquidity = std::min(liqA, liqB);
 
                     if (liquidity == 0) {
-                        refundBalances();
                         continue;
                     }
                 }
 
                 auto resTotal = SafeAdd(newPoolPair.totalLiquidity, liquidity);
                 if (!resTotal) {
-                    refundBalances();
                     continue;
                 }
                 newPoolPair.totalLiquidity = resTotal;
@@ -1407,24 +1586,59 @@ static Res PoolSplits(CCustomCSView& view, CAmount& totalBalance, ATTRIBUTES& at
                     newPoolPair.reserveA = resA;
                     newPoolPair.reserveB = resB;
                 } else {
-                    refundBalances();
                     continue;
                 }
 
-                res = addView.AddBalance(owner, {newPoolId, liquidity});
-                if (!res) {
-                    addView.Discard();
-                    refundBalances();
-                    continue;
-                }
-                addView.Flush();
+                migration.liquidity = liquidity;
+                migration.addLiquidity = true;
+            }
 
-                auto oldPoolLogStr = CTokenAmount{oldPoolId, amount}.ToString();
-                auto newPoolLogStr = CTokenAmount{newPoolId, liquidity}.ToString();
-                LogPrint(BCLog::TOKENSPLIT, "TokenSplit: LP (%s: %s => %s)\n",
-                         ScriptToString(owner), oldPoolLogStr, newPoolLogStr);
+            std::vector<PoolShareOutcome> outcomes(migrations.size());
+            res = ApplyTokenSplitShards(view, "Token split: pool shares", migrations,
+                [&, oldPoolId = oldPoolId](CCustomCSView& shardView, const PoolShareMigration& migration) {
+                    auto& outcome = outcomes[&migration - migrations.data()];
+                    if (auto res = shardView.SubBalance(migration.owner, {oldPoolId, migration.subAmount}); !res) {
+                        return Res::Err("SubBalance failed: %s", res.msg);
+                    }
+                    if (migration.addLiquidity && shardView.AddBalance(migration.owner, {newPoolId, migration.liquidity})) {
+                        outcome.liquidityAdded = true;
+                        return shardView.SetShare(newPoolId, migration.owner, pindex->nHeight);
+                    }
+                    outcome.refundedA = shardView.AddBalance(migration.owner, {newPoolPair.idTokenA, migration.amountA}).ok;
+                    outcome.refundedB = shardView.AddBalance(migration.owner, {newPoolPair.idTokenB, migration.amountB}).ok;
+                    return Res::Ok();
+                });
+            if (!res) {
+                throw std::runtime_error(res.msg);
+            }
+
+            // history rows as written by a history writer per balance change
+            auto& writers = view.GetHistoryWriters();
+            for (size_t i = 0; i < migrations.size(); ++i) {
+                const auto& migration = migrations[i];
+                const auto& outcome = outcomes[i];
+                if (migration.owner != Params().GetConsensus().burnAddress) {
+                    writers.SubBalance(migration.owner, {oldPoolId, migration.subAmount}, {});
+                    writers.Flush(pindex->nHeight, pindex->GetBlockHash(), GetNextAccPosition(), uint8_t(CustomTxType::TokenSplit), {});
+                }
 
-                view.SetShare(newPoolId, owner, pindex->nHeight);
+                if (outcome.liquidityAdded) {
+                    if (migration.liquidity != 0) {
+                        writers.AddBalance(migration.owner, {newPoolId, migration.liquidity}, {});
+                    }
+                    LogPrint(BCLog::TOKENSPLIT, "TokenSplit: LP (%s: %s => %s)\n",
+                             ScriptToString(migration.owner),
+                             CTokenAmount{oldPoolId, migration.amount}.ToString(),
+                             CTokenAmount{newPoolId, migration.liquidity}.ToString());
+                } else {
+                    if (outcome.refundedA && migration.amountA != 0) {
+                        writers.AddBalance(migration.owner, {newPoolPair.idTokenA, migration.amountA}, {});
+                    }
+                    if (outcome.refundedB && migration.amountB != 0) {
+                        writers.AddBalance(migration.owner, {newPoolPair.idTokenB, migration.amountB}, {});
+                    }
+                }
+                writers.Flush(pindex->nHeight, pindex->GetBlockHash(), GetNextAccPosition(), uint8_t(CustomTxType::TokenSplit), {});
             }
 
             DCT_ID maxToken{std::numeric_limits<uint32_t>::max()};
@@ -1510,12 +1724,10 @@ static Res VaultSplits(CCustomCSView& view, ATTRIBUTES& attributes, const DCT_ID
         return true;
     });
 
-    for (auto& [vaultId, amount] : loanTokenAmounts) {
-        const auto res = view.SubLoanToken(vaultId, {oldTokenId, amount});
-        if (!res) {
-            return res;
-        }
-    }
+    Require(ApplyTokenSplitShards(view, "Token split: vault loans", loanTokenAmounts,
+        [&](CCustomCSView& shardView, const std::pair<CVaultId, CAmount>& item) {
+            return shardView.SubLoanToken(item.first, {oldTokenId, item.second});
+        }));
 
     CVaultId failedVault;
     std::vector<std::tuple<CVaultId, CInterestRateV3, std::string>> loanInterestRates;
@@ -1553,6 +1765,12 @@ static Res VaultSplits(CCustomCSView& view, ATTRIBUTES& attributes, const DCT_ID
     Require(attributes.Apply(view, height));
     view.SetVariable(attributes);
 
+    Require(ApplyTokenSplitShards(view, "Token split: vault new loans", loanTokenAmounts,
+        [&](CCustomCSView& shardView, const std::pair<CVaultId, CAmount>& item) {
+            return shardView.AddLoanToken(item.first, {newTokenId, CalculateNewAmount(multiplier, item.second)});
+        }));
+
+    // history positions are handed out in vault order, as if the vaults were split one by one
     for (const auto& [vaultId, amount] : loanTokenAmounts) {
         auto newAmount = CalculateNewAmount(multiplier, amount);
 
@@ -1562,8 +1780,6 @@ static Res VaultSplits(CCustomCSView& view, ATTRIBUTES& attributes, const DCT_ID
         LogPrint(BCLog::TOKENSPLIT, "TokenSplit: V Loan (%s: %s => %s)\n",
                  vaultId.ToString(), oldTokenAmount.ToString(), newTokenAmount.ToString());
 
-        Require(view.AddLoanToken(vaultId, newTokenAmount));
-
         if (const auto vault = view.GetVault(vaultId)) {
             VaultHistoryKey subKey{static_cast<uint32_t>(height), vaultId, GetNextAccPosition(), vault->ownerAddress};
             VaultHistoryValue subValue{uint256{}, static_cast<uint8_t>(CustomTxType::TokenSplit), {{oldTokenId, -amount}}};
@@ -1585,40 +1801,43 @@ static Res VaultSplits(CCustomCSView& view, ATTRIBUTES& attributes, const DCT_ID
         return true;
     });
 
-    for (auto& [vaultId, rate, schemeId] : loanInterestRates) {
-        CAmount loanSchemeRate{0};
-        try {
-            loanSchemeRate = loanSchemes.at(schemeId);
-        } catch (const std::out_of_range&) {
-            return Res::Err("Failed to get loan scheme.");
-        }
+    Require(ApplyTokenSplitShards(view, "Token split: vault interest", loanInterestRates,
+        [&](CCustomCSView& shardView, const std::tuple<CVaultId, CInterestRateV3, std::string>& item) -> Res {
+            auto [vaultId, rate, schemeId] = item;
+            CAmount loanSchemeRate{0};
+            try {
+                loanSchemeRate = loanSchemes.at(schemeId);
+            } catch (const std::out_of_range&) {
+                return Res::Err("Failed to get loan scheme.");
+            }
 
-        view.EraseInterest(vaultId, oldTokenId, height);
-        auto oldRateToHeight = rate.interestToHeight;
-        auto newRateToHeight = CalculateNewAmount(multiplier, rate.interestToHeight.amount);
+            shardView.EraseInterest(vaultId, oldTokenId, height);
+            auto oldRateToHeight = rate.interestToHeight;
+            auto newRateToHeight = CalculateNewAmount(multiplier, rate.interestToHeight.amount);
 
-        rate.interestToHeight.amount = newRateToHeight;
+            rate.interestToHeight.amount = newRateToHeight;
 
-        auto oldInterestPerBlock = rate.interestPerBlock;
-        CInterestAmount newInterestRatePerBlock{};
+            auto oldInterestPerBlock = rate.interestPerBlock;
+            CInterestAmount newInterestRatePerBlock{};
 
-        auto amounts = view.GetLoanTokens(vaultId);
-        if (amounts) {
-            newInterestRatePerBlock = InterestPerBlockCalculationV3(amounts->balances[newTokenId], loanToken->interest, loanSchemeRate);
-            rate.interestPerBlock = newInterestRatePerBlock;
-        }
+            auto amounts = shardView.GetLoanTokens(vaultId);
+            if (amounts) {
+                newInterestRatePerBlock = InterestPerBlockCalculationV3(amounts->balances[newTokenId], loanToken->interest, loanSchemeRate);
+                rate.interestPerBlock = newInterestRatePerBlock;
+            }
 
-        if (LogAcceptCategory(BCLog::TOKENSPLIT)) {
-            LogPrint(BCLog::TOKENSPLIT, "TokenSplit: V Interest (%s: %s => %s, %s => %s)\n",
-                     vaultId.ToString(),
-                     GetInterestPerBlockHighPrecisionString(oldRateToHeight),
-                     GetInterestPerBlockHighPrecisionString({oldRateToHeight.negative, newRateToHeight}),
-                     GetInterestPerBlockHighPrecisionString(oldInterestPerBlock),
-                     GetInterestPerBlockHighPrecisionString(newInterestRatePerBlock));
-        }
+            if (LogAcceptCategory(BCLog::TOKENSPLIT)) {
+                LogPrint(BCLog::TOKENSPLIT, "TokenSplit: V Interest (%s: %s => %s, %s => %s)\n",
+                         vaultId.ToString(),
+                         GetInterestPerBlockHighPrecisionString(oldRateToHeight),
+                         GetInterestPerBlockHighPrecisionString({oldRateToHeight.negative, newRateToHeight}),
+                         GetInterestPerBlockHighPrecisionString(oldInterestPerBlock),
+                         GetInterestPerBlockHighPrecisionString(newInterestRatePerBlock));
+            }
 
-        view.WriteInterestRate(std::make_pair(vaultId, newTokenId), rate, rate.height);
-    }
+            shardView.WriteInterestRate(std::make_pair(vaultId, newTokenId), rate, rate.height);
+            return Res::Ok();
+        }));
 
     std::vector<std::pair<CVaultView::AuctionStoreKey, CAuctionBatch>> auctionBatches;
     view.ForEachAuctionBatch([&](const CVaultView::AuctionStoreKey& key, const CAuctionBatch& value) {
@@ -1884,29 +2103,32 @@ static void ProcessTokenSplits(const CBlock& block, const CBlockIndex* pindex, C
             continue;
         }
 
-        try {
-
-            for (const auto& [owner, balances] : balanceUpdates) {
-
-                CAccountsHistoryWriter subView(view, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::TokenSplit));
+        // owners in the order their history positions are handed out
+        const std::vector<std::pair<CScript, std::pair<CTokenAmount, CTokenAmount>>> ownerUpdates(balanceUpdates.begin(), balanceUpdates.end());
 
-                res = subView.SubBalance(owner, balances.second);
-                if (!res) {
-                    throw std::runtime_error(res.msg);
+        res = ApplyTokenSplitShards(view, "Token split: accounts", ownerUpdates,
+            [](CCustomCSView& shardView, const std::pair<CScript, std::pair<CTokenAmount, CTokenAmount>>& item) {
+                const auto& [owner, balances] = item;
+                if (auto res = shardView.SubBalance(owner, balances.second); !res) {
+                    return res;
                 }
-                subView.Flush();
+                return shardView.AddBalance(owner, balances.first);
+            });
+        if (!res) {
+            LogPrintf("Token split failed. %s\n", res.msg);
+            continue;
+        }
 
-                CAccountsHistoryWriter addView(view, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::TokenSplit));
+        // history rows as written by a history writer per balance change
+        auto& writers = view.GetHistoryWriters();
+        for (const auto& [owner, balances] : ownerUpdates) {
+            writers.SubBalance(owner, balances.second, {});
+            writers.Flush(pindex->nHeight, pindex->GetBlockHash(), GetNextAccPosition(), uint8_t(CustomTxType::TokenSplit), {});
 
-                res = addView.AddBalance(owner, balances.first);
-                if (!res) {
-                    throw std::runtime_error(res.msg);
-                }
-                addView.Flush();
+            if (balances.first.nValue != 0) {
+                writers.AddBalance(owner, balances.first, {});
             }
-        } catch (const std::runtime_error& e) {
-            LogPrintf("Token split failed. %s\n", res.msg);
-            continue;
+            writers.Flush(pindex->nHeight, pindex->GetBlockHash(), GetNextAccPosition(), uint8_t(CustomTxType::TokenSplit), {});
         }
 
         res = VaultSplits(view, *attributes, oldTokenId, newTokenId, pindex->nHeight, multiplier);
@@ -2073,35 +2295,45 @@ static void ProcessFuturesDUSD(const CBlockIndex* pindex, CCustomCSView& cache,
     auto burned = attributes->GetValue(burnKey, CBalances{});
     auto minted = attributes->GetValue(mintedKey, CBalances{});
 
-    std::set<CFuturesUserKey> deletionPending;
-
-    auto swapCounter{0};
-
+    std::vector<std::pair<CFuturesUserKey, CAmount>> contracts;
     cache.ForEachFuturesDUSD([&](const CFuturesUserKey& key, const CAmount& amount){
+        contracts.emplace_back(key, amount);
+        return true;
+    }, {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
 
-        CAccountsHistoryWriter view(cache, pindex->nHeight, GetNextAccPosition(), pindex->GetBlockHash(), uint8_t(CustomTxType::FutureSwapExecution));
-
-        deletionPending.insert(key);
+    auto swapCounter{0};
 
-        const auto tokenDUSD = view.GetToken("DUSD");
+    if (!contracts.empty()) {
+        const auto tokenDUSD = cache.GetToken("DUSD");
         assert(tokenDUSD);
 
-        const auto total = MultiplyAmounts(amount, discountPrice);
-        view.AddMintedTokens(tokenDUSD->first, total);
-        CTokenAmount destination{tokenDUSD->first, total};
-        view.AddBalance(key.owner, destination);
-        burned.Add({dfiID, amount});
-        minted.Add(destination);
-        ++swapCounter;
-        LogPrint(BCLog::FUTURESWAP, "ProcessFuturesDUSD (): Payment Owner %s source %d destination %s\n",
-                 key.owner.GetHex(), amount, destination.ToString());
-
-        view.Flush();
+        std::vector<std::pair<CScript, CTokenAmount>> payouts;
+        payouts.reserve(contracts.size());
+        for (const auto& [key, amount] : contracts) {
+            const auto total = MultiplyAmounts(amount, discountPrice);
+            payouts.emplace_back(key.owner, CTokenAmount{tokenDUSD->first, total});
+        }
+        const auto paid = AddFuturesPayouts(cache, payouts);
+
+        // history positions are handed out in contract order, as if the contracts were settled one by one
+        auto& writers = cache.GetHistoryWriters();
+        for (size_t i = 0; i < contracts.size(); ++i) {
+            const auto& [key, amount] = contracts[i];
+            const auto& destination = payouts[i].second;
+            if (paid[i] && destination.nValue != 0) {
+                writers.AddBalance(key.owner, destination, {});
+            }
+            writers.Flush(pindex->nHeight, pindex->GetBlockHash(), GetNextAccPosition(), uint8_t(CustomTxType::FutureSwapExecution), {});
 
-        return true;
-    }, {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
+            burned.Add({dfiID, amount});
+            minted.Add(destination);
+            ++swapCounter;
+            LogPrint(BCLog::FUTURESWAP, "ProcessFuturesDUSD (): Payment Owner %s source %d destination %s\n",
+                     key.owner.GetHex(), amount, destination.ToString());
+        }
+    }
 
-    for (const auto& key : deletionPending) {
+    for (const auto& [key, amount] : contracts) {
         cache.EraseFuturesDUSD(key);
     }
 
@@ -2190,8 +2422,8 @@ static void ProcessProposalEvents(const CBlockIndex* pindex, CCustomCSView& cach
         if (prop.status != CProposalStatusType::Voting) return true;
 
         if (activeMasternodes.empty()) {
-            cache.ForEachMasternode([&](uint256 const & mnId, CMasternode node) {
-                if (node.IsActive(pindex->nHeight, cache) && node.mintedBlocks) {
+            cache.ForEachActiveMasternode(pindex->nHeight, [&](uint256 const & mnId, CMasternodeActivity const & node) {
+                if (node.minted) {
                     activeMasternodes.insert(mnId);
                 }
                 return true;
@@ -2445,14 +2677,30 @@ static void ProcessEVMQueue(const CBlock &block, const CBlockIndex *pindex, CCus
     cache.AddBalance(minerAddress, {DCT_ID{}, static_cast<CAmount>(blockResult.total_priority_fees)});
 }
 
+// Adds the costs of a ProcessDeFiEvent stage to the DfTx stats as "event:<stage>"
+template <typename Process>
+static void ProfileDeFiEvent(const char *stage, CCustomCSView &cache, Process &&process) {
+    CDfTxStatsScope stats(std::string("event:") + stage, cache.GetStorage().GetRaw());
+    process();
+    stats.Stop();
+}
+
 void ProcessDeFiEvent(const CBlock &block, const CBlockIndex* pindex, CCustomCSView& mnview, const CCoinsViewCache& view, const CChainParams& chainparams, const CreationTxs &creationTxs, const uint64_t evmQueueId, std::array<uint8_t, 20>& beneficiary) {
     CCustomCSView cache(mnview);
 
+    // Built as part of a block, disconnecting it drops the index again
+    if (!cache.IsOwnerShareIndexBuilt()) {
+        cache.BuildOwnerShareIndex();
+    }
+    if (!cache.IsMasternodeActivityIndexBuilt()) {
+        cache.BuildMasternodeActivityIndex();
+    }
+
     // calculate rewards to current block
-    ProcessRewardEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("rewards", cache, [&]() { ProcessRewardEvents(pindex, cache, chainparams); });
 
     // close expired orders, refund all expired DFC HTLCs at this block height
-    ProcessICXEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("icx", cache, [&]() { ProcessICXEvents(pindex, cache, chainparams); });
 
     // Remove `Finalized` and/or `LPS` flags _possibly_set_ by bytecoded (cheated) txs before bayfront fork
     if (pindex->nHeight == chainparams.GetConsensus().BayfrontHeight - 1) { // call at block _before_ fork
@@ -2460,47 +2708,47 @@ void ProcessDeFiEvent(const CBlock &block, const CBlockIndex* pindex, CCustomCSV
     }
 
     // burn DFI on Eunos height
-    ProcessEunosEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("eunos", cache, [&]() { ProcessEunosEvents(pindex, cache, chainparams); });
 
     // set oracle prices
-    ProcessOracleEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("oracles", cache, [&]() { ProcessOracleEvents(pindex, cache, chainparams); });
 
     // loan scheme, collateral ratio, liquidations
-    ProcessLoanEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("loans", cache, [&]() { ProcessLoanEvents(pindex, cache, chainparams); });
 
     // Must be before set gov by height to clear futures in case there's a disabling of loan token in v3+
-    ProcessFutures(pindex, cache, chainparams);
+    ProfileDeFiEvent("futures", cache, [&]() { ProcessFutures(pindex, cache, chainparams); });
 
     // update governance variables
-    ProcessGovEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("gov", cache, [&]() { ProcessGovEvents(pindex, cache, chainparams); });
 
     // Migrate loan and collateral tokens to Gov vars.
-    ProcessTokenToGovVar(pindex, cache, chainparams);
+    ProfileDeFiEvent("tokentogov", cache, [&]() { ProcessTokenToGovVar(pindex, cache, chainparams); });
 
     // Loan splits
-    ProcessTokenSplits(block, pindex, cache, creationTxs, chainparams);
+    ProfileDeFiEvent("splits", cache, [&]() { ProcessTokenSplits(block, pindex, cache, creationTxs, chainparams); });
 
     // Set height for live dex data
     if (cache.GetDexStatsEnabled().value_or(false))
         cache.SetDexStatsLastHeight(pindex->nHeight);
 
     // DFI-to-DUSD swaps
-    ProcessFuturesDUSD(pindex, cache, chainparams);
+    ProfileDeFiEvent("futuresdusd", cache, [&]() { ProcessFuturesDUSD(pindex, cache, chainparams); });
 
     // Tally negative interest across vaults
-    ProcessNegativeInterest(pindex, cache);
+    ProfileDeFiEvent("negativeinterest", cache, [&]() { ProcessNegativeInterest(pindex, cache); });
 
     // proposal activations
-    ProcessProposalEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("proposals", cache, [&]() { ProcessProposalEvents(pindex, cache, chainparams); });
 
     // Masternode updates
-    ProcessMasternodeUpdates(pindex, cache, view, chainparams);
+    ProfileDeFiEvent("masternodes", cache, [&]() { ProcessMasternodeUpdates(pindex, cache, view, chainparams); });
 
     // Migrate foundation members to attributes
-    ProcessGrandCentralEvents(pindex, cache, chainparams);
+    ProfileDeFiEvent("grandcentral", cache, [&]() { ProcessGrandCentralEvents(pindex, cache, chainparams); });
 
     // Execute EVM Queue
-    ProcessEVMQueue(block, pindex, cache, chainparams, evmQueueId, beneficiary);
+    ProfileDeFiEvent("evmqueue", cache, [&]() { ProcessEVMQueue(block, pindex, cache, chainparams, evmQueueId, beneficiary); });
 
     // construct undo
     auto& flushable = cache.GetStorage();
@@ -15,9 +15,16 @@ class CCoinsViewCache;
 class CVaultAssets;
 class CCustomCSView;
 
+// Threads a token split is applied on, 0 for all of the DfTx pool, 1 to apply it serially
+static const int DEFAULT_TOKEN_SPLIT_WORKERS = 0;
+
+extern int nTokenSplitWorkers;
+
 using CreationTxs = std::map<uint32_t, std::pair<uint256, std::vector<std::pair<DCT_ID, uint256>>>>;
 
 void ProcessDeFiEvent(const CBlock &block, const CBlockIndex* pindex, CCustomCSView& mnview, const CCoinsViewCache& view, const CChainParams& chainparams, const CreationTxs &creationTxs, const uint64_t evmQueueId, std::array<uint8_t, 20>& beneficiary);
+// Loan scheme changes, vault liquidations at collateralization ratio heights and auction endings
+void ProcessLoanEvents(const CBlockIndex* pindex, CCustomCSView& cache, const CChainParams& chainparams);
 std::vector<CAuctionBatch> CollectAuctionBatches(const CVaultAssets& vaultAssets, const TAmounts& collBalances, const TAmounts& loanBalances);
 
 
@@ -0,0 +1,253 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/vaultrisk.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <logging.h>
+#include <masternodes/masternodes.h>
+#include <masternodes/undo.h>
+
+bool fVaultRiskIndex = DEFAULT_VAULT_RISK_INDEX;
+
+CVaultRiskIndex vaultRiskIndex;
+
+bool CVaultRiskToken::operator==(const CVaultRiskToken &other) const {
+    return collateralFeed == other.collateralFeed && factor == other.factor && loanFeed == other.loanFeed &&
+           collateralPrice == other.collateralPrice && loanPrice == other.loanPrice;
+}
+
+void CVaultRiskState::Add(const CVaultId &vaultId, CVaultRiskEntry &&entry) {
+    Remove(vaultId);
+    bySafeHeight.emplace(entry.safeUntil, vaultId);
+    for (const auto &[id, amount] : entry.collaterals.balances) {
+        byToken[id].insert(vaultId);
+    }
+    for (const auto &[id, amount] : entry.loans.balances) {
+        byToken[id].insert(vaultId);
+    }
+    vaults.emplace(vaultId, std::move(entry));
+}
+
+void CVaultRiskState::Remove(const CVaultId &vaultId) {
+    auto it = vaults.find(vaultId);
+    if (it == vaults.end()) {
+        return;
+    }
+    const auto &entry = it->second;
+    bySafeHeight.erase({entry.safeUntil, vaultId});
+    auto removeFromToken = [&](DCT_ID id) {
+        auto tokenIt = byToken.find(id);
+        if (tokenIt != byToken.end() && tokenIt->second.erase(vaultId) && tokenIt->second.empty()) {
+            byToken.erase(tokenIt);
+        }
+    };
+    for (const auto &[id, amount] : entry.collaterals.balances) {
+        removeFromToken(id);
+    }
+    for (const auto &[id, amount] : entry.loans.balances) {
+        removeFromToken(id);
+    }
+    vaults.erase(it);
+}
+
+std::shared_ptr<const CVaultRiskState> CVaultRiskIndex::Get(const uint256 &blockHash) const {
+    LOCK(cs);
+    auto it = states.find(blockHash);
+    return it != states.end() ? it->second : nullptr;
+}
+
+void CVaultRiskIndex::Set(const uint256 &blockHash, std::shared_ptr<const CVaultRiskState> state) {
+    LOCK(cs);
+    if (!states.count(blockHash)) {
+        order.push_back(blockHash);
+    }
+    states[blockHash] = std::move(state);
+    while (order.size() > maxStates) {
+        states.erase(order.front());
+        order.pop_front();
+    }
+}
+
+// Vault the key is stored under if it is one of the records a vault's valuation is read from
+static std::optional<CVaultId> GetValuationRecordVault(TBytesView key) {
+    static constexpr std::ptrdiff_t keySize = 1 + sizeof(CVaultId);
+    if (key.size() < keySize) {
+        return {};
+    }
+    switch (key[0]) {
+        case CVaultView::VaultKey::prefix():
+        case CVaultView::CollateralKey::prefix():
+        case CLoanView::LoanTokenAmount::prefix():
+        case CLoanView::LoanInterestByVault::prefix():
+        case CLoanView::LoanInterestV2ByVault::prefix():
+        case CLoanView::LoanInterestV3ByVault::prefix():
+            break;
+        default:
+            return {};
+    }
+    CVaultId vaultId;
+    std::copy(key.begin() + 1, key.begin() + keySize, vaultId.begin());
+    return vaultId;
+}
+
+CVaultRiskUpdate::CVaultRiskUpdate(const CBlockIndex *pindex, CCustomCSView &view, const CChainParams &chainparams)
+    : pindex(pindex),
+      view(view),
+      height(pindex->nHeight),
+      horizon(pindex->nHeight +
+              VAULT_RISK_HORIZON_INTERVALS * chainparams.GetConsensus().blocksCollateralizationRatioCalculation()),
+      state(std::make_shared<CVaultRiskState>()) {
+    state->height = height;
+    view.ForEachLoanScheme([&](const std::string &id, const CLoanSchemeData &scheme) {
+        state->schemeRatios.emplace(id, scheme.ratio);
+        return true;
+    });
+
+    const auto interval = chainparams.GetConsensus().blocksCollateralizationRatioCalculation();
+    const auto prevIndex = height >= interval ? pindex->GetAncestor(height - interval) : nullptr;
+    if (!prevIndex) {
+        return;
+    }
+    const auto prev = vaultRiskIndex.Get(prevIndex->GetBlockHash());
+    if (!prev || prev->schemeRatios != state->schemeRatios) {
+        return;
+    }
+    // vault writes are found in the undo data, which is pruned up to the last checkpoint
+    const auto &checkpoints = chainparams.Checkpoints().mapCheckpoints;
+    const auto checkpoint = checkpoints.upper_bound(prev->height);
+    if (checkpoint != checkpoints.end() && checkpoint->first <= static_cast<int>(height)) {
+        return;
+    }
+
+    auto schemeRatios = std::move(state->schemeRatios);
+    *state = *prev;
+    state->height = height;
+    state->schemeRatios = std::move(schemeRatios);
+
+    auto stale = TouchedVaults(prev->height);
+    for (const auto &[id, valuation] : prev->tokens) {
+        const auto holders = state->byToken.find(id);
+        if (holders != state->byToken.end() && GetTokenValuation(id) != valuation) {
+            stale.insert(holders->second.begin(), holders->second.end());
+        }
+    }
+    for (const auto &[safeUntil, vaultId] : state->bySafeHeight) {
+        if (safeUntil >= height) {
+            break;
+        }
+        stale.insert(vaultId);
+    }
+
+    for (const auto &vaultId : stale) {
+        state->Remove(vaultId);
+    }
+    candidates.assign(stale.begin(), stale.end());
+    skipped = state->vaults.size();
+    incremental = true;
+}
+
+std::set<CVaultId> CVaultRiskUpdate::TouchedVaults(uint32_t since) {
+    std::set<CVaultId> vaults;
+    auto addKey = [&](TBytesView key) {
+        if (auto vaultId = GetValuationRecordVault(key)) {
+            vaults.insert(*vaultId);
+        }
+    };
+    // blocks since the last interval, their events included, and the transactions of this block
+    view.ForEachUndo([&](const UndoKey &key, CLazySerialize<CUndo> undo) {
+        if (key.height > height) {
+            return false;
+        }
+        for (const auto &[undoKey, value] : undo.get().before) {
+            addKey(MakeBytesView(undoKey));
+        }
+        return true;
+    }, UndoKey{since, uint256()});
+    // the events of this block so far
+    for (const auto &kv : view.GetStorage().GetRaw()) {
+        addKey(kv.key);
+    }
+    return vaults;
+}
+
+const CVaultRiskToken &CVaultRiskUpdate::GetTokenValuation(DCT_ID id) {
+    auto [it, inserted] = valuations.try_emplace(id);
+    auto &valuation = it->second;
+    if (!inserted) {
+        return valuation;
+    }
+    if (const auto token = view.HasLoanCollateralToken({id, height})) {
+        valuation.collateralFeed = token->fixedIntervalPriceId;
+        valuation.factor = token->factor;
+        if (const auto price = view.GetValidatedIntervalPrice(token->fixedIntervalPriceId, false, true)) {
+            valuation.collateralPrice = *price.val;
+        }
+    }
+    if (const auto token = view.GetLoanTokenByID(id)) {
+        valuation.loanFeed = token->fixedIntervalPriceId;
+        if (const auto price = view.GetValidatedIntervalPrice(token->fixedIntervalPriceId, false, true)) {
+            valuation.loanPrice = *price.val;
+        }
+    }
+    return valuation;
+}
+
+CVaultRiskEntry CVaultRiskUpdate::MakeEntry(const CVaultId &vaultId, const CBalances &collaterals, uint32_t ratio) {
+    CVaultRiskEntry entry{collaterals, {}, height};
+    if (const auto loans = view.GetLoanTokens(vaultId)) {
+        entry.loans = *loans;
+    }
+
+    // Loan values only move one way while all interest accrues with the same sign,
+    // the vault is then above the ratio at every height between two it is above at.
+    int sign{};
+    for (const auto &[id, amount] : entry.loans.balances) {
+        const auto rate = view.GetInterestRate(vaultId, id, height);
+        if (!rate) {
+            return entry;
+        }
+        if (rate->interestPerBlock.amount == 0) {
+            continue;
+        }
+        const auto tokenSign = rate->interestPerBlock.negative ? -1 : 1;
+        if (sign && sign != tokenSign) {
+            return entry;
+        }
+        sign = tokenSign;
+    }
+    // collateral tokens set up by transaction are looked up by their activation height
+    for (const auto &[id, amount] : collaterals.balances) {
+        const auto token = view.HasLoanCollateralToken({id, height});
+        const auto tokenAtHorizon = view.HasLoanCollateralToken({id, horizon});
+        if (!token || !tokenAtHorizon || token->creationTx != tokenAtHorizon->creationTx) {
+            return entry;
+        }
+    }
+
+    const auto vaultAssets = view.GetVaultAssets(vaultId, collaterals, horizon, pindex->nTime);
+    if (vaultAssets && ratio <= vaultAssets.val->ratio()) {
+        entry.safeUntil = horizon;
+    }
+    return entry;
+}
+
+void CVaultRiskUpdate::Add(const CVaultId &vaultId, CVaultRiskEntry &&entry) {
+    state->Add(vaultId, std::move(entry));
+}
+
+void CVaultRiskUpdate::Commit() {
+    state->tokens.clear();
+    for (const auto &[id, holders] : state->byToken) {
+        state->tokens.emplace(id, GetTokenValuation(id));
+    }
+    LogPrint(BCLog::LOAN,
+             "%s: %s evaluation, %d vaults indexed, %d skipped\n",
+             __func__,
+             incremental ? "incremental" : "full",
+             state->vaults.size(),
+             skipped);
+    vaultRiskIndex.Set(pindex->GetBlockHash(), std::move(state));
+}
@@ -0,0 +1,123 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_VAULTRISK_H
+#define DEFI_MASTERNODES_VAULTRISK_H
+
+#include <amount.h>
+#include <masternodes/balances.h>
+#include <masternodes/oracles.h>
+#include <masternodes/vault.h>
+#include <sync.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+class CBlockIndex;
+class CChainParams;
+class CCustomCSView;
+
+// Off until liquidation selection through the index is shown to match a full scan across
+// price, interest and loan scheme changes, it decides which vaults get liquidated
+static const bool DEFAULT_VAULT_RISK_INDEX = false;
+// How many collateralization intervals ahead a vault's ratio is projected
+static const uint32_t VAULT_RISK_HORIZON_INTERVALS = 8;
+
+extern bool fVaultRiskIndex;
+
+// A vault found above its scheme's ratio at its last evaluation
+struct CVaultRiskEntry {
+    CBalances collaterals;
+    CBalances loans;
+    // The vault is known to stay above the ratio up to this height, as long as
+    // neither it, the valuation of its tokens nor the loan schemes change.
+    uint32_t safeUntil{};
+};
+
+// Everything the valuation of a token depends on besides the vault holding it
+struct CVaultRiskToken {
+    std::optional<CTokenCurrencyPair> collateralFeed;
+    CAmount factor{};
+    std::optional<CTokenCurrencyPair> loanFeed;
+    // validated active prices, -1 if not valid
+    CAmount collateralPrice{-1};
+    CAmount loanPrice{-1};
+
+    bool operator==(const CVaultRiskToken &other) const;
+    bool operator!=(const CVaultRiskToken &other) const { return !(*this == other); }
+};
+
+// Vault ratio index as of a collateralization interval block
+struct CVaultRiskState {
+    uint32_t height{};
+    std::map<CVaultId, CVaultRiskEntry> vaults;
+    // vaults in the order they have to be evaluated again
+    std::set<std::pair<uint32_t, CVaultId>> bySafeHeight;
+    std::map<DCT_ID, std::set<CVaultId>> byToken;
+    std::map<DCT_ID, CVaultRiskToken> tokens;
+    std::map<std::string, uint32_t> schemeRatios;
+
+    void Add(const CVaultId &vaultId, CVaultRiskEntry &&entry);
+    void Remove(const CVaultId &vaultId);
+};
+
+// Incremental evaluation of the vaults at one collateralization interval block.
+// Vaults are taken from the state of the previous interval on the same chain: the ones
+// written to since, holding a token whose valuation changed or whose projection expired
+// are evaluated again, all others are still above their ratio. Without a usable state
+// every vault is evaluated.
+class CVaultRiskUpdate {
+public:
+    CVaultRiskUpdate(const CBlockIndex *pindex, CCustomCSView &view, const CChainParams &chainparams);
+
+    [[nodiscard]] bool IsIncremental() const { return incremental; }
+    // Vaults to evaluate in key order, only set if incremental
+    [[nodiscard]] const std::vector<CVaultId> &GetCandidates() const { return candidates; }
+
+    // Entry of a vault found above its scheme's ratio at this height, safeUntil is the
+    // furthest height of the projection horizon it is still above the ratio at.
+    // Thread safe as long as the view is only read.
+    CVaultRiskEntry MakeEntry(const CVaultId &vaultId, const CBalances &collaterals, uint32_t ratio);
+
+    void Add(const CVaultId &vaultId, CVaultRiskEntry &&entry);
+    // Stores the state under the block for the next interval
+    void Commit();
+
+private:
+    std::set<CVaultId> TouchedVaults(uint32_t since);
+    const CVaultRiskToken &GetTokenValuation(DCT_ID id);
+
+    const CBlockIndex *pindex;
+    CCustomCSView &view;
+    const uint32_t height;
+    const uint32_t horizon;
+    bool incremental{false};
+    std::shared_ptr<CVaultRiskState> state;
+    std::vector<CVaultId> candidates;
+    std::map<DCT_ID, CVaultRiskToken> valuations;
+    size_t skipped{};
+};
+
+// Recent states by the hash of their block
+class CVaultRiskIndex {
+public:
+    std::shared_ptr<const CVaultRiskState> Get(const uint256 &blockHash) const;
+    void Set(const uint256 &blockHash, std::shared_ptr<const CVaultRiskState> state);
+
+private:
+    static constexpr size_t maxStates = 4;
+
+    mutable Mutex cs;
+    std::map<uint256, std::shared_ptr<const CVaultRiskState>> states GUARDED_BY(cs);
+    std::deque<uint256> order GUARDED_BY(cs);
+};
+
+extern CVaultRiskIndex vaultRiskIndex;
+
+#endif  // DEFI_MASTERNODES_VAULTRISK_H
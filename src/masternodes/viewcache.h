@@ -0,0 +1,60 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_MASTERNODES_VIEWCACHE_H
+#define DEFI_MASTERNODES_VIEWCACHE_H
+
+#include <flushablestorage.h>
+
+#include <atomic>
+#include <initializer_list>
+#include <map>
+#include <optional>
+
+struct CViewCacheCounters {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+// Process wide hit / miss counters of the views' read caches
+struct CViewCacheStats {
+    CViewCacheCounters attributes;
+    CViewCacheCounters tokens;
+    CViewCacheCounters poolPairs;
+    CViewCacheCounters poolPairGraph;
+};
+
+extern CViewCacheStats viewCacheStats;
+
+// Sum of the storage versions of the key prefixes a cached value is decoded from
+inline uint64_t PrefixesVersion(const CStorageKV &storage, std::initializer_list<uint8_t> prefixes) {
+    uint64_t version{};
+    for (const auto prefix : prefixes) {
+        version += storage.PrefixVersion(prefix);
+    }
+    return version;
+}
+
+// Decoded values tagged with the storage version they were read at.
+// A value read at another version is stale and gets replaced on the next miss.
+template <typename Key, typename Value>
+class CVersionedCache {
+public:
+    std::optional<Value> Get(const Key &key, uint64_t version, CViewCacheCounters &counters) const {
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.first == version) {
+            ++counters.hits;
+            return it->second.second;
+        }
+        ++counters.misses;
+        return {};
+    }
+
+    void Set(const Key &key, uint64_t version, const Value &value) { entries[key] = {version, value}; }
+
+private:
+    std::map<Key, std::pair<uint64_t, Value>> entries;
+};
+
+#endif  // DEFI_MASTERNODES_VIEWCACHE_H
@@ -1104,15 +1104,17 @@ Staker::Status Staker::stake(const CChainParams& chainparams, const ThreadStaker
             pos::Staker::mapMNLastBlockCreationAttemptTs[masternodeID] = GetTime();
         }
         CheckContextState ctxState;
+        const pos::CKernelSearch kernelSearch(stakeModifier, nBits, creationHeight, blockHeight, masternodeID, chainparams.GetConsensus(),
+                subNodesBlockTime, timelock);
+        static const int64_t batchSize = pos::CKernelSearch::BATCH_SIZE;
         // Search backwards in time first
         if (currentTime > lastSearchTime) {
-            for (uint32_t t = 0; t < currentTime - lastSearchTime; ++t) {
+            for (int64_t t = 0; t < currentTime - lastSearchTime; t += batchSize) {
                 if (ShutdownRequested()) break;
 
-                blockTime = ((uint32_t)currentTime - t);
-
-                if (pos::CheckKernelHash(stakeModifier, nBits, creationHeight, blockTime, blockHeight, masternodeID, chainparams.GetConsensus(),
-                        subNodesBlockTime, timelock, ctxState)) {
+                const auto count = std::min(batchSize, currentTime - lastSearchTime - t);
+                if (auto time = kernelSearch.Search((uint32_t)currentTime - t, -1, count, ctxState)) {
+                    blockTime = *time;
                     LogPrintf("MakeStake: kernel found\n");
 
                     found = true;
@@ -1128,13 +1130,12 @@ Staker::Status Staker::stake(const CChainParams& chainparams, const ThreadStaker
             int64_t searchTime = lastSearchTime > currentTime ? lastSearchTime : currentTime;
 
             // Search forwards in time
-            for (uint32_t t = 1; t <= futureTime - searchTime; ++t) {
+            for (int64_t t = 1; t <= futureTime - searchTime; t += batchSize) {
                 if (ShutdownRequested()) break;
 
-                blockTime = ((uint32_t)searchTime + t);
-
-                if (pos::CheckKernelHash(stakeModifier, nBits, creationHeight, blockTime, blockHeight, masternodeID, chainparams.GetConsensus(),
-                        subNodesBlockTime, timelock, ctxState)) {
+                const auto count = std::min(batchSize, futureTime - searchTime - t + 1);
+                if (auto time = kernelSearch.Search((uint32_t)searchTime + t, 1, count, ctxState)) {
+                    blockTime = *time;
                     LogPrint(BCLog::STAKING, "MakeStake: kernel found\n");
 
                     found = true;
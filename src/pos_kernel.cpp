@@ -1,6 +1,8 @@
 #include <pos_kernel.h>
 #include <amount.h>
 #include <arith_uint256.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
 #include <key.h>
 #include <validation.h>
 
@@ -38,7 +40,7 @@ namespace pos {
     }
 
     bool CheckKernelHash(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, int64_t coinstakeTime, uint64_t blockHeight,
-                    const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t> subNodesBlockTime, const uint16_t timelock, CheckContextState& ctxState) {
+                    const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t>& subNodesBlockTime, const uint16_t timelock, CheckContextState& ctxState) {
         // Base target
         arith_uint256 targetProofOfStake;
         targetProofOfStake.SetCompact(nBits);
@@ -78,6 +80,71 @@ namespace pos {
         return (hashProofOfStake / static_cast<uint64_t>( GetMnCollateralAmount( static_cast<int>(creationHeight) ) ) ) <= targetProofOfStake;
     }
 
+    CKernelSearch::CKernelSearch(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, uint64_t blockHeight,
+                                 const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t>& subNodesBlockTime, const uint16_t timelock)
+        : params(params), blockHeight(blockHeight), subNodesBlockTime(subNodesBlockTime) {
+        targetProofOfStake.SetCompact(nBits);
+        const auto collateralAmount = GetMnCollateralAmount(static_cast<int>(creationHeight));
+        collateral = static_cast<uint64_t>(collateralAmount);
+        multi = blockHeight >= static_cast<uint64_t>(params.EunosPayaHeight);
+        loops = !multi ? 1 : timelock == CMasternode::TENYEAR ? 4 : timelock == CMasternode::FIVEYEAR ? 3 : 2;
+
+        CDataStream ss(SER_GETHASH, 0);
+        ss << stakeModifier << int64_t{0} << collateralAmount << masternodeID;
+        if (multi) {
+            ss << uint8_t{0};
+        }
+        preimage.assign(ss.begin(), ss.end());
+    }
+
+    bool CKernelSearch::MeetsTarget(const uint256& hash, int64_t coinstakeTime, uint8_t subNode) const {
+        const auto hashProofOfStake = UintToArith256(hash) / collateral;
+        // subnodes are weighted from EunosPaya on, even where it comes before DakotaCrescent
+        if (multi || blockHeight >= static_cast<uint64_t>(params.DakotaCrescentHeight)) {
+            return hashProofOfStake <= targetProofOfStake * CalcCoinDayWeight(params, coinstakeTime, subNodesBlockTime[subNode]);
+        }
+        return hashProofOfStake <= targetProofOfStake;
+    }
+
+    std::optional<int64_t> CKernelSearch::Search(int64_t start, int64_t step, size_t count, CheckContextState& ctxState) const {
+        // the time follows the stake modifier
+        static const size_t timeOffset = 32;
+        const auto len = preimage.size();
+        std::vector<unsigned char> messages(BATCH_SIZE * loops * len);
+        std::vector<unsigned char> hashes(BATCH_SIZE * loops * 32);
+
+        for (size_t first = 0; first < count; first += BATCH_SIZE) {
+            const auto times = std::min(BATCH_SIZE, count - first);
+            // messages ordered by time, then subnode
+            for (size_t t = 0; t < times; ++t) {
+                for (uint8_t i{0}; i < loops; ++i) {
+                    auto message = messages.data() + (t * loops + i) * len;
+                    std::copy(preimage.begin(), preimage.end(), message);
+                    WriteLE64(message + timeOffset, start + step * static_cast<int64_t>(first + t));
+                    if (multi) {
+                        message[len - 1] = i;
+                    }
+                }
+            }
+            SHA256DBatch(hashes.data(), messages.data(), len, times * loops);
+
+            for (size_t t = 0; t < times; ++t) {
+                const auto coinstakeTime = start + step * static_cast<int64_t>(first + t);
+                for (uint8_t i{0}; i < loops; ++i) {
+                    uint256 hash;
+                    std::copy_n(hashes.data() + (t * loops + i) * 32, 32, hash.begin());
+                    if (MeetsTarget(hash, coinstakeTime, i)) {
+                        if (multi) {
+                            ctxState.subNode = i;
+                        }
+                        return coinstakeTime;
+                    }
+                }
+            }
+        }
+        return {};
+    }
+
     uint256 ComputeStakeModifier(const uint256& prevStakeModifier, const CKeyID& key) {
         // Calculate hash
         CDataStream ss(SER_GETHASH, 0);
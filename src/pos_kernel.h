@@ -8,6 +8,9 @@
 #include <amount.h>
 #include <pos.h>
 
+#include <optional>
+#include <vector>
+
 class CWallet;
 class COutPoint;
 class CBlock;
@@ -28,7 +31,34 @@ namespace pos {
 
 /// Check whether stake kernel meets hash target
     bool CheckKernelHash(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, int64_t coinstakeTime, uint64_t blockHeight,
-                         const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t> subNodesBlockTime, const uint16_t timelock, CheckContextState& ctxState);
+                         const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t>& subNodesBlockTime, const uint16_t timelock, CheckContextState& ctxState);
+
+/// Kernel hash checks of one masternode over many coinstake times, hashed in SIMD batches.
+/// Finds the same kernels as CheckKernelHash.
+    class CKernelSearch {
+    public:
+        // coinstake times hashed together
+        static const size_t BATCH_SIZE = 8;
+
+        CKernelSearch(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, uint64_t blockHeight,
+                      const uint256& masternodeID, const Consensus::Params& params, const std::vector<int64_t>& subNodesBlockTime, const uint16_t timelock);
+
+        /// Checks the times start, start + step, ... in turn, returns the first meeting the target
+        std::optional<int64_t> Search(int64_t start, int64_t step, size_t count, CheckContextState& ctxState) const;
+
+    private:
+        bool MeetsTarget(const uint256& hash, int64_t coinstakeTime, uint8_t subNode) const;
+
+        const Consensus::Params& params;
+        const uint64_t blockHeight;
+        const std::vector<int64_t> subNodesBlockTime;
+        arith_uint256 targetProofOfStake;
+        uint64_t collateral;
+        bool multi;
+        uint8_t loops;
+        // serialized kernel with the time and subnode left to fill in
+        std::vector<unsigned char> preimage;
+    };
 
 /// Stake Modifier (hash modifier of proof-of-stake)
     uint256 ComputeStakeModifier(const uint256& prevStakeModifier, const CKeyID& key);
@@ -15,8 +15,11 @@
 #include <core_io.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
+#include <masternodes/accountshistory.h>
 #include <masternodes/masternodes.h>
 #include <masternodes/mn_checks.h>
+#include <masternodes/snapshot.h>
+#include <masternodes/vaulthistory.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <policy/rbf.h>
@@ -27,6 +30,7 @@
 #include <script/descriptor.h>
 #include <streams.h>
 #include <sync.h>
+#include <txdb.h>
 #include <txmempool.h>
 #include <undo.h>
 #include <util/strencodings.h>
@@ -2325,6 +2329,85 @@ static UniValue getblockfilter(const JSONRPCRequest& request)
     return ret;
 }
 
+static UniValue dumpdefistate(const JSONRPCRequest& request)
+{
+            RPCHelpMan{"dumpdefistate",
+                "\nWrites a snapshot of the DeFi state, coins and history databases at the chain tip to a file.\n"
+                "A node holding the blocks up to the tip starts from it with -loaddefistate and -loaddefistateroot set to the returned stateroot instead of replaying them.\n",
+                {
+                    {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "Path of the snapshot, relative paths are taken from the data directory"},
+                },
+                RPCResult{
+                    "{\n"
+                    "  \"path\" : \"path\",       (string) the absolute path of the snapshot\n"
+                    "  \"height\" : n,            (numeric) the height of the block the state is at\n"
+                    "  \"blockhash\" : \"hash\",  (string) the hash of the block the state is at\n"
+                    "  \"records\" : n,           (numeric) the number of records written\n"
+                    "  \"stateroot\" : \"hash\",  (string) the state commitment the snapshot is checked against on load\n"
+                    "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("dumpdefistate", "\"defistate.dat\"")
+            + HelpExampleRpc("dumpdefistate", "\"defistate.dat\"")
+                },
+            }.Check(request);
+
+    const fs::path path = fs::absolute(request.params[0].get_str(), GetDataDir());
+    if (fs::exists(path)) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, path.string() + " already exists");
+    }
+    // renamed once complete, a partial snapshot is never left under the path
+    const fs::path temppath = path.string() + ".incomplete";
+    CAutoFile file(fsbridge::fopen(temppath, "wb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Couldn't open " + temppath.string() + " for writing");
+    }
+
+    CDeFiStateSnapshotHeader header;
+    std::vector<CDeFiStateSnapshotSource> sources;
+    {
+        LOCK(cs_main);
+        ::ChainstateActive().ForceFlushStateToDisk();
+        const auto tip = ::ChainActive().Tip();
+        header.networkMagic = CDeFiStateSnapshotHeader::NetworkMagic(Params());
+        header.dbVersion = pcustomcsview->GetDbVersion();
+        header.height = tip->nHeight;
+        header.blockHash = tip->GetBlockHash();
+        if (auto res = header.Check(Params()); !res) {
+            file.fclose();
+            fs::remove(temppath);
+            throw JSONRPCError(RPC_MISC_ERROR, res.msg);
+        }
+        // the iterators read the databases as they are now, the chain moves on while they are written
+        sources.push_back({SnapshotSection::CustomCS, pcustomcsDB->NewIterator(), {}});
+        sources.push_back({SnapshotSection::Coins, std::make_unique<CStorageLevelDBIterator>(std::unique_ptr<CDBIterator>(::ChainstateActive().CoinsDB().NewRawIterator())),
+                           [](TBytesView key) { return key.size() == 0 || !CCoinsViewDB::IsChainStateRecord(key[0]); }});
+        if (paccountHistoryDB) {
+            sources.push_back({SnapshotSection::AccountHistory, paccountHistoryDB->RawStorage().NewIterator(), {}});
+        }
+        sources.push_back({SnapshotSection::BurnHistory, pburnHistoryDB->RawStorage().NewIterator(), {}});
+        if (pvaultHistoryDB) {
+            sources.push_back({SnapshotSection::VaultHistory, pvaultHistoryDB->RawStorage().NewIterator(), {}});
+        }
+    }
+
+    auto trailer = DumpDeFiStateSnapshot(file, header, sources);
+    file.fclose();
+    if (!trailer) {
+        fs::remove(temppath);
+        throw JSONRPCError(RPC_MISC_ERROR, "Unable to dump the DeFi state: " + trailer.msg);
+    }
+    fs::rename(temppath, path);
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("path", path.string());
+    result.pushKV("height", header.height);
+    result.pushKV("blockhash", header.blockHash.GetHex());
+    result.pushKV("records", trailer->records);
+    result.pushKV("stateroot", trailer->stateRoot.GetHex());
+    return result;
+}
+
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
@@ -2353,6 +2436,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "preciousblock",          &preciousblock,          {"blockhash"} },
     { "blockchain",         "scantxoutset",           &scantxoutset,           {"action", "scanobjects"} },
     { "blockchain",         "getblockfilter",         &getblockfilter,         {"blockhash", "filtertype"} },
+    { "blockchain",         "dumpdefistate",          &dumpdefistate,          {"path"} },
 
     /* Not shown in help */
     { "hidden",             "invalidateblock",        &invalidateblock,        {"blockhash"} },
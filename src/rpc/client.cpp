@@ -352,6 +352,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "setmockcheckpoint", 0, "height" },
     { "logaccountbalances", 0, "logfile" },
     { "logaccountbalances", 1, "rpcresult" },
+    { "getdftxstats", 1, "reset" },
 
     { "creategovcfp", 0, "data" },
     { "creategovcfp", 1, "inputs" },
@@ -5,6 +5,7 @@
 
 #include <chainparams.h>
 #include <crypto/ripemd160.h>
+#include <dbwrapper.h>
 #include <httpserver.h>
 #include <outputtype.h>
 #include <rpc/blockchain.h>
@@ -477,6 +478,60 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     }
 }
 
+static UniValue getdbstats(const JSONRPCRequest& request)
+{
+            RPCHelpMan{"getdbstats",
+                "Returns the leveldb profiles and block cache statistics of the open databases.\n",
+                {},
+                RPCResult{
+            "[\n"
+            "  {\n"
+            "    \"name\": \"name\",           (string) Name of the database\n"
+            "    \"compression\": true|false, (boolean) Whether blocks are compressed, where snappy is available\n"
+            "    \"blocksize\": xxxxx,        (numeric) Block size in bytes\n"
+            "    \"bloombits\": xx,           (numeric) Bits per key of the bloom filter, 0 for none\n"
+            "    \"cacheshare\": x.xx,        (numeric) Part of the cache the database was opened with it uses\n"
+            "    \"writebuffer\": xxxxx,      (numeric) Bound of the write buffer in bytes\n"
+            "    \"pooled\": true|false,      (boolean) Whether the block cache is pooled with the other adaptive databases\n"
+            "    \"blockcache\": xxxxx,       (numeric) Size of the block cache, the pool's size if pooled\n"
+            "    \"blockcacheusage\": xxxxx,  (numeric) Bytes of cached blocks, of every database in the pool if pooled\n"
+            "    \"hits\": xxxxx,             (numeric) Block cache lookups hitting\n"
+            "    \"misses\": xxxxx,           (numeric) Block cache lookups missing\n"
+            "    \"hitrate\": x.xx,           (numeric) Part of the lookups hitting\n"
+            "    \"memoryusage\": xxxxx,      (numeric) Approximate memory usage of the database in bytes\n"
+            "    \"disksize\": xxxxx,         (numeric) Approximate size on disk in bytes\n"
+            "  },...\n"
+            "]\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+                },
+            }.Check(request);
+
+    UniValue result(UniValue::VARR);
+    for (const auto& stats : GetDBStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", stats.name);
+        obj.pushKV("compression", stats.profile.compression);
+        obj.pushKV("blocksize", static_cast<uint64_t>(stats.profile.blockSize));
+        obj.pushKV("bloombits", stats.profile.bloomBits);
+        obj.pushKV("cacheshare", stats.profile.cacheShare);
+        obj.pushKV("writebuffer", static_cast<uint64_t>(stats.profile.maxWriteBuffer));
+        obj.pushKV("pooled", stats.pooledCache);
+        obj.pushKV("blockcache", static_cast<uint64_t>(stats.blockCacheSize));
+        obj.pushKV("blockcacheusage", static_cast<uint64_t>(stats.blockCacheUsage));
+        obj.pushKV("hits", stats.cacheHits);
+        obj.pushKV("misses", stats.cacheMisses);
+        const auto lookups = stats.cacheHits + stats.cacheMisses;
+        obj.pushKV("hitrate", lookups ? static_cast<double>(stats.cacheHits) / lookups : 0.0);
+        obj.pushKV("memoryusage", static_cast<uint64_t>(stats.memoryUsage));
+        obj.pushKV("disksize", static_cast<uint64_t>(stats.diskSize));
+        result.push_back(obj);
+    }
+    return result;
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -585,6 +640,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
+    { "control",            "getdbstats",             &getdbstats,             {} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
     { "util",               "validateaddress",        &validateaddress,        {"address"} },
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys","address_type"} },
@@ -75,44 +75,3 @@ void SetLastValidatedHeight(int height) {
     g_lastValidatedHeight.store(height, std::memory_order_release);
     GetRPCResultCache().InvalidateCaches();
 }
-
-void MemoizedResultCache::Init(RPCResultCache::RPCCacheMode mode) {
-    std::unique_lock l{aMutex};
-    this->mode = mode;
-}
-
-CMemoizedResultValue MemoizedResultCache::GetOrDefault(const JSONRPCRequest &request) {
-    if (mode == RPCResultCache::RPCCacheMode::None) return {};
-    auto key = GetKey(request);
-    {
-        std::unique_lock l{aMutex};
-        if (auto res = cacheMap.find(key); res != cacheMap.end()) {
-            if (!::ChainActive().Contains(LookupBlockIndex(res->second.hash)))
-                return {};
-
-            if (LogAcceptCategory(BCLog::RPCCACHE)) {
-                LogPrint(BCLog::RPCCACHE, "RPCCache: hit: key: %d/%s\n", res->second.height, key);
-            }
-            return res->second;
-        }
-    }
-    return {};
-}
-
-void MemoizedResultCache::Set(const JSONRPCRequest &request, const CMemoizedResultValue &value) {
-    auto key = GetKey(request);
-    {
-        std::unique_lock l{aMutex};
-        if (LogAcceptCategory(BCLog::RPCCACHE)) {
-            LogPrint(BCLog::RPCCACHE, "RPCCache: set: key: %d/%s\n", value.height, key);
-        }
-        cacheMap[key] = value;
-    }
-}
-
-// Note: We initialize all the globals in the init phase. So, it's safe. Otherwise,
-// static init is undefined behavior when multiple threads init them at the same time.
-MemoizedResultCache& GetMemoizedResultCache() {
-    static MemoizedResultCache g_memoizedResultCache;
-    return g_memoizedResultCache;
-}
@@ -11,16 +11,6 @@
 #include <masternodes/mn_rpc.h>
 #include <rpc/request.h>
 
-struct CGetBurnInfoResult {
-    CAmount burntDFI{};
-    CAmount burntFee{};
-    CAmount auctionFee{};
-    CBalances burntTokens;
-    CBalances nonConsortiumTokens;
-    CBalances dexfeeburn;
-    CBalances paybackFee;
-};
-
 class RPCResultCache {
 public:
     enum RPCCacheMode {
@@ -48,23 +38,4 @@ RPCResultCache& GetRPCResultCache();
 int GetLastValidatedHeight();
 void SetLastValidatedHeight(int height);
 
-struct CMemoizedResultValue {
-    int height;
-    uint256 hash;
-    std::variant<CGetBurnInfoResult> data;
-};
-
-class MemoizedResultCache {
-public:
-    void Init(RPCResultCache::RPCCacheMode mode);
-    CMemoizedResultValue GetOrDefault(const JSONRPCRequest &request);
-    void Set(const JSONRPCRequest &request, const CMemoizedResultValue &value);
-private:
-    AtomicMutex aMutex;
-    std::map<std::string, CMemoizedResultValue> cacheMap{};
-    RPCResultCache::RPCCacheMode mode{RPCResultCache::RPCCacheMode::None};
-};
-
-MemoizedResultCache& GetMemoizedResultCache();
-
 #endif //DEFI_RPC_RESULTCACHE_H
@@ -1,4 +1,6 @@
 #include <rpc/stats.h>
+#include <masternodes/dftxstats.h>
+#include <masternodes/viewcache.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 
@@ -233,12 +235,100 @@ static UniValue listrpcstats(const JSONRPCRequest& request)
     return statsRPC.toJSON();
 }
 
+static UniValue CountersToJSON(const CViewCacheCounters& counters) {
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("hits", counters.hits.load());
+    obj.pushKV("misses", counters.misses.load());
+    return obj;
+}
+
+static UniValue getviewcachestats(const JSONRPCRequest& request)
+{
+    RPCHelpMan{"getviewcachestats",
+        "\nGet hit and miss counts of the DeFi state views' read caches since node start.\n",
+        {},
+        RPCResult{
+            "{\n"
+            "  \"attributes\":         (json object) Governance attributes reads.\n"
+            "  {\n"
+            "       \"hits\":          (numeric) Reads served from the cache.\n"
+            "       \"misses\":        (numeric) Reads decoded from storage.\n"
+            "  }\n"
+            "  \"tokens\":             (json object) Token by id reads, same format.\n"
+            "  \"poolpairs\":          (json object) Pool pair by id reads, same format.\n"
+            "  \"poolgraph\":          (json object) Pool pair graph reads of composite swaps, same format.\n"
+            "}"
+        },
+        RPCExamples{
+            HelpExampleCli("getviewcachestats", "") +
+            HelpExampleRpc("getviewcachestats", "")
+        },
+    }.Check(request);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("attributes", CountersToJSON(viewCacheStats.attributes));
+    ret.pushKV("tokens", CountersToJSON(viewCacheStats.tokens));
+    ret.pushKV("poolpairs", CountersToJSON(viewCacheStats.poolPairs));
+    ret.pushKV("poolgraph", CountersToJSON(viewCacheStats.poolPairGraph));
+    return ret;
+}
+
+static UniValue getdftxstats(const JSONRPCRequest& request)
+{
+    RPCHelpMan{"getdftxstats",
+        "\nGet the execution profile of the custom transactions by type and of the block event stages, named \"event:<stage>\".\n"
+        "Storage reads and writes, bytes serialized and write buffer entries are the ones of the views used by the\n"
+        "transaction or stage on its own thread. Every execution counts, in blocks, block templates and the mempool.\n",
+        {
+            {"format", RPCArg::Type::STR, /* default */ "json", "\"json\" or \"prometheus\" for the Prometheus text format."},
+            {"reset", RPCArg::Type::BOOL, /* default */ "false", "Clear the stats once returned."},
+        },
+        RPCResult{
+            "{\n"
+            "  \"type\":               (json object) Stats of the transaction type or stage.\n"
+            "  {\n"
+            "       \"count\":         (numeric) Executions.\n"
+            "       \"failures\":      (numeric) Executions that failed.\n"
+            "       \"time\":          (json object) Wall time in microseconds, its total, avg, p50, p90, p99 and max.\n"
+            "       \"reads\":         (json object) Storage reads, same format.\n"
+            "       \"writes\":        (json object) Storage writes and erases, same format.\n"
+            "       \"bytes\":         (json object) Serialized keys and values read and written, same format.\n"
+            "       \"mapEntries\":    (json object) Entries left in the write buffer of the view, same format.\n"
+            "  }\n"
+            "}\n"
+            "Percentiles are the upper bounds of the power of two buckets holding them.\n"
+        },
+        RPCExamples{
+            HelpExampleCli("getdftxstats", "") +
+            HelpExampleCli("getdftxstats", "prometheus true") +
+            HelpExampleRpc("getdftxstats", "\"json\"")
+        },
+    }.Check(request);
+
+    if (!dftxStats.isActive()) {
+        throw JSONRPCError(RPC_INVALID_REQUEST, "Dftxstats is deactivated, start the node with -dftxstats.");
+    }
+
+    const auto format = request.params[0].isNull() ? "json" : request.params[0].get_str();
+    if (format != "json" && format != "prometheus") {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Format must be json or prometheus");
+    }
+
+    UniValue ret = format == "json" ? dftxStats.toJSON() : UniValue(dftxStats.toPrometheus());
+    if (!request.params[1].isNull() && request.params[1].get_bool()) {
+        dftxStats.clear();
+    }
+    return ret;
+}
+
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "stats",              "getrpcstats",            &getrpcstats,            {"command"} },
     { "stats",              "listrpcstats",           &listrpcstats,           {} },
+    { "stats",              "getviewcachestats",      &getviewcachestats,      {} },
+    { "stats",              "getdftxstats",           &getdftxstats,           {"format", "reset"} },
 };
 // clang-format on
 
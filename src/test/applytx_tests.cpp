@@ -5,6 +5,8 @@
 #include <chainparams.h>
 #include <masternodes/masternodes.h>
 #include <masternodes/mn_checks.h>
+#include <masternodes/poolpairs.h>
+#include <masternodes/speculative.h>
 #include <test/setup_common.h>
 #include <validation.h>
 
@@ -176,5 +178,184 @@ BOOST_AUTO_TEST_CASE(apply_a2a_neg)
     }
 }
 
+BOOST_AUTO_TEST_CASE(speculative_apply_matches_serial)
+{
+    Consensus::Params amkCheated = Params().GetConsensus();
+    amkCheated.AMKHeight = 0;
+
+    CCustomCSView base(*pcustomcsview);
+    CCoinsViewCache coinview(&::ChainstateActive().CoinsTip());
+
+    DCT_ID DFI{0};
+    std::vector<CScript> owners;
+    for (int i = 0; i < 6; ++i) {
+        owners.push_back(CScript(0xC0 + i));
+        BOOST_REQUIRE(base.AddBalance(owners.back(), CTokenAmount{DFI, 100}));
+        coinview.AddCoin(COutPoint(uint256S("0xbeef"), i), Coin(CTxOut(1, owners.back(), DFI), 1, false), false);
+    }
+
+    auto createA2A = [&](int from, int to, CAmount amount) {
+        CAccountToAccountMessage msg{};
+        msg.from = owners[from];
+        msg.to = {{owners[to], CBalances{{{DFI, amount}}}}};
+        CMutableTransaction rawTx;
+        rawTx.vin = {CTxIn(COutPoint(uint256S("0xbeef"), from))};
+        rawTx.vout = {CTxOut(0, CreateMetaA2A(msg))};
+        return MakeTransactionRef(std::move(rawTx));
+    };
+
+    CBlock block;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vout = {CTxOut(0, CScript())};
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    block.vtx.push_back(createA2A(0, 1, 10));
+    block.vtx.push_back(createA2A(2, 3, 10));
+    block.vtx.push_back(createA2A(1, 2, 50)); // depends on the first one
+    block.vtx.push_back(createA2A(4, 5, 3));
+
+    CCustomCSView serial(base);
+    for (uint32_t i = 1; i < block.vtx.size(); ++i) {
+        BOOST_CHECK(ApplyCustomTx(serial, coinview, *block.vtx[i], amkCheated, 1, 0, nullptr, i));
+    }
+
+    CCustomCSView speculative(base);
+    CDfTxSpeculativeExecutor executor(block, 1, 0, amkCheated, 0, true);
+    BOOST_REQUIRE(executor.IsEnabled());
+    for (uint32_t i = 1; i < block.vtx.size(); ++i) {
+        BOOST_CHECK(executor.Apply(speculative, coinview, i));
+    }
+
+    const auto &stats = executor.GetStats();
+    BOOST_CHECK_EQUAL(stats.speculated, 4u);
+    BOOST_CHECK_EQUAL(stats.committed + stats.reexecuted, 4u);
+    BOOST_CHECK_GE(stats.reexecuted, 1u);
+
+    auto const dfi60 = CTokenAmount{DFI, 60};
+    auto const dfi140 = CTokenAmount{DFI, 140};
+    BOOST_CHECK_EQUAL(speculative.GetBalance(owners[1], DFI), dfi60);
+    BOOST_CHECK_EQUAL(speculative.GetBalance(owners[2], DFI), dfi140);
+    BOOST_CHECK(speculative.GetStorage().GetRaw() == serial.GetStorage().GetRaw());
+    BOOST_CHECK_EQUAL(speculative.MerkleRoot(), serial.MerkleRoot());
+}
+
+BOOST_AUTO_TEST_CASE(mempool_tracker_height_change)
+{
+    Consensus::Params amkCheated = Params().GetConsensus();
+    amkCheated.AMKHeight = 0;
+
+    CCustomCSView base(*pcustomcsview);
+    CCoinsViewCache coinview(&::ChainstateActive().CoinsTip());
+
+    DCT_ID DFI{0};
+    auto createToken = [&](const std::string &symbol, uint8_t flags) {
+        CTokenImplementation token;
+        token.symbol = symbol;
+        token.flags = flags;
+        token.creationTx = Hash(symbol.begin(), symbol.end());
+        auto res = base.CreateToken(token, false);
+        BOOST_REQUIRE(res);
+        return *res.val;
+    };
+
+    // the second owner provides liquidity to a pool paying rewards
+    const std::vector<CScript> owners{CScript(0xD0), CScript(0xD2)};
+    const auto idPool = createToken("MTA-MTB", static_cast<uint8_t>(CToken::TokenFlags::Default) |
+                                               static_cast<uint8_t>(CToken::TokenFlags::DAT) |
+                                               static_cast<uint8_t>(CToken::TokenFlags::LPS));
+    CPoolPair pool{};
+    pool.idTokenA = createToken("MTA", static_cast<uint8_t>(CToken::TokenFlags::Default));
+    pool.idTokenB = createToken("MTB", static_cast<uint8_t>(CToken::TokenFlags::Default));
+    pool.status = true;
+    BOOST_REQUIRE(pool.AddLiquidity(10 * COIN, 10 * COIN, [&](CAmount liquidity) {
+        BOOST_REQUIRE(base.AddBalance(owners[1], {idPool, liquidity}));
+        return base.SetShare(idPool, owners[1], 1);
+    }));
+    BOOST_REQUIRE(base.SetPoolPair(idPool, 1, pool));
+    BOOST_REQUIRE(base.SetRewardPct(idPool, 1, COIN));
+    BOOST_REQUIRE(base.SetDailyReward(1, 2880 * COIN));
+
+    std::vector<CTransactionRef> txs;
+    for (uint32_t i = 0; i < owners.size(); ++i) {
+        BOOST_REQUIRE(base.AddBalance(owners[i], CTokenAmount{DFI, 100}));
+        coinview.AddCoin(COutPoint(uint256S("0xdead"), i), Coin(CTxOut(1, owners[i], DFI), 1, false), false);
+
+        CAccountToAccountMessage msg{};
+        msg.from = owners[i];
+        msg.to = {{CScript(0xD1), CBalances{{{DFI, 10}}}}};
+        CMutableTransaction rawTx;
+        rawTx.vin = {CTxIn(COutPoint(uint256S("0xdead"), i))};
+        rawTx.vout = {CTxOut(0, CreateMetaA2A(msg))};
+        txs.push_back(MakeTransactionRef(std::move(rawTx)));
+    }
+
+    CMempoolDfTxTracker tracker;
+    CAmount rewarded{};
+    auto rebuild = [&](uint32_t height) {
+        CCustomCSView view(base);
+        for (const auto &tx : txs) {
+            BOOST_CHECK(tracker.Apply(view, coinview, *tx, amkCheated, height));
+        }
+        BOOST_CHECK_EQUAL(view.GetBalance(CScript(0xD1), DFI), (CTokenAmount{DFI, 20}));
+        // balances are brought to the height, with the pool rewards up to it
+        for (const auto &owner : owners) {
+            BOOST_CHECK_EQUAL(view.GetBalancesHeight(owner), height);
+        }
+        rewarded = view.GetBalance(owners[1], DFI).nValue - 90;
+        return tracker.Rebuilt();
+    };
+
+    BOOST_CHECK_EQUAL(rebuild(1).reapplied, 2u);
+    BOOST_CHECK_EQUAL(rewarded, 0);
+    // same height, nothing changed
+    BOOST_CHECK_EQUAL(rebuild(1).replayed, 2u);
+    BOOST_CHECK_EQUAL(rewarded, 0);
+    // the height alone changed
+    BOOST_CHECK_EQUAL(rebuild(2).reapplied, 2u);
+    BOOST_CHECK_GT(rewarded, 0);
+    const auto rewardedAt2 = rewarded;
+    BOOST_CHECK_EQUAL(rebuild(4).reapplied, 2u);
+    BOOST_CHECK_GT(rewarded, rewardedAt2);
+    BOOST_CHECK_EQUAL(rebuild(4).replayed, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(balances_in_batch_match_separate_adds)
+{
+    CCustomCSView serial(*pcustomcsview);
+    CCustomCSView batch(*pcustomcsview);
+
+    CScript const owner = CScript(1);
+    CScript const other = CScript(2);
+    DCT_ID const DFI{0};
+    DCT_ID const TOKEN{1};
+
+    for (auto view : {&serial, &batch}) {
+        BOOST_REQUIRE(view->AddBalance(owner, CTokenAmount{DFI, MAX_MONEY}));
+        BOOST_REQUIRE(view->AddBalance(other, CTokenAmount{TOKEN, 50}));
+    }
+
+    std::vector<std::pair<CScript, CTokenAmount>> amounts{
+        {owner, CTokenAmount{DFI, 10}},
+        {other, CTokenAmount{TOKEN, 0}},
+        {owner, CTokenAmount{DFI, std::numeric_limits<CAmount>::max()}},
+        {other, CTokenAmount{TOKEN, 25}},
+        {owner, CTokenAmount{TOKEN, 5}},
+        {owner, CTokenAmount{DFI, -1}},
+        {owner, CTokenAmount{DFI, 20}},
+    };
+
+    std::vector<bool> added;
+    for (const auto& [script, amount] : amounts) {
+        added.push_back(serial.AddBalance(script, amount).ok);
+    }
+    BOOST_CHECK(batch.AddBalancesInBatch(amounts) == added);
+    BOOST_CHECK(!added[2] && !added[5]);
+
+    BOOST_CHECK_EQUAL(batch.GetBalance(owner, DFI), (CTokenAmount{DFI, MAX_MONEY + 30}));
+    BOOST_CHECK_EQUAL(batch.GetBalance(other, TOKEN), (CTokenAmount{TOKEN, 75}));
+    BOOST_CHECK(batch.GetStorage().GetRaw() == serial.GetStorage().GetRaw());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -3,8 +3,15 @@
 #include <stdlib.h>
 
 #include <chain.h>
+#include <clientversion.h>
+#include <key.h>
 #include <rpc/blockchain.h>
+#include <streams.h>
 #include <test/setup_common.h>
+#include <txdb.h>
+
+#include <map>
+#include <memory>
 
 /* Equality between doubles is imprecise. Comparison should be done
  * with a small threshold of tolerance, rather than exact equality.
@@ -69,4 +76,71 @@ BOOST_AUTO_TEST_CASE(get_difficulty_for_very_high_target)
     TestDifficulty(0x12345678, 5913134931067755359633408.0);
 }
 
+BOOST_AUTO_TEST_CASE(block_tree_minter_keys)
+{
+    std::vector<CKey> keys(3);
+    std::vector<std::unique_ptr<CBlockIndex>> indexes;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i].MakeNewKey(true);
+        CBlockHeader header;
+        header.hashPrevBlock = i ? indexes.back()->GetBlockHash() : uint256();
+        header.nTime = 1269211443 + i;
+        header.nBits = 0x1d00ffff;
+        header.deprecatedHeight = i + 1;
+        BOOST_REQUIRE(keys[i].SignCompact(header.GetHashToSign(), header.sig));
+
+        indexes.push_back(std::make_unique<CBlockIndex>(header));
+        indexes.back()->pprev = i ? indexes[i - 1].get() : nullptr;
+        indexes.back()->nHeight = i + 1;
+        indexes.back()->nStatus = BLOCK_VALID_TREE | BLOCK_OPT_WITNESS;
+        BOOST_CHECK(indexes.back()->minterKeyID == keys[i].GetPubKey().GetID());
+    }
+
+    // entries of the baseline client end at the signature
+    CDataStream stored(SER_DISK, 4000000);
+    stored << CDiskBlockIndex(indexes[0].get());
+    CDiskBlockIndex entry;
+    stored >> entry;
+    BOOST_CHECK(stored.empty());
+    BOOST_CHECK(entry.minterKeyID.IsNull());
+    BOOST_CHECK(entry.GetBlockHash() == indexes[0]->GetBlockHash());
+
+    CBlockTreeDB db(1 << 20, true, true);
+    // the first two written by an older client, the last one with its minter key
+    for (size_t i = 0; i < 2; ++i) {
+        BOOST_REQUIRE(db.Write(std::make_pair('b', indexes[i]->GetBlockHash()), CDiskBlockIndex(indexes[i].get())));
+    }
+    BOOST_REQUIRE(db.WriteBatchSync({}, 0, {indexes[2].get()}));
+
+    std::map<uint256, std::unique_ptr<CBlockIndex>> loaded;
+    auto load = [&](std::vector<CBlockIndex*>& recovered) {
+        loaded.clear();
+        BOOST_REQUIRE(db.LoadBlockIndexGuts(Params().GetConsensus(), [&](const uint256& hash) -> CBlockIndex* {
+            if (hash.IsNull()) {
+                return nullptr;
+            }
+            auto& pindex = loaded[hash];
+            if (!pindex) {
+                pindex = std::make_unique<CBlockIndex>();
+            }
+            return pindex.get();
+        }, false, recovered));
+        BOOST_REQUIRE_EQUAL(loaded.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_CHECK(loaded.at(indexes[i]->GetBlockHash())->minterKeyID == keys[i].GetPubKey().GetID());
+        }
+    };
+
+    std::vector<CBlockIndex*> recovered;
+    load(recovered);
+    BOOST_REQUIRE_EQUAL(recovered.size(), 2u);
+    BOOST_REQUIRE(db.WriteMinterKeys({recovered.begin(), recovered.end()}));
+
+    // rewritten by an older client after a downgrade, the stored keys are kept
+    BOOST_REQUIRE(db.Write(std::make_pair('b', indexes[2]->GetBlockHash()), CDiskBlockIndex(indexes[2].get())));
+    recovered.clear();
+    load(recovered);
+    BOOST_CHECK(recovered.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
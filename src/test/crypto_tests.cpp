@@ -749,4 +749,22 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d_batch)
+{
+    for (int len : {0, 33, 55, 56, 80, 81, 119}) {
+        for (int i = 0; i <= 19; ++i) {
+            unsigned char in[119 * 19];
+            unsigned char out1[32 * 19], out2[32 * 19];
+            for (int j = 0; j < len * i; ++j) {
+                in[j] = InsecureRandBits(8);
+            }
+            for (int j = 0; j < i; ++j) {
+                CHash256().Write(in + len * j, len).Finalize(out1 + 32 * j);
+            }
+            SHA256DBatch(out2, in, len, i);
+            BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
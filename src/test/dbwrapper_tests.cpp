@@ -318,4 +318,67 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
 
 
 
+BOOST_AUTO_TEST_CASE(dbwrapper_profiles)
+{
+    std::string error;
+    BOOST_CHECK(ParseDBProfile("dbwrapper_profile:compression=1,blocksize=65536,bloombits=0,cacheshare=0.25,writebuffer=2", error));
+    const auto profile = GetDBProfile("dbwrapper_profile");
+    BOOST_CHECK(profile.compression);
+    BOOST_CHECK_EQUAL(profile.blockSize, 65536U);
+    BOOST_CHECK_EQUAL(profile.bloomBits, 0);
+    BOOST_CHECK_EQUAL(profile.cacheShare, 0.25);
+    BOOST_CHECK_EQUAL(profile.maxWriteBuffer, 2U << 20);
+    BOOST_CHECK(!profile.adaptiveCache);
+
+    BOOST_CHECK(!ParseDBProfile("dbwrapper_profile", error));
+    BOOST_CHECK(!ParseDBProfile("dbwrapper_profile:cacheshare=2", error));
+    BOOST_CHECK(!ParseDBProfile("dbwrapper_profile:blocksize=1", error));
+    BOOST_CHECK(!ParseDBProfile("dbwrapper_profile:unknown=1", error));
+    // left as it was by the settings rejected
+    BOOST_CHECK_EQUAL(GetDBProfile("dbwrapper_profile").cacheShare, 0.25);
+
+    // names without a profile of their own keep the defaults
+    BOOST_CHECK_EQUAL(GetDBProfile("dbwrapper_unknown").bloomBits, 16);
+    BOOST_CHECK(GetDBProfile("enhancedcs").adaptiveCache);
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_pooled_cache)
+{
+    std::string error;
+    BOOST_CHECK(ParseDBProfile("dbwrapper_pooled_a:adaptive=1,cacheshare=0.5", error));
+    BOOST_CHECK(ParseDBProfile("dbwrapper_pooled_b:adaptive=1,cacheshare=0.5", error));
+    SetDBCachePool(8 << 20);
+    {
+        CDBWrapper a(GetDataDir() / "dbwrapper_pooled_a", 8 << 20, true);
+        CDBWrapper b(GetDataDir() / "dbwrapper_pooled_b", 8 << 20, true);
+        CDBWrapper own(GetDataDir() / "dbwrapper_own", 8 << 20, true);
+        for (auto db : {&a, &b, &own}) {
+            for (uint32_t i = 0; i < 100; ++i) {
+                BOOST_CHECK(db->Write(i, i));
+            }
+            // moves the records to a table, reading them goes through the block cache
+            db->CompactRange(0U, 1000U);
+        }
+        uint32_t value;
+        BOOST_CHECK(a.Read(7U, value) && a.Read(7U, value));
+        BOOST_CHECK(own.Read(7U, value));
+
+        std::map<std::string, DBStats> stats;
+        for (const auto& db : GetDBStats()) {
+            stats[db.name] = db;
+        }
+        BOOST_CHECK(stats.at("dbwrapper_pooled_a").pooledCache);
+        BOOST_CHECK(stats.at("dbwrapper_pooled_b").pooledCache);
+        BOOST_CHECK(!stats.at("dbwrapper_own").pooledCache);
+        BOOST_CHECK_EQUAL(stats.at("dbwrapper_own").blockCacheSize, 4U << 20);
+        // the pool holds the blocks of every database in it
+        BOOST_CHECK_EQUAL(stats.at("dbwrapper_pooled_a").blockCacheSize, stats.at("dbwrapper_pooled_b").blockCacheSize);
+        BOOST_CHECK_EQUAL(stats.at("dbwrapper_pooled_a").blockCacheUsage, stats.at("dbwrapper_pooled_b").blockCacheUsage);
+        BOOST_CHECK(stats.at("dbwrapper_pooled_a").cacheHits > 0);
+        BOOST_CHECK_EQUAL(stats.at("dbwrapper_pooled_b").cacheHits + stats.at("dbwrapper_pooled_b").cacheMisses, 0U);
+        BOOST_CHECK(stats.at("dbwrapper_own").cacheMisses > 0);
+    }
+    SetDBCachePool(0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
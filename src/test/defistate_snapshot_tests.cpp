@@ -0,0 +1,127 @@
+#include <test/setup_common.h>
+
+#include <chainparams.h>
+#include <clientversion.h>
+#include <masternodes/masternodes.h>
+#include <masternodes/snapshot.h>
+
+#include <boost/test/unit_test.hpp>
+
+static TBytes Bytes(const std::string &str) {
+    return {str.begin(), str.end()};
+}
+
+static std::map<TBytes, TBytes> Records(CStorageKV &db) {
+    std::map<TBytes, TBytes> records;
+    auto it = db.NewIterator();
+    for (it->Seek({}); it->Valid(); it->Next()) {
+        const auto key = it->KeyView();
+        const auto value = it->ValueView();
+        records.emplace(TBytes(key.begin(), key.end()), TBytes(value.begin(), value.end()));
+    }
+    return records;
+}
+
+static CDeFiStateSnapshotHeader Header() {
+    CDeFiStateSnapshotHeader header;
+    header.networkMagic = CDeFiStateSnapshotHeader::NetworkMagic(Params());
+    header.dbVersion = CCustomCSView::DbVersion;
+    header.height = 100;
+    header.blockHash = uint256S("01");
+    return header;
+}
+
+static CDeFiStateSnapshotTrailer Dump(const fs::path &path, CStorageLevelDB &customcs, CStorageLevelDB &burn) {
+    CAutoFile file(fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION);
+    std::vector<CDeFiStateSnapshotSource> sources;
+    sources.push_back({SnapshotSection::CustomCS, customcs.NewIterator(), {}});
+    // left out records do not count in the roots
+    sources.push_back({SnapshotSection::BurnHistory, burn.NewIterator(), [](TBytesView key) { return key[0] == 'x'; }});
+    auto trailer = DumpDeFiStateSnapshot(file, Header(), sources);
+    BOOST_REQUIRE(trailer);
+    return *trailer;
+}
+
+static ResVal<CDeFiStateSnapshotTrailer> Load(const fs::path &path, CStorageLevelDB &customcs, CStorageLevelDB &burn) {
+    CAutoFile file(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+    CDeFiStateSnapshotHeader header;
+    file >> header;
+    BOOST_CHECK(header.Check(Params()));
+    BOOST_CHECK_EQUAL(header.height, 100);
+    std::array<CStorageKV *, SNAPSHOT_SECTIONS> targets{};
+    targets[static_cast<uint8_t>(SnapshotSection::CustomCS)] = &customcs;
+    targets[static_cast<uint8_t>(SnapshotSection::BurnHistory)] = &burn;
+    return LoadDeFiStateSnapshot(file, targets);
+}
+
+BOOST_FIXTURE_TEST_SUITE(defistate_snapshot_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(snapshot_round_trip)
+{
+    CStorageLevelDB customcs(GetDataDir() / "snapshot_customcs", 1 << 20, true);
+    CStorageLevelDB burn(GetDataDir() / "snapshot_burn", 1 << 20, true);
+    // several chunks with keys sharing prefixes, a value of every size
+    for (uint32_t i = 0; i < SNAPSHOT_CHUNK_RECORDS * 2 + 17; ++i) {
+        customcs.Write(Bytes(strprintf("k%08d", i)), TBytes(i % 64, static_cast<unsigned char>(i)));
+    }
+    burn.Write(Bytes("burn"), Bytes("value"));
+    burn.Write(Bytes("x"), Bytes("left out"));
+    BOOST_REQUIRE(customcs.Flush() && burn.Flush());
+
+    const auto path = GetDataDir() / "defistate.dat";
+    const auto trailer = Dump(path, customcs, burn);
+    BOOST_CHECK_EQUAL(trailer.records, SNAPSHOT_CHUNK_RECORDS * 2 + 18);
+    BOOST_CHECK(trailer.sectionRoots[static_cast<uint8_t>(SnapshotSection::Coins)].IsNull());
+
+    CStorageLevelDB loadedCustomcs(GetDataDir() / "loaded_customcs", 1 << 20, true);
+    CStorageLevelDB loadedBurn(GetDataDir() / "loaded_burn", 1 << 20, true);
+    const auto loaded = Load(path, loadedCustomcs, loadedBurn);
+    BOOST_REQUIRE(loaded);
+    BOOST_CHECK(loaded->stateRoot == trailer.stateRoot);
+    BOOST_CHECK(Records(loadedCustomcs) == Records(customcs));
+    BOOST_CHECK_EQUAL(Records(loadedBurn).size(), 1);
+
+    // the same state dumps to the same root
+    const auto again = Dump(GetDataDir() / "defistate2.dat", loadedCustomcs, loadedBurn);
+    BOOST_CHECK(again.stateRoot == trailer.stateRoot);
+
+    // a different state does not
+    customcs.Write(Bytes("k00000005"), Bytes("changed"));
+    BOOST_REQUIRE(customcs.Flush());
+    BOOST_CHECK(Dump(GetDataDir() / "defistate3.dat", customcs, burn).stateRoot != trailer.stateRoot);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_corruption)
+{
+    CStorageLevelDB customcs(GetDataDir() / "corrupt_customcs", 1 << 20, true);
+    CStorageLevelDB burn(GetDataDir() / "corrupt_burn", 1 << 20, true);
+    for (uint32_t i = 0; i < 100; ++i) {
+        customcs.Write(Bytes(strprintf("k%08d", i)), Bytes("value"));
+    }
+    BOOST_REQUIRE(customcs.Flush());
+
+    const auto path = GetDataDir() / "corrupt.dat";
+    Dump(path, customcs, burn);
+
+    // flip a byte of the first chunk's payload
+    std::vector<char> contents;
+    {
+        CAutoFile file(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+        contents.resize(fs::file_size(path));
+        file.read(contents.data(), contents.size());
+    }
+    contents[::GetSerializeSize(Header(), CLIENT_VERSION) + 20] ^= 1;
+    {
+        CAutoFile file(fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION);
+        file.write(contents.data(), contents.size());
+    }
+
+    CStorageLevelDB loadedCustomcs(GetDataDir() / "corrupt_loaded_customcs", 1 << 20, true);
+    CStorageLevelDB loadedBurn(GetDataDir() / "corrupt_loaded_burn", 1 << 20, true);
+    const auto loaded = Load(path, loadedCustomcs, loadedBurn);
+    BOOST_CHECK(!loaded);
+    BOOST_CHECK_EQUAL(loaded.msg, "chunk 0 is corrupted");
+    BOOST_CHECK(Records(loadedCustomcs).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
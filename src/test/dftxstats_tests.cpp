@@ -0,0 +1,94 @@
+#include <test/setup_common.h>
+
+#include <masternodes/dftxstats.h>
+#include <masternodes/masternodes.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dftxstats_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+    CDfTxHistogram histogram;
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 0);
+
+    for (uint64_t value : {0, 1, 2, 3, 4, 100, 1000}) {
+        histogram.Add(value);
+    }
+    BOOST_CHECK_EQUAL(histogram.count, 7);
+    BOOST_CHECK_EQUAL(histogram.sum, 1110);
+    BOOST_CHECK_EQUAL(histogram.max, 1000);
+    BOOST_CHECK_EQUAL(histogram.buckets[0], 1);
+    BOOST_CHECK_EQUAL(histogram.buckets[1], 1);
+    BOOST_CHECK_EQUAL(histogram.buckets[2], 2);
+    BOOST_CHECK_EQUAL(histogram.buckets[3], 1);
+    BOOST_CHECK_EQUAL(histogram.buckets[7], 1);
+    BOOST_CHECK_EQUAL(histogram.buckets[10], 1);
+
+    // the upper bound of the bucket, capped at the largest value
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 3);
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.8), 127);
+    BOOST_CHECK_EQUAL(histogram.Quantile(1), 1000);
+
+    // the last bucket takes what does not fit
+    histogram.Add(std::numeric_limits<uint64_t>::max());
+    BOOST_CHECK_EQUAL(histogram.buckets[CDfTxHistogram::BUCKETS - 1], 1);
+    BOOST_CHECK_EQUAL(histogram.Quantile(1), std::numeric_limits<uint64_t>::max());
+}
+
+BOOST_AUTO_TEST_CASE(scope_samples)
+{
+    CCustomCSView mnview(*pcustomcsview);
+    dftxStats.clear();
+
+    // inactive, nothing is recorded
+    {
+        CDfTxStatsScope stats("inactive", mnview.GetStorage().GetRaw());
+        mnview.SetDexStatsLastHeight(1);
+        stats.Stop();
+    }
+    BOOST_CHECK(dftxStats.getMap().empty());
+
+    dftxStats.setActive(true);
+    {
+        CCustomCSView view(mnview);
+        CDfTxStatsScope stats("SetHeight", view.GetStorage().GetRaw());
+        view.SetDexStatsLastHeight(2);
+        BOOST_CHECK_EQUAL(*view.GetDexStatsLastHeight(), 2);
+        stats.Stop();
+        view.Flush();
+    }
+    {
+        // only the entries added by the scope count
+        CDfTxStatsScope stats("Failed", mnview.GetStorage().GetRaw());
+        mnview.GetDexStatsEnabled();
+    }
+    dftxStats.setActive(false);
+
+    const auto map = dftxStats.getMap();
+    BOOST_REQUIRE_EQUAL(map.size(), 2);
+
+    const auto &set = map.at("SetHeight");
+    BOOST_CHECK_EQUAL(set.wallMicros.count, 1);
+    BOOST_CHECK_EQUAL(set.failures, 0);
+    BOOST_CHECK_EQUAL(set.reads.sum, 1);
+    BOOST_CHECK_EQUAL(set.writes.sum, 1);
+    // the settings key and an int32 value, written then read back
+    BOOST_CHECK_EQUAL(set.bytes.sum, 2 * (2 + mnview.DEX_STATS_LAST_HEIGHT.size() + 4));
+    BOOST_CHECK_EQUAL(set.mapEntries.sum, 1);
+
+    const auto &failed = map.at("Failed");
+    BOOST_CHECK_EQUAL(failed.failures, 1);
+    BOOST_CHECK_EQUAL(failed.reads.sum, 1);
+    BOOST_CHECK_EQUAL(failed.writes.sum, 0);
+    BOOST_CHECK_EQUAL(failed.mapEntries.sum, 0);
+
+    const auto prometheus = dftxStats.toPrometheus();
+    BOOST_CHECK(prometheus.find("defi_dftx_storage_writes_count{type=\"SetHeight\"} 1\n") != std::string::npos);
+    BOOST_CHECK(prometheus.find("defi_dftx_failures_total{type=\"Failed\"} 1\n") != std::string::npos);
+
+    dftxStats.clear();
+    BOOST_CHECK(dftxStats.getMap().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -509,4 +509,312 @@ BOOST_AUTO_TEST_CASE(owner_rewards)
     });
 }
 
+BOOST_AUTO_TEST_CASE(accrued_rewards)
+{
+    CCustomCSView mnview(*pcustomcsview);
+
+    auto& bayfrontGardensHeight = const_cast<int&>(Params().GetConsensus().BayfrontGardensHeight);
+    const auto savedBayfrontGardensHeight = bayfrontGardensHeight;
+    bayfrontGardensHeight = 30;
+
+    DCT_ID idA, idB, idPool;
+    std::tie(idA, idB, idPool) = CreatePoolNTokens(mnview, "ACC", "BCC");
+    const auto idCustom = CreateToken(mnview, "CCC");
+    const CScript owner = CScript(idPool.v * 10 + 1);
+    const CScript other = CScript(idPool.v * 10 + 2);
+
+    BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, 3 * COIN, 7 * COIN, owner));
+    BOOST_REQUIRE(mnview.SetRewardPct(idPool, 1, COIN / 3));
+    BOOST_REQUIRE(mnview.SetRewardLoanPct(idPool, 1, COIN / 7));
+    BOOST_REQUIRE(mnview.SetDailyReward(3, 123456789 * COIN / 100));
+
+    // pool variables changing across the precision switch at 30
+    auto updatePool = [&](uint32_t height, CAmount addedLiquidity, CAmount commissionA, CAmount commissionB) {
+        auto pool = mnview.GetPoolPair(idPool);
+        BOOST_REQUIRE(pool);
+        if (addedLiquidity) {
+            BOOST_REQUIRE(pool->AddLiquidity(addedLiquidity, addedLiquidity * 7 / 3, [&](CAmount liqAmount) {
+                return mnview.AddBalance(other, {idPool, liqAmount});
+            }, false));
+        }
+        pool->swapEvent = commissionA || commissionB;
+        pool->blockCommissionA = commissionA;
+        pool->blockCommissionB = commissionB;
+        BOOST_REQUIRE(mnview.SetPoolPair(idPool, height, *pool));
+    };
+    updatePool(5, 0, 333333, 777777);
+    updatePool(12, 11 * COIN / 10, 0, 0);
+    updatePool(20, 0, 1234567, 89);
+    BOOST_REQUIRE(mnview.SetDailyReward(25, 98765432 * COIN / 100));
+    updatePool(28, 0, 5, 999999999);
+    updatePool(31, 0, 314159, 271828);
+    BOOST_REQUIRE(mnview.SetLoanDailyReward(33, 55555 * COIN));
+    updatePool(35, 23 * COIN / 10, 0, 0);
+    BOOST_REQUIRE(mnview.UpdatePoolPair(idPool, 40, true, -1, {}, CBalances{TAmounts{{idCustom, 7 * COIN + 3}}}));
+    updatePool(44, 0, 161803, 0);
+
+    auto onLiquidity = [&]() -> CAmount {
+        return mnview.GetBalance(owner, idPool).nValue;
+    };
+    using Totals = std::map<std::pair<uint8_t, DCT_ID>, CAmount>;
+    for (const auto& [begin, end] : std::vector<std::pair<uint32_t, uint32_t>>{{1, 60}, {3, 30}, {29, 31}, {30, 31}, {7, 45}, {44, 45}, {50, 60}}) {
+        Totals expected, accrued;
+        mnview.CalculatePoolRewards(idPool, onLiquidity, begin, end,
+            [&](RewardType type, CTokenAmount amount, uint32_t) {
+                expected[{uint8_t(type), amount.nTokenId}] += amount.nValue;
+            }
+        );
+        mnview.AccruePoolRewards(idPool, onLiquidity, begin, end,
+            [&](RewardType type, CTokenAmount amount, uint32_t height, uint32_t count) {
+                BOOST_CHECK(count > 0 && height >= begin && height + count <= end);
+                accrued[{uint8_t(type), amount.nTokenId}] += amount.nValue * count;
+            }
+        );
+        BOOST_CHECK(expected == accrued);
+    }
+
+    // owner rewards credited in runs add up to the per height ones
+    CBalances expected;
+    mnview.CalculatePoolRewards(idPool, onLiquidity, 1, 60,
+        [&](RewardType, CTokenAmount amount, uint32_t) {
+            expected.Add(amount);
+        }
+    );
+    BOOST_REQUIRE(!expected.balances.empty());
+    BOOST_REQUIRE(mnview.CalculateOwnerRewards(owner, 60));
+    for (const auto& [tokenId, amount] : expected.balances) {
+        BOOST_CHECK_EQUAL(mnview.GetBalance(owner, tokenId).nValue, amount);
+    }
+
+    bayfrontGardensHeight = savedBayfrontGardensHeight;
+}
+
+BOOST_AUTO_TEST_CASE(rewards_start_search)
+{
+    CCustomCSView mnview(*pcustomcsview);
+
+    auto& grandCentralHeight = const_cast<int&>(Params().GetConsensus().GrandCentralHeight);
+    const auto savedGrandCentralHeight = grandCentralHeight;
+    grandCentralHeight = 20;
+
+    DCT_ID idA, idB, idPool, idDormant;
+    std::tie(idA, idB, idPool) = CreatePoolNTokens(mnview, "SRA", "SRB");
+    std::tie(idA, idB, idDormant) = CreatePoolNTokens(mnview, "DRA", "DRB");
+    const CScript owner = CScript(idPool.v * 10 + 1);
+    BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, 3 * COIN, 7 * COIN, owner));
+    BOOST_REQUIRE(AddPoolLiquidity(mnview, idDormant, 3 * COIN, 7 * COIN, owner));
+    BOOST_REQUIRE(mnview.SetRewardPct(idPool, 1, COIN / 3));
+
+    auto rewardHeights = [&](DCT_ID poolId, uint32_t begin, uint32_t end) {
+        std::vector<uint32_t> heights;
+        mnview.CalculatePoolRewards(poolId, [&] { return mnview.GetBalance(owner, poolId).nValue; }, begin, end,
+            [&](RewardType type, CTokenAmount, uint32_t height) {
+                if (type == RewardType::Coinbase) {
+                    heights.push_back(height);
+                }
+            }
+        );
+        return heights;
+    };
+    auto range = [](uint32_t begin, uint32_t end) {
+        std::vector<uint32_t> heights;
+        for (auto height = begin; height < end; ++height) {
+            heights.push_back(height);
+        }
+        return heights;
+    };
+
+    // the first reward record comes after the range's first height
+    BOOST_REQUIRE(mnview.SetDailyReward(33, 1000 * COIN));
+    BOOST_CHECK(rewardHeights(idPool, 25, 60) == range(33, 60));
+    BOOST_CHECK(rewardHeights(idPool, 21, 34) == range(33, 34));
+    BOOST_CHECK(rewardHeights(idPool, 25, 33).empty());
+
+    // records before the start height are taken from it on
+    BOOST_REQUIRE(mnview.SetDailyReward(10, 1000 * COIN));
+    BOOST_CHECK(rewardHeights(idPool, 5, 60) == range(20, 60));
+    BOOST_CHECK(rewardHeights(idPool, 12, 60) == range(12, 60));
+
+    // a pool without any reward record pays nothing over a long range
+    uint32_t runs{};
+    mnview.AccruePoolRewards(idDormant, [&] { return mnview.GetBalance(owner, idDormant).nValue; }, 1, 10000000,
+        [&](RewardType, CTokenAmount, uint32_t, uint32_t) {
+            ++runs;
+        }
+    );
+    BOOST_CHECK_EQUAL(runs, 0);
+
+    grandCentralHeight = savedGrandCentralHeight;
+}
+
+BOOST_AUTO_TEST_CASE(owner_share_index)
+{
+    CCustomCSView mnview(*pcustomcsview);
+
+    constexpr const int PoolCount = 6;
+    std::vector<DCT_ID> pools;
+    for (int i = 0; i < PoolCount; ++i) {
+        DCT_ID idA, idB, idPool;
+        std::tie(idA, idB, idPool) = CreatePoolNTokens(mnview, "OA" + std::to_string(i), "OB" + std::to_string(i));
+        BOOST_REQUIRE(mnview.SetRewardPct(idPool, 1, COIN / (i + 2)));
+        pools.push_back(idPool);
+    }
+    BOOST_REQUIRE(mnview.SetDailyReward(1, 1000 * COIN));
+
+    // owner in every other pool, its neighbours in the key order in all of them
+    const CScript before = CScript(7000);
+    const CScript owner = CScript(7001);
+    const CScript after = CScript(7002);
+    for (int i = 0; i < PoolCount; ++i) {
+        if (i % 2 == 0) {
+            BOOST_REQUIRE(AddPoolLiquidity(mnview, pools[i], COIN, COIN, owner));
+        }
+        BOOST_REQUIRE(AddPoolLiquidity(mnview, pools[i], 2 * COIN, 2 * COIN, before));
+        BOOST_REQUIRE(AddPoolLiquidity(mnview, pools[i], 3 * COIN, 3 * COIN, after));
+    }
+
+    auto ownerPools = [&](const CScript& script) {
+        std::vector<DCT_ID> result;
+        mnview.ForEachOwnerShare(script, [&](DCT_ID const & poolId, uint32_t height) {
+            BOOST_CHECK_EQUAL(*mnview.GetShare(poolId, script), height);
+            result.push_back(poolId);
+            return true;
+        });
+        return result;
+    };
+    BOOST_CHECK((ownerPools(owner) == std::vector<DCT_ID>{pools[0], pools[2], pools[4]}));
+    BOOST_CHECK(ownerPools(before) == pools);
+
+    BOOST_REQUIRE(mnview.DelShare(pools[2], owner));
+    BOOST_CHECK((ownerPools(owner) == std::vector<DCT_ID>{pools[0], pools[4]}));
+
+    auto balances = [](CCustomCSView& view, const CScript& script) {
+        std::map<DCT_ID, CAmount> result;
+        view.ForEachBalance([&](const CScript& balanceOwner, const CTokenAmount& balance) {
+            if (balanceOwner != script) {
+                return false;
+            }
+            result.emplace(balance.nTokenId, balance.nValue);
+            return true;
+        }, BalanceKey{script, DCT_ID{0}});
+        return result;
+    };
+
+    // rewards found through the index are the ones found probing every pool
+    BOOST_REQUIRE(!mnview.IsOwnerShareIndexBuilt());
+    CCustomCSView probed(mnview);
+    BOOST_REQUIRE(probed.CalculateOwnerRewards(owner, 20));
+
+    mnview.BuildOwnerShareIndex();
+    BOOST_REQUIRE(mnview.IsOwnerShareIndexBuilt());
+    BOOST_CHECK((ownerPools(owner) == std::vector<DCT_ID>{pools[0], pools[4]}));
+    CCustomCSView indexed(mnview);
+    BOOST_REQUIRE(indexed.CalculateOwnerRewards(owner, 20));
+
+    const auto probedBalances = balances(probed, owner);
+    BOOST_CHECK(probedBalances.size() > 2);
+    BOOST_CHECK(probedBalances == balances(indexed, owner));
+}
+
+BOOST_AUTO_TEST_CASE(pool_pair_graph_paths)
+{
+    struct Pool {
+        DCT_ID id, idTokenA, idTokenB;
+    };
+
+    // paths as found by scanning the pool pairs, in the order they were always tried in
+    auto scanPaths = [](const std::vector<Pool> &pools, DCT_ID from, DCT_ID to) {
+        std::vector<std::vector<DCT_ID>> paths;
+        std::multimap<uint32_t, DCT_ID> fromPoolsID, toPoolsID;
+        for (const auto &pool : pools) {
+            if ((from == pool.idTokenA && to == pool.idTokenB) || (to == pool.idTokenA && from == pool.idTokenB)) {
+                paths.push_back({pool.id});
+            }
+            if (pool.idTokenA == from) {
+                fromPoolsID.emplace(pool.idTokenB.v, pool.id);
+            } else if (pool.idTokenB == from) {
+                fromPoolsID.emplace(pool.idTokenA.v, pool.id);
+            }
+            if (pool.idTokenA == to) {
+                toPoolsID.emplace(pool.idTokenB.v, pool.id);
+            } else if (pool.idTokenB == to) {
+                toPoolsID.emplace(pool.idTokenA.v, pool.id);
+            }
+        }
+        if (fromPoolsID.empty() || toPoolsID.empty()) {
+            return std::vector<std::vector<DCT_ID>>{};
+        }
+        std::map<uint32_t, DCT_ID> commonPairs;
+        std::set_intersection(fromPoolsID.begin(), fromPoolsID.end(), toPoolsID.begin(), toPoolsID.end(),
+                              std::inserter(commonPairs, commonPairs.begin()),
+                              [](auto a, auto b) { return a.first < b.first; });
+        for (const auto &item : commonPairs) {
+            const auto fromIDs = fromPoolsID.equal_range(item.first);
+            const auto toIDs = toPoolsID.equal_range(item.first);
+            for (auto fromID = fromIDs.first; fromID != fromIDs.second; ++fromID) {
+                for (auto toID = toIDs.first; toID != toIDs.second; ++toID) {
+                    paths.push_back({fromID->second, toID->second});
+                }
+            }
+        }
+        for (const auto &pool : pools) {
+            for (auto fromIt = fromPoolsID.begin(); fromIt != fromPoolsID.end(); fromIt = fromPoolsID.equal_range(fromIt->first).second) {
+                for (auto toIt = toPoolsID.begin(); toIt != toPoolsID.end(); toIt = toPoolsID.equal_range(toIt->first).second) {
+                    if ((fromIt->first == pool.idTokenA.v && toIt->first == pool.idTokenB.v) ||
+                        (fromIt->first == pool.idTokenB.v && toIt->first == pool.idTokenA.v)) {
+                        paths.push_back({fromIt->second, pool.id, toIt->second});
+                    }
+                }
+            }
+        }
+        return paths;
+    };
+
+    // random pools over a few tokens, some of them pairing the same tokens
+    const uint32_t tokens = 8;
+    std::vector<Pool> pools;
+    CPoolPairGraph graph;
+    for (uint32_t id = 100; id < 130; ++id) {
+        const DCT_ID idTokenA{static_cast<uint32_t>(InsecureRandRange(tokens))};
+        const DCT_ID idTokenB{(idTokenA.v + 1 + static_cast<uint32_t>(InsecureRandRange(tokens - 1))) % tokens};
+        pools.push_back({DCT_ID{id}, idTokenA, idTokenB});
+        graph.AddPool(DCT_ID{id}, idTokenA, idTokenB);
+    }
+
+    for (uint32_t from = 0; from <= tokens; ++from) {
+        for (uint32_t to = 0; to <= tokens; ++to) {
+            const auto expected = scanPaths(pools, DCT_ID{from}, DCT_ID{to});
+            const auto paths = graph.FindPaths(DCT_ID{from}, DCT_ID{to});
+            BOOST_CHECK(paths == expected);
+        }
+    }
+
+    // views build the graph once and rebuild it once pools are created
+    CCustomCSView mnview(*pcustomcsview);
+    DCT_ID idA, idB, idAB, idC, idD, idCD;
+    std::tie(idA, idB, idAB) = CreatePoolNTokens(mnview, "A", "B");
+    std::tie(idC, idD, idCD) = CreatePoolNTokens(mnview, "C", "D");
+
+    const auto graphAB = mnview.GetPoolPairGraph();
+    BOOST_CHECK(graphAB == mnview.GetPoolPairGraph());
+    BOOST_CHECK(graphAB->FindPaths(idA, idD).empty());
+
+    CCustomCSView child(mnview);
+    BOOST_CHECK(graphAB == child.GetPoolPairGraph());
+
+    CPoolPair pool{};
+    pool.idTokenA = idB;
+    pool.idTokenB = idC;
+    pool.status = true;
+    const auto idBC = CreateToken(child, "B-C", (uint8_t)CToken::TokenFlags::Default | (uint8_t)CToken::TokenFlags::DAT | (uint8_t)CToken::TokenFlags::LPS);
+    BOOST_REQUIRE(child.SetPoolPair(idBC, 1, pool).ok);
+
+    const auto graphBC = child.GetPoolPairGraph();
+    BOOST_CHECK(graphAB != graphBC);
+    BOOST_CHECK(graphAB == mnview.GetPoolPairGraph());
+    const auto paths = graphBC->FindPaths(idA, idD);
+    BOOST_REQUIRE_EQUAL(paths.size(), 1);
+    BOOST_CHECK(paths[0] == std::vector<DCT_ID>({idAB, idBC, idCD}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
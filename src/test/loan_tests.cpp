@@ -1,6 +1,7 @@
 #include <chainparams.h>
 #include <masternodes/loan.h>
 #include <masternodes/masternodes.h>
+#include <masternodes/vaultrisk.h>
 #include <validation.h>
 
 #include <test/setup_common.h>
@@ -528,4 +529,47 @@ BOOST_AUTO_TEST_CASE(auction_batch_creator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(vault_risk_state)
+{
+    const auto vault1 = NextTx(), vault2 = NextTx();
+    const DCT_ID dfi_id{0}, btc_id{1}, tesla_id{2};
+
+    CVaultRiskState state;
+    state.Add(vault1, {CBalances{{{dfi_id, COIN}}}, CBalances{{{tesla_id, COIN}}}, 240});
+    state.Add(vault2, {CBalances{{{dfi_id, COIN}, {btc_id, COIN}}}, {}, 30});
+
+    // evaluated in the order of the heights they are safe until
+    BOOST_REQUIRE_EQUAL(state.bySafeHeight.size(), 2);
+    BOOST_CHECK(state.bySafeHeight.begin()->second == vault2);
+    BOOST_CHECK_EQUAL(state.byToken[dfi_id].size(), 2);
+    BOOST_CHECK_EQUAL(state.byToken[btc_id].size(), 1);
+    BOOST_CHECK_EQUAL(state.byToken[tesla_id].size(), 1);
+
+    // re-adding replaces the entry
+    state.Add(vault2, {CBalances{{{btc_id, COIN}}}, {}, 270});
+    BOOST_REQUIRE_EQUAL(state.bySafeHeight.size(), 2);
+    BOOST_CHECK(state.bySafeHeight.begin()->second == vault1);
+    BOOST_CHECK_EQUAL(state.byToken[dfi_id].size(), 1);
+
+    state.Remove(vault1);
+    BOOST_CHECK_EQUAL(state.vaults.size(), 1);
+    BOOST_CHECK_EQUAL(state.bySafeHeight.size(), 1);
+    BOOST_CHECK(!state.byToken.count(tesla_id));
+    BOOST_CHECK(state.byToken.count(btc_id));
+
+    // only the most recent states are kept
+    CVaultRiskIndex index;
+    std::vector<uint256> blocks;
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(NextTx());
+        auto blockState = std::make_shared<CVaultRiskState>();
+        blockState->height = i * 30;
+        index.Set(blocks.back(), blockState);
+    }
+    BOOST_CHECK(!index.Get(blocks[0]));
+    BOOST_CHECK(!index.Get(blocks[1]));
+    BOOST_REQUIRE(index.Get(blocks[5]));
+    BOOST_CHECK_EQUAL(index.Get(blocks[5])->height, 150);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
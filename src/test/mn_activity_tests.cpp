@@ -0,0 +1,115 @@
+#include <test/setup_common.h>
+
+#include <chainparams.h>
+#include <masternodes/masternodes.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct ActivityTestingSetup : public TestingSetup {
+    ActivityTestingSetup() {
+        gArgs.ForceSetArg("-eunosheight", "1");
+        gArgs.ForceSetArg("-eunospayaheight", "1");
+        SelectParams(CBaseChainParams::REGTEST);
+    }
+
+    ~ActivityTestingSetup() {
+        gArgs.ForceSetArg("-eunosheight", "10000000");
+        gArgs.ForceSetArg("-eunospayaheight", "10000000");
+        SelectParams(CBaseChainParams::REGTEST);
+    }
+};
+
+static CKeyID MakeKey(unsigned char seed) {
+    return CKeyID{uint160{std::vector<unsigned char>(20, seed)}};
+}
+
+static uint256 CreateNode(CCustomCSView &mnview, unsigned char seed, int height) {
+    CMasternode node;
+    node.ownerType = 1;
+    node.operatorType = 1;
+    node.ownerAuthAddress = MakeKey(seed);
+    node.operatorAuthAddress = MakeKey(seed + 1);
+    node.creationHeight = height;
+    const auto nodeId = uint256{std::vector<unsigned char>(32, seed)};
+    BOOST_REQUIRE(mnview.CreateMasternode(nodeId, node, 0));
+    return nodeId;
+}
+
+// Active nodes with whether they minted, as found by checking every record
+static std::map<uint256, bool> ActiveByRecords(CCustomCSView &mnview, int height) {
+    std::map<uint256, bool> active;
+    mnview.ForEachMasternode([&](const uint256 &id, CLazySerialize<CMasternode> node) {
+        if (node.get().IsActive(height, mnview)) {
+            active.emplace(id, node.get().mintedBlocks > 0);
+        }
+        return true;
+    });
+    return active;
+}
+
+static std::map<uint256, bool> ActiveByIndex(CCustomCSView &mnview, int height) {
+    std::map<uint256, bool> active;
+    mnview.ForEachActiveMasternode(height, [&](const uint256 &id, const CMasternodeActivity &activity) {
+        BOOST_CHECK(active.emplace(id, activity.minted).second);
+        return true;
+    });
+    return active;
+}
+
+static void CheckActiveSets(CCustomCSView &mnview, int lastHeight) {
+    for (int height = 0; height <= lastHeight; ++height) {
+        BOOST_CHECK(ActiveByIndex(mnview, height) == ActiveByRecords(mnview, height));
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(mn_activity_tests, ActivityTestingSetup)
+
+BOOST_AUTO_TEST_CASE(active_set_matches_state)
+{
+    CCustomCSView mnview(*pcustomcsview);
+
+    const auto active = CreateNode(mnview, 0x10, 10);
+    const auto resigned = CreateNode(mnview, 0x20, 10);
+    const auto updated = CreateNode(mnview, 0x30, 10);
+    const auto transferred = CreateNode(mnview, 0x40, 10);
+    const auto late = CreateNode(mnview, 0x50, 100);
+    CreateNode(mnview, 0x60, 0);
+
+    auto node = mnview.GetMasternode(resigned);
+    BOOST_REQUIRE(mnview.ResignMasternode(*node, resigned, uint256S("01"), 50));
+
+    node = mnview.GetMasternode(transferred);
+    mnview.UpdateMasternodeCollateral(transferred, *node, uint256S("02"), 40);
+
+    mnview.IncrementMintedBy(active);
+    mnview.IncrementMintedBy(active);
+    mnview.IncrementMintedBy(late);
+
+    // Falls back to the records until the index is built
+    BOOST_CHECK(!mnview.IsMasternodeActivityIndexBuilt());
+    CheckActiveSets(mnview, 200);
+
+    mnview.BuildMasternodeActivityIndex();
+    BOOST_CHECK(mnview.IsMasternodeActivityIndexBuilt());
+    CheckActiveSets(mnview, 200);
+
+    // Kept up to date by the updates after the build
+    node = mnview.GetMasternode(updated);
+    mnview.UpdateMasternodeOperator(updated, *node, 1, MakeKey(0x70), 60);
+    node = mnview.GetMasternode(active);
+    BOOST_REQUIRE(mnview.ResignMasternode(*node, active, uint256S("03"), 150));
+    mnview.DecrementMintedBy(late);
+    CheckActiveSets(mnview, 200);
+
+    // Pending owner changes no longer count once they are done
+    mnview.ErasePendingHeight(MakeKey(0x30));
+    CheckActiveSets(mnview, 200);
+
+    const auto atHeight = ActiveByIndex(mnview, 120);
+    BOOST_CHECK_EQUAL(atHeight.size(), 5);
+    BOOST_CHECK(atHeight.at(active));
+    BOOST_CHECK(!atHeight.at(late));
+    BOOST_CHECK(!atHeight.count(resigned));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
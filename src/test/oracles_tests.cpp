@@ -9,6 +9,7 @@
 #include <masternodes/oracles.h>
 #include <rpc/rawtransaction_util.h>
 #include <masternodes/masternodes.h>
+#include <masternodes/mn_checks.h>
 
 #include <string>
 
@@ -129,4 +130,73 @@ BOOST_FIXTURE_TEST_SUITE(oracles_tests, OraclesTestingSetup)
         BOOST_ASSERT_MSG(dataRes.ok, dataRes.msg.c_str());
     }
 
+    BOOST_AUTO_TEST_CASE(oracle_pair_index_test) {
+        using Submissions = std::map<COracleId, std::tuple<CAmount, int64_t, uint8_t>>;
+        CCustomCSView mnview(*pcustomcsview);
+
+        const CTokenCurrencyPair dfiUsd{"DFI", "USD"}, tokUsd{"TOK", "USD"};
+        // submissions of the pair as read from the oracles themselves
+        auto fromOracles = [&](const CTokenCurrencyPair &pair) {
+            Submissions submissions;
+            mnview.ForEachOracle([&](const COracleId &oracleId, COracle oracle) {
+                auto token = oracle.tokenPrices.find(pair.first);
+                if (token != oracle.tokenPrices.end() && token->second.count(pair.second)) {
+                    const auto &[price, timestamp] = token->second.at(pair.second);
+                    submissions.emplace(oracleId, std::make_tuple(price, timestamp, oracle.weightage));
+                }
+                return true;
+            });
+            return submissions;
+        };
+        auto fromIndex = [&](const CTokenCurrencyPair &pair) {
+            Submissions submissions;
+            mnview.ForEachOraclePairSubmission(pair, [&](const COracleId &oracleId, const COraclePairSubmission &submission) {
+                submissions.emplace(oracleId, std::make_tuple(submission.price, submission.timestamp, submission.weightage));
+                return true;
+            });
+            return submissions;
+        };
+
+        COracleId oracleId1{rawVector1};
+        COracleId oracleId2{rawVector2};
+        std::vector<unsigned char> tmp{'a', 'b', 'c'};
+        CScript oracleAddress{tmp.begin(), tmp.end()};
+        COracle oracle;
+        static_cast<CAppointOracleMessage&>(oracle) = CAppointOracleMessage{oracleAddress, 15, {dfiUsd, tokUsd}};
+        BOOST_REQUIRE(mnview.AppointOracle(oracleId1, oracle));
+        BOOST_REQUIRE(mnview.AppointOracle(oracleId2, oracle));
+
+        const int64_t time = 1000000;
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId1, time, {{"DFI", {{"USD", 2 * COIN}}}, {"TOK", {{"USD", 5 * COIN}}}}));
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId2, time, {{"DFI", {{"USD", 4 * COIN}}}}));
+
+        // aggregates match before and after indexing
+        BOOST_CHECK(!mnview.IsOraclePairIndexBuilt());
+        const auto legacyPrice = GetAggregatePrice(mnview, "DFI", "USD", time);
+        BOOST_REQUIRE(legacyPrice);
+        mnview.BuildOraclePairIndex();
+        BOOST_CHECK(mnview.IsOraclePairIndexBuilt());
+        const auto indexedPrice = GetAggregatePrice(mnview, "DFI", "USD", time);
+        BOOST_REQUIRE(indexedPrice);
+        BOOST_CHECK_EQUAL(*legacyPrice, 3 * COIN);
+        BOOST_CHECK_EQUAL(*indexedPrice, *legacyPrice);
+        BOOST_CHECK(fromIndex(dfiUsd) == fromOracles(dfiUsd));
+        BOOST_CHECK(fromIndex(tokUsd) == fromOracles(tokUsd));
+
+        // updates drop the pairs no longer supported and take the new weightage
+        COracle updated;
+        static_cast<CAppointOracleMessage&>(updated) = CAppointOracleMessage{oracleAddress, 20, {dfiUsd}};
+        BOOST_REQUIRE(mnview.UpdateOracle(oracleId1, std::move(updated)));
+        BOOST_CHECK(fromIndex(tokUsd).empty());
+        BOOST_CHECK(fromIndex(dfiUsd) == fromOracles(dfiUsd));
+        BOOST_CHECK_EQUAL(std::get<2>(fromIndex(dfiUsd).at(oracleId1)), 20);
+
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId2, time + 10, {{"DFI", {{"USD", 6 * COIN}}}}));
+        BOOST_CHECK(fromIndex(dfiUsd) == fromOracles(dfiUsd));
+
+        BOOST_REQUIRE(mnview.RemoveOracle(oracleId2));
+        BOOST_CHECK(fromIndex(dfiUsd) == fromOracles(dfiUsd));
+        BOOST_CHECK_EQUAL(fromIndex(dfiUsd).size(), 1);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
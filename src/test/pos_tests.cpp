@@ -203,5 +203,75 @@ BOOST_AUTO_TEST_CASE(check_subnode)
     BOOST_CHECK_EQUAL(ctxState.subNode, 3);
 }
 
+BOOST_AUTO_TEST_CASE(kernel_search)
+{
+    const auto stakeModifier = uint256S(std::string(64, '1'));
+    const auto masternodeID = stakeModifier;
+    const std::vector<int64_t> subNodesBlockTime{0, 100, 200, 300};
+    const auto& params = Params().GetConsensus();
+
+    // pre DakotaCrescent, DakotaCrescent and EunosPaya kernels, over all timelocks
+    for (uint64_t blockHeight : {uint64_t{0}, uint64_t(params.DakotaCrescentHeight), uint64_t{10000000}}) {
+        for (uint16_t timelock : {uint16_t{CMasternode::ZEROYEAR}, uint16_t{CMasternode::FIVEYEAR}, uint16_t{CMasternode::TENYEAR}}) {
+            for (uint32_t nBits : {0x1d00ffffu, 0x1effffffu}) {
+                const pos::CKernelSearch kernelSearch(stakeModifier, nBits, 0, blockHeight, masternodeID, params, subNodesBlockTime, timelock);
+                for (int64_t step : {-1, 1}) {
+                    const int64_t start = 1000;
+                    const size_t count = 37;
+                    CheckContextState expectedState, ctxState;
+                    std::optional<int64_t> expected;
+                    for (size_t i = 0; i < count && !expected; ++i) {
+                        const auto time = start + step * static_cast<int64_t>(i);
+                        if (pos::CheckKernelHash(stakeModifier, nBits, 0, time, blockHeight, masternodeID, params, subNodesBlockTime, timelock, expectedState)) {
+                            expected = time;
+                        }
+                    }
+                    BOOST_CHECK(kernelSearch.Search(start, step, count, ctxState) == expected);
+                    BOOST_CHECK_EQUAL(ctxState.subNode, expectedState.subNode);
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(kernel_search_eunospaya_before_dakotacrescent)
+{
+    const auto stakeModifier = uint256S(std::string(64, '2'));
+    const auto masternodeID = stakeModifier;
+    const std::vector<int64_t> subNodesBlockTime{0, 0, 0, 0};
+    const uint16_t timelock{CMasternode::TENYEAR};
+    auto params = Params().GetConsensus();
+    params.EunosPayaHeight = 10;
+    params.DakotaCrescentHeight = 100;
+    const uint64_t blockHeight{50};
+    const auto collateral = static_cast<uint64_t>(GetMnCollateralAmount(0));
+
+    // subnode kernels are weighted by their coin age as validation does
+    bool weighted{false};
+    for (uint32_t size = 0x17; size <= 0x1d; ++size) {
+        const uint32_t nBits = (size << 24) | 0x7fffff;
+        arith_uint256 target;
+        target.SetCompact(nBits);
+        const pos::CKernelSearch kernelSearch(stakeModifier, nBits, 0, blockHeight, masternodeID, params, subNodesBlockTime, timelock);
+        const int64_t start = 2000000;
+        const size_t count = 500;
+        CheckContextState expectedState, ctxState;
+        std::optional<int64_t> expected;
+        for (size_t i = 0; i < count && !expected; ++i) {
+            const auto time = start + static_cast<int64_t>(i);
+            if (pos::CheckKernelHash(stakeModifier, nBits, 0, time, blockHeight, masternodeID, params, subNodesBlockTime, timelock, expectedState)) {
+                expected = time;
+            }
+        }
+        BOOST_CHECK(kernelSearch.Search(start, 1, count, ctxState) == expected);
+        BOOST_CHECK_EQUAL(ctxState.subNode, expectedState.subNode);
+        if (expected) {
+            const auto hash = pos::CalcKernelHashMulti(stakeModifier, 0, *expected, masternodeID, expectedState.subNode);
+            weighted |= UintToArith256(hash) / collateral > target;
+        }
+    }
+    BOOST_CHECK(weighted);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
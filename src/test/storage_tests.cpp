@@ -3,7 +3,11 @@
 
 #include <interfaces/chain.h>
 #include <key_io.h>
+#include <masternodes/accountshistory.h>
+#include <masternodes/govvariables/attributes.h>
 #include <masternodes/masternodes.h>
+#include <masternodes/mn_checks.h>
+#include <masternodes/speculative.h>
 #include <rpc/rawtransaction_util.h>
 #include <test/setup_common.h>
 
@@ -121,6 +125,58 @@ BOOST_AUTO_TEST_CASE(undo)
     BOOST_CHECK(snapStart == TakeSnapshot(base_raw));
 }
 
+BOOST_AUTO_TEST_CASE(compact_undo)
+{
+    CUndo undo;
+    auto amount = [](uint64_t value) {
+        TBytes bytes(8);
+        WriteLE64(bytes.data(), value);
+        return bytes;
+    };
+    for (uint8_t i = 0; i < 50; ++i) {
+        TBytes key{'b'};
+        key.insert(key.end(), 24, 0x42);
+        key.push_back(i);
+        undo.before.emplace(key, amount(COIN * i + i));
+    }
+    undo.before.emplace(ToBytes("negative"), amount(static_cast<uint64_t>(-COIN)));
+    undo.before.emplace(ToBytes("erased"), std::nullopt);
+    undo.before.emplace(ToBytes("raw"), TBytes(100, 0x17));
+    undo.before.emplace(TBytes{}, ToBytes("empty key"));
+
+    CCustomCSView mnview(*pcustomcsview);
+    const UndoKey key1{10, uint256S("0x1")}, key2{20, uint256S("0x2")}, key3{30, uint256S("0x3")};
+    BOOST_CHECK(mnview.SetUndo(key1, undo));
+
+    // decoded as written, hashed the same as before
+    const auto decoded = mnview.GetUndo(key1);
+    BOOST_REQUIRE(decoded);
+    BOOST_CHECK(decoded->before == undo.before);
+    BOOST_CHECK(DbTypeToBytes(*decoded) == DbTypeToBytes(undo));
+
+    TBytes stored;
+    BOOST_REQUIRE(mnview.Read(std::make_pair(CUndosView::ByUndoKey::prefix(), key1), stored));
+    const auto plain = DbTypeToBytes(undo);
+    BOOST_CHECK_LT(stored.size(), plain.size() / 2);
+    BOOST_CHECK_EQUAL(*CCompactUndo::PlainSize(MakeBytesView(stored)), plain.size());
+
+    // plain undos of earlier versions are still read
+    BOOST_CHECK(mnview.WriteBy<CUndosView::ByUndoKey>(key2, undo));
+    const auto legacy = mnview.GetUndo(key2);
+    BOOST_REQUIRE(legacy);
+    BOOST_CHECK(legacy->before == undo.before);
+    BOOST_CHECK_EQUAL(*CCompactUndo::PlainSize(MakeBytesView(plain)), plain.size());
+
+    BOOST_CHECK(mnview.SetUndo(key3, undo));
+    const auto result = mnview.PruneUndos(30);
+    BOOST_CHECK_EQUAL(result.records, 2);
+    BOOST_CHECK_EQUAL(result.bytes, stored.size() + plain.size());
+    BOOST_CHECK_EQUAL(result.plainBytes, 2 * plain.size());
+    BOOST_CHECK(!mnview.GetUndo(key1));
+    BOOST_CHECK(!mnview.GetUndo(key2));
+    BOOST_CHECK(mnview.GetUndo(key3));
+}
+
 BOOST_AUTO_TEST_CASE(recipients)
 {
     auto testChain = interfaces::MakeChain();
@@ -439,4 +495,272 @@ BOOST_AUTO_TEST_CASE(LowerBoundTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(IteratorViewsTest)
+{
+    // values on disk, in the base cache and in a layer on top of it
+    pcustomcsview->WriteBy<TestForward>(TestForward{1}, 1);
+    pcustomcsview->WriteBy<TestForward>(TestForward{2}, 2);
+    pcustomcsview->Flush();
+    pcustomcsDB->Flush();
+    pcustomcsview->WriteBy<TestForward>(TestForward{3}, 3);
+
+    CCustomCSView view(*pcustomcsview);
+    view.WriteBy<TestForward>(TestForward{2}, 20);
+    view.WriteBy<TestForward>(TestForward{4}, 4);
+
+    auto it = view.GetStorage().NewIterator();
+    it->Seek(DbTypeToBytes(std::make_pair(TestForward::prefix(), TestForward{1})));
+    const std::vector<std::pair<uint32_t, int>> expected{{1, 1}, {2, 20}, {3, 3}, {4, 4}};
+    for (const auto& [n, value] : expected) {
+        BOOST_REQUIRE(it->Valid());
+        auto key = it->KeyView();
+        BOOST_CHECK(TBytes(key.begin(), key.end()) == it->Key());
+        std::pair<uint8_t, TestForward> decodedKey;
+        BOOST_CHECK(BytesToDbType(key, decodedKey));
+        BOOST_CHECK_EQUAL(decodedKey.second.n, n);
+        int decodedValue{};
+        BOOST_CHECK(BytesToDbType(it->ValueView(), decodedValue));
+        BOOST_CHECK_EQUAL(decodedValue, value);
+        it->Next();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WriteBufferTest)
+{
+    auto toKey = [](uint32_t n) {
+        return DbTypeToBytes(WrapBigEndian(n));
+    };
+    CKVWriteBuffer buffer;
+    std::map<TBytes, std::optional<TBytes>> expected;
+    // enough keys to have the recent insertions merged in several times
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto key = toKey((i * 7919) % 1000);
+        auto value = DbTypeToBytes(i);
+        if (i % 5 == 0) {
+            buffer.Erase(MakeBytesView(key));
+            expected[key] = {};
+        } else {
+            buffer.Write(MakeBytesView(key), MakeBytesView(value));
+            expected[key] = value;
+        }
+    }
+    // overwrite with a longer value and resurrect an erased key
+    auto longValue = ToBytes("a value longer than four bytes");
+    buffer.Write(MakeBytesView(expected.begin()->first), MakeBytesView(longValue));
+    expected.begin()->second = longValue;
+
+    BOOST_CHECK_EQUAL(buffer.Size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& [key, value] : buffer) {
+        BOOST_REQUIRE(it != expected.end());
+        BOOST_CHECK(TBytes(key.begin(), key.end()) == it->first);
+        BOOST_CHECK_EQUAL(bool(value), bool(it->second));
+        if (value) {
+            BOOST_CHECK(TBytes(value->begin(), value->end()) == *it->second);
+        }
+        ++it;
+    }
+    BOOST_CHECK(it == expected.end());
+
+    // cursor keeps its position across insertions before and after it
+    CKVWriteBuffer::Cursor cursor(buffer);
+    auto middle = toKey(500);
+    cursor.Seek(MakeBytesView(middle));
+    BOOST_REQUIRE(cursor.Valid());
+    buffer.Write(MakeBytesView(toKey(2000)), MakeBytesView(longValue));
+    buffer.Write(MakeBytesView(toKey(1500)), MakeBytesView(longValue));
+    BOOST_CHECK(TBytes(cursor.Key().begin(), cursor.Key().end()) == middle);
+    cursor.Next();
+    BOOST_CHECK(TBytes(cursor.Key().begin(), cursor.Key().end()) == toKey(501));
+    cursor.SeekBefore(MakeBytesView(toKey(2000)));
+    BOOST_CHECK(TBytes(cursor.Key().begin(), cursor.Key().end()) == toKey(1500));
+
+    buffer.Clear();
+    BOOST_CHECK(buffer.Empty());
+    BOOST_CHECK(!(buffer.begin() != buffer.end()));
+}
+
+BOOST_AUTO_TEST_CASE(ViewReadCacheTest)
+{
+    CTokenImplementation token;
+    token.symbol = "CACHE";
+    token.creationTx = uint256S("0x2222");
+    auto id = pcustomcsview->CreateToken(token, false);
+    BOOST_REQUIRE(id.ok);
+    const auto tokenId = *id.val;
+
+    // repeated reads are served from the cache, by a child view too
+    BOOST_REQUIRE(pcustomcsview->GetToken(tokenId));
+    const auto hits = viewCacheStats.tokens.hits.load();
+    BOOST_CHECK_EQUAL(pcustomcsview->GetToken(tokenId)->symbol, "CACHE");
+    CCustomCSView view(*pcustomcsview);
+    BOOST_CHECK_EQUAL(view.GetToken(tokenId)->symbol, "CACHE");
+    BOOST_CHECK_EQUAL(viewCacheStats.tokens.hits.load(), hits + 2);
+
+    // writes to the child are seen by it only, until discarded or flushed
+    auto changed = *view.GetToken(tokenId);
+    changed.symbol = "CHANGED";
+    BOOST_REQUIRE(view.WriteBy<CTokensView::ID>(tokenId, changed));
+    BOOST_CHECK_EQUAL(view.GetToken(tokenId)->symbol, "CHANGED");
+    BOOST_CHECK_EQUAL(pcustomcsview->GetToken(tokenId)->symbol, "CACHE");
+    view.Discard();
+    BOOST_CHECK_EQUAL(view.GetToken(tokenId)->symbol, "CACHE");
+    BOOST_REQUIRE(view.WriteBy<CTokensView::ID>(tokenId, changed));
+    view.Flush();
+    BOOST_CHECK_EQUAL(pcustomcsview->GetToken(tokenId)->symbol, "CHANGED");
+
+    // attributes are handed out as copies of the cached ones
+    CDataStructureV0 lockKey{AttributeTypes::Locks, ParamIDs::TokenID, tokenId.v};
+    auto attributes = view.GetAttributes();
+    BOOST_REQUIRE(attributes);
+    attributes->SetValue(lockKey, true);
+    BOOST_CHECK(!view.AreTokensLocked({tokenId.v}));
+    BOOST_REQUIRE(view.SetVariable(*attributes));
+    BOOST_CHECK(view.AreTokensLocked({tokenId.v}));
+    BOOST_CHECK(!pcustomcsview->AreTokensLocked({tokenId.v}));
+    view.Discard();
+    BOOST_CHECK(!view.AreTokensLocked({tokenId.v}));
+}
+
+BOOST_AUTO_TEST_CASE(ReadSetTest)
+{
+    auto key = [](unsigned char prefix, unsigned char n) { return TBytes{prefix, n}; };
+    CCustomCSView view(*pcustomcsview);
+    for (unsigned char n = 2; n <= 10; n += 2) {
+        BOOST_REQUIRE(view.GetStorage().Write(key(0xF0, n), TBytes{1}));
+    }
+
+    CReadTrackingStorageKV tracker(view.GetStorage());
+    TBytes value;
+    tracker.Read(key(0xF1, 1), value);
+    {
+        // walks the keys 4 and 6
+        auto it = tracker.NewIterator();
+        it->Seek(key(0xF0, 3));
+        it->Next();
+        BOOST_REQUIRE(it->Valid());
+        BOOST_CHECK(TBytes(it->KeyView().begin(), it->KeyView().end()) == key(0xF0, 6));
+    }
+    const auto reads = tracker.TakeReads();
+
+    BOOST_CHECK(!reads.Intersects({}));
+    BOOST_CHECK(reads.Intersects({key(0xF1, 1)}));
+    BOOST_CHECK(!reads.Intersects({key(0xF1, 2)}));
+    // keys inserted into the walked range change what the walk would have seen
+    BOOST_CHECK(reads.Intersects({key(0xF0, 5)}));
+    BOOST_CHECK(reads.Intersects({key(0xF0, 3)}));
+    BOOST_CHECK(!reads.Intersects({key(0xF0, 2), key(0xF0, 7)}));
+}
+
+BOOST_AUTO_TEST_CASE(AccountHistorySegmentTest)
+{
+    CAccountHistoryStorage history(GetDataDir() / "history_segments", 1 << 20, true);
+    const CScript alice = CScript() << OP_1;
+    const CScript bob = CScript() << OP_2;
+    const auto swap = static_cast<uint8_t>(CustomTxType::PoolSwap);
+    const auto send = static_cast<uint8_t>(CustomTxType::AccountToAccount);
+
+    // swaps in the first and the third segment only
+    const auto segment = ACCOUNT_HISTORY_SEGMENT_SIZE;
+    history.WriteAccountHistory({alice, 10, 0}, {uint256S("0x01"), swap, {{DCT_ID{1}, 5}}});
+    history.WriteAccountHistory({bob, 10, 1}, {uint256S("0x02"), send, {{DCT_ID{0}, 5}}});
+    history.WriteAccountHistory({alice, segment + 10, 0}, {uint256S("0x03"), send, {{DCT_ID{0}, 5}}});
+    history.WriteAccountHistory({bob, segment + 20, 0}, {uint256S("0x04"), send, {{DCT_ID{0}, 5}}});
+    history.WriteAccountHistory({alice, 2 * segment + 5, 0}, {uint256S("0x05"), swap, {{DCT_ID{2}, 5}}});
+
+    AccountHistorySegmentFilter byAlice, bySwap, byToken1, byToken2, bySwapToken2;
+    byAlice.owners = {alice};
+    bySwap.categories = {swap};
+    byToken1.token = DCT_ID{1};
+    byToken2.token = DCT_ID{2};
+    bySwapToken2 = bySwap;
+    bySwapToken2.token = DCT_ID{2};
+
+    BOOST_CHECK(history.SegmentMatches(1, byAlice));
+    BOOST_CHECK(!history.SegmentMatches(1, bySwap));
+    BOOST_CHECK(!history.SegmentMatches(0, byToken2));
+    BOOST_CHECK(history.SegmentMatches(2, bySwapToken2));
+
+    auto collect = [&](const CScript &owner, const AccountHistorySegmentFilter &filter) {
+        std::vector<uint256> txids;
+        history.ForEachAccountHistory([&](const AccountHistoryKey &key, const AccountHistoryValue &value) {
+            if (!owner.empty() && key.owner != owner) {
+                return false;
+            }
+            txids.push_back(value.txid);
+            return true;
+        }, owner, std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max(), filter);
+        return txids;
+    };
+
+    // every row of the matching segments, none of the others
+    const std::vector<uint256> swapSegments{uint256S("0x05"), uint256S("0x01"), uint256S("0x02")};
+    BOOST_CHECK(collect({}, bySwap) == swapSegments);
+    BOOST_CHECK_EQUAL(collect({}, AccountHistorySegmentFilter{}).size(), 5);
+    const std::vector<uint256> aliceSwaps{uint256S("0x05"), uint256S("0x01")};
+    BOOST_CHECK(collect(alice, bySwap) == aliceSwaps);
+    BOOST_CHECK(collect(bob, byToken1) == std::vector<uint256>{uint256S("0x02")});
+    BOOST_CHECK(collect(bob, byToken2).empty());
+
+    // segments keep their summary once their rows are gone
+    BOOST_REQUIRE(history.EraseAccountHistoryHeight(10));
+    BOOST_CHECK(history.SegmentMatches(0, bySwap));
+    BOOST_CHECK(collect({}, bySwap) == std::vector<uint256>{uint256S("0x05")});
+}
+
+BOOST_AUTO_TEST_CASE(BurnHistoryTotalsTest)
+{
+    CBurnHistoryStorage burns(GetDataDir() / "burn_totals", 1 << 20, true);
+    burns.CreateTotalsIfNeeded();
+    const CScript burnAddress = CScript() << OP_1;
+    const auto utxoBurn = static_cast<uint8_t>(CustomTxType::None);
+    const auto burnToken = static_cast<uint8_t>(CustomTxType::BurnToken);
+    const auto createToken = static_cast<uint8_t>(CustomTxType::CreateToken);
+    const auto swap = static_cast<uint8_t>(CustomTxType::PoolSwap);
+
+    const auto segment = ACCOUNT_HISTORY_SEGMENT_SIZE;
+    burns.WriteAccountHistory({burnAddress, 10, 0}, {uint256S("0x01"), utxoBurn, {{DCT_ID{0}, 5}}});
+    burns.WriteAccountHistory({burnAddress, 10, 1}, {uint256S("0x02"), burnToken, {{DCT_ID{1}, 3}}});
+    burns.WriteAccountHistory({burnAddress, segment + 5, 0}, {uint256S("0x03"), createToken, {{DCT_ID{0}, 1}}});
+    burns.WriteAccountHistory({burnAddress, segment + 5, 1}, {uint256S("0x04"), swap, {{DCT_ID{2}, 2}, {DCT_ID{3}, -1}}});
+    // written again in the same batch, counted once
+    burns.WriteAccountHistory({burnAddress, segment + 5, 1}, {uint256S("0x04"), swap, {{DCT_ID{2}, 2}, {DCT_ID{3}, -1}}});
+
+    // nothing counts before it is flushed
+    BOOST_CHECK_EQUAL(burns.GetTotals().burntDFI, 0);
+    BOOST_REQUIRE(burns.Flush());
+
+    auto totals = burns.GetTotals();
+    BOOST_CHECK_EQUAL(totals.burntDFI, 5);
+    BOOST_CHECK_EQUAL(totals.burntFee, 1);
+    BOOST_CHECK((totals.nonConsortiumTokens.balances == TAmounts{{DCT_ID{1}, 3}}));
+    BOOST_CHECK((totals.dexfeeburn.balances == TAmounts{{DCT_ID{2}, 2}}));
+
+    // as of a height, from the totals of the segments and the rows of its own
+    totals = burns.GetTotals(segment + 4);
+    BOOST_CHECK_EQUAL(totals.burntDFI, 5);
+    BOOST_CHECK_EQUAL(totals.burntFee, 0);
+    BOOST_CHECK(totals.dexfeeburn.balances.empty());
+    totals = burns.GetTotals(9);
+    BOOST_CHECK_EQUAL(totals.burntDFI, 0);
+    BOOST_CHECK(totals.nonConsortiumTokens.balances.empty());
+
+    // layers hand their rows to the storage they are on top of
+    CBurnHistoryStorage layer(burns);
+    layer.WriteAccountHistory({burnAddress, 2 * segment, 0}, {uint256S("0x05"), utxoBurn, {{DCT_ID{0}, 7}}});
+    BOOST_REQUIRE(layer.Flush());
+    BOOST_CHECK_EQUAL(burns.GetTotals().burntDFI, 5);
+    BOOST_REQUIRE(burns.Flush());
+    BOOST_CHECK_EQUAL(burns.GetTotals().burntDFI, 12);
+    BOOST_CHECK_EQUAL(burns.GetTotals(2 * segment - 1).burntDFI, 5);
+
+    // erased rows are taken off again
+    BOOST_REQUIRE(burns.EraseAccountHistoryHeight(segment + 5));
+    BOOST_REQUIRE(burns.Flush());
+    totals = burns.GetTotals();
+    BOOST_CHECK_EQUAL(totals.burntDFI, 12);
+    BOOST_CHECK_EQUAL(totals.burntFee, 0);
+    BOOST_CHECK(totals.dexfeeburn.balances.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodes/threadpool.h>
+
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(threadpool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(parallel_for_and_reduce)
+{
+    for (size_t workers : {0, 1, 4}) {
+        TaskScheduler scheduler(workers);
+
+        const size_t count = 10007;
+        std::vector<std::atomic<int>> visits(count);
+        std::atomic<bool> slotsInRange{true};
+        BOOST_CHECK(scheduler.ParallelFor(0, count, {"test", 13}, [&](size_t i, size_t slot) {
+            if (slot >= scheduler.GetSlotsCount()) {
+                slotsInRange = false;
+            }
+            ++visits[i];
+        }));
+        BOOST_CHECK(slotsInRange);
+        for (const auto &visit : visits) {
+            BOOST_CHECK_EQUAL(visit.load(), 1);
+        }
+
+        auto partials = scheduler.ParallelReduce<uint64_t>(0, count, {"test", 7}, [](uint64_t &sum, size_t i) {
+            sum += i;
+        });
+        uint64_t total{};
+        partials.ForEach([&](uint64_t sum) { total += sum; });
+        BOOST_CHECK_EQUAL(total, uint64_t{count} * (count - 1) / 2);
+
+        // loops started from inside a loop
+        std::atomic<uint64_t> nested{0};
+        scheduler.ParallelFor(0, 8, {"outer"}, [&](size_t, size_t) {
+            scheduler.ParallelFor(0, 100, {"inner", 3}, [&](size_t i, size_t) { nested += i; });
+        });
+        BOOST_CHECK_EQUAL(nested.load(), 8 * 4950);
+
+        auto stats = scheduler.GetTimingStats();
+        BOOST_CHECK_EQUAL(stats["test"].runs, 2);
+        BOOST_CHECK_EQUAL(stats["inner"].runs, 8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_errors)
+{
+    TaskScheduler scheduler(3);
+
+    BOOST_CHECK_THROW(scheduler.ParallelFor(0, 1000, {"throwing"}, [](size_t i, size_t) {
+        if (i == 500) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+
+    // at most two threads at a time
+    std::atomic<int> running{0}, maxRunning{0};
+    scheduler.ParallelFor(0, 200, {"limited", 1, 2}, [&](size_t, size_t) {
+        auto now = ++running;
+        auto max = maxRunning.load();
+        while (now > max && !maxRunning.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        --running;
+    });
+    BOOST_CHECK(maxRunning.load() <= 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
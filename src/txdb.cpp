@@ -5,6 +5,7 @@
 
 #include <txdb.h>
 
+#include <masternodes/threadpool.h>
 #include <pos.h>
 #include <pos_kernel.h>
 #include <random.h>
@@ -14,12 +15,14 @@
 #include <util/system.h>
 #include <util/translation.h>
 
+#include <atomic>
 #include <stdint.h>
 
 static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_BLOCK_INDEX = 'b';
+static const char DB_BLOCK_MINTER = 'k';
 
 static const char DB_BEST_BLOCK = 'B';
 static const char DB_HEAD_BLOCKS = 'H';
@@ -144,6 +147,11 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+bool CCoinsViewDB::IsChainStateRecord(unsigned char prefix)
+{
+    return prefix == DB_COIN || prefix == DB_BEST_BLOCK;
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(gArgs.IsArgSet("-blocksdir") ? GetDataDir() / "blocks" / "index" : GetBlocksDir() / "index", nCacheSize, fMemory, fWipe) {
 }
 
@@ -228,10 +236,21 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        if (!(*it)->minterKeyID.IsNull()) {
+            batch.Write(std::make_pair(DB_BLOCK_MINTER, (*it)->GetBlockHash()), (*it)->minterKeyID);
+        }
     }
     return WriteBatch(batch, true);
 }
 
+bool CBlockTreeDB::WriteMinterKeys(const std::vector<const CBlockIndex*>& blockinfo) {
+    CDBBatch batch(*this);
+    for (const auto pindex : blockinfo) {
+        batch.Write(std::make_pair(DB_BLOCK_MINTER, pindex->GetBlockHash()), pindex->minterKeyID);
+    }
+    return WriteBatch(batch);
+}
+
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
 }
@@ -244,12 +263,21 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool skipSigCheck)
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool skipSigCheck, std::vector<CBlockIndex*>& minterKeysRecovered)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Minter keys are kept apart from the index entries, which older clients rewrite in their own
+    // format. Both are ordered by block hash and are walked side by side.
+    std::unique_ptr<CDBIterator> pminter(NewIterator());
+    pminter->Seek(std::make_pair(DB_BLOCK_MINTER, uint256()));
+    std::pair<char, uint256> minterKey;
+    auto minterValid = [&]() {
+        return pminter->Valid() && pminter->GetKey(minterKey) && minterKey.first == DB_BLOCK_MINTER;
+    };
+
     // Load m_block_index
     while (pcursor->Valid()) {
         if (ShutdownRequested()) return false;
@@ -276,10 +304,14 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->deprecatedHeight = diskindex.deprecatedHeight;
                 pindexNew->mintedBlocks = diskindex.mintedBlocks;
                 pindexNew->sig = diskindex.sig;
-                if (pindexNew->nHeight && !skipSigCheck) {
-                    if (!CPubKey::TryRecoverSigCompat(pindexNew->sig)) {
-                        return error("%s: The block index #%d (%s) wasn't saved on disk correctly. Index content: %s", __func__, pindexNew->nHeight, pindexNew->GetBlockHash().ToString(), pindexNew->ToString());
-                    }
+                while (minterValid() && minterKey.second < key.second) {
+                    pminter->Next();
+                }
+                if (minterValid() && minterKey.second == key.second && !pminter->GetValue(pindexNew->minterKeyID)) {
+                    return error("%s: failed to read minter key", __func__);
+                }
+                if (pindexNew->nHeight && pindexNew->minterKeyID.IsNull()) {
+                    minterKeysRecovered.push_back(pindexNew);
                 }
                 pcursor->Next();
             } else {
@@ -290,6 +322,35 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
+    // Blocks whose minter key was not stored yet recover it once, batched over the DfTx pool
+    const auto time = GetTimeMillis();
+    std::atomic<CBlockIndex*> corrupted{nullptr};
+    auto recoverMinterKey = [&](size_t i, size_t) {
+        auto pindex = minterKeysRecovered[i];
+        if (!skipSigCheck && !CPubKey::TryRecoverSigCompat(pindex->sig)) {
+            corrupted = pindex;
+            return;
+        }
+        pindex->GetBlockHeader().ExtractMinterKey(pindex->minterKeyID);
+    };
+    if (DfTxTaskPool) {
+        DfTxTaskPool->ParallelFor(0, minterKeysRecovered.size(), {"Block index minter keys", 256}, recoverMinterKey);
+    } else {
+        for (size_t i = 0; i < minterKeysRecovered.size(); ++i) {
+            recoverMinterKey(i, 0);
+        }
+    }
+    if (const auto pindex = corrupted.load()) {
+        return error("%s: The block index #%d (%s) wasn't saved on disk correctly. Index content: %s", __func__, pindex->nHeight, pindex->GetBlockHash().ToString(), pindex->ToString());
+    }
+    // without the signature check an entry may be left without a minter key, it is then recovered lazily
+    minterKeysRecovered.erase(std::remove_if(minterKeysRecovered.begin(), minterKeysRecovered.end(), [](const CBlockIndex* pindex) {
+        return pindex->minterKeyID.IsNull();
+    }), minterKeysRecovered.end());
+    if (!minterKeysRecovered.empty()) {
+        LogPrintf("%s: recovered %d minter keys not stored in the block tree (time: %dms)\n", __func__, minterKeysRecovered.size(), GetTimeMillis() - time);
+    }
+
     return true;
 }
 
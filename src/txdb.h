@@ -63,6 +63,11 @@ public:
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
+
+    //! Iterator over the raw records, values are deobfuscated
+    CDBIterator *NewRawIterator() { return db.NewIterator(); }
+    //! Whether a raw record holds a coin or the best block rather than database metadata
+    static bool IsChainStateRecord(unsigned char prefix);
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -94,13 +99,16 @@ public:
     explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
     bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
+    //! Stores the minter keys of index entries, kept apart from the entries themselves
+    bool WriteMinterKeys(const std::vector<const CBlockIndex*>& blockinfo);
     bool ReadBlockFileInfo(int nFile, CBlockFileInfo &info);
     bool ReadLastBlockFile(int &nFile);
     bool WriteReindexing(bool fReindexing);
     void ReadReindexing(bool &fReindexing);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool skipSigCheck);
+    //! Blocks without a stored minter key get it recovered and are added to minterKeysRecovered
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool skipSigCheck, std::vector<CBlockIndex*>& minterKeysRecovered);
 };
 
 #endif // DEFI_TXDB_H
@@ -10,6 +10,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <masternodes/mn_checks.h>
+#include <masternodes/speculative.h>
 #include <validation.h>
 #include <policy/policy.h>
 #include <policy/fees.h>
@@ -325,7 +326,7 @@ void CTxMemPoolEntry::UpdateAncestorState(int64_t modifySize, CAmount modifyFee,
 }
 
 CTxMemPool::CTxMemPool(CBlockPolicyEstimator* estimator)
-    : nTransactionsUpdated(0), minerPolicyEstimator(estimator)
+    : nTransactionsUpdated(0), minerPolicyEstimator(estimator), acviewTracker(std::make_unique<CMempoolDfTxTracker>())
 {
     _clear(); //lock free clear
 
@@ -412,6 +413,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 {
     NotifyEntryRemoved(it->GetSharedTx(), reason);
     const uint256 hash = it->GetTx().GetHash();
+    acviewTracker->TxRemoved(hash);
     for (const CTxIn& txin : it->GetTx().vin)
         mapNextTx.erase(txin.prevout);
 
@@ -609,7 +611,8 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
     if (pcustomcsview) {
         accountsViewDirty |= forceRebuildForReorg;
-        rebuildAccountsView(nBlockHeight, &::ChainstateActive().CoinsTip());
+        CCoinsViewCache coinsCache(&::ChainstateActive().CoinsTip());
+        rebuildAccountsView(nBlockHeight, coinsCache);
     }
 
     lastRollingFeeUpdate = GetTime();
@@ -629,6 +632,7 @@ void CTxMemPool::_clear()
     rollingMinimumFeeRate = 0;
     accountsViewDirty = false;
     forceRebuildForReorg = false;
+    acviewTracker->Reset();
     ++nTransactionsUpdated;
 }
 
@@ -1107,12 +1111,17 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
     }
 }
 
-void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache& coinsCache)
+void CTxMemPool::rebuildAccountsView(int height, CCoinsViewCache& coinsCache)
 {
     if (!pcustomcsview || !accountsViewDirty) {
         return;
     }
 
+    const auto incremental = !forceRebuildForReorg;
+    if (!incremental) {
+        acviewTracker->Reset();
+    }
+
     CAmount txfee = 0;
     accountsView().Discard();
     CCustomCSView viewDuplicate(accountsView());
@@ -1128,15 +1137,19 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache& coinsCac
             LogPrintf("%s: Remove conflicting TX: %s\n", __func__, tx.GetHash().GetHex());
             staged.insert(mapTx.project<0>(it));
             vtx.push_back(it->GetSharedTx());
+            acviewTracker->TxRemoved(tx.GetHash());
             continue;
         }
-        auto res = ApplyCustomTx(viewDuplicate, coinsCache, tx, Params().GetConsensus(), height);
+        // only txs depending on changed state are applied again
+        auto res = acviewTracker->Apply(viewDuplicate, coinsCache, tx, Params().GetConsensus(), height);
         if (!res && (res.code & CustomTxErrCodes::Fatal)) {
             LogPrintf("%s: Remove conflicting custom TX: %s\n", __func__, tx.GetHash().GetHex());
             staged.insert(mapTx.project<0>(it));
             vtx.push_back(it->GetSharedTx());
+            acviewTracker->TxRemoved(tx.GetHash());
         }
     }
+    const auto stats = acviewTracker->Rebuilt();
 
     RemoveStaged(staged, true, MemPoolRemovalReason::BLOCK);
 
@@ -1148,6 +1161,15 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache& coinsCac
     viewDuplicate.Flush();
     accountsViewDirty = false;
     forceRebuildForReorg = false;
+
+    LogPrint(BCLog::MEMPOOL, "%s: %s rebuild, %u txs re-applied, %u skipped, %u removed\n", __func__,
+             incremental ? "incremental" : "full", stats.reapplied, stats.replayed, staged.size());
+}
+
+void CTxMemPool::addAccountsViewChanges(const std::vector<CTransactionRef>& vtx, const CKVWriteBuffer& writes)
+{
+    AssertLockHeld(cs);
+    acviewTracker->BlockChanged(vtx, writes);
 }
 
 uint64_t CTxMemPool::CalculateDescendantMaximum(txiter entry) const {
@@ -32,6 +32,8 @@
 class CBlockIndex;
 class CChainParams;
 class CCustomCSView;
+class CKVWriteBuffer;
+class CMempoolDfTxTracker;
 extern CCriticalSection cs_main;
 
 /** Fake height value used in Coin to signify they are only in the memory pool (since 0.8) */
@@ -553,6 +555,7 @@ private:
     bool accountsViewDirty;
     bool forceRebuildForReorg;
     std::unique_ptr<CCustomCSView> acview;
+    std::unique_ptr<CMempoolDfTxTracker> acviewTracker;
 public:
     indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
     std::map<uint256, CAmount> mapDeltas;
@@ -708,7 +711,9 @@ public:
     boost::signals2::signal<void (CTransactionRef, MemPoolRemovalReason)> NotifyEntryRemoved;
 
     CCustomCSView& accountsView();
-    void rebuildAccountsView(int height, const CCoinsViewCache& coinsCache);
+    void rebuildAccountsView(int height, CCoinsViewCache& coinsCache);
+    /** Records the accounts view state changed by connecting or disconnecting a block */
+    void addAccountsViewChanges(const std::vector<CTransactionRef>& vtx, const CKVWriteBuffer& writes);
 private:
     /** UpdateForDescendants is used by UpdateTransactionsFromBlock to update
      *  the descendants for a single transaction that has been added to the
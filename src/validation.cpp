@@ -24,6 +24,8 @@
 #include <masternodes/govvariables/attributes.h>
 #include <masternodes/historywriter.h>
 #include <masternodes/mn_checks.h>
+#include <masternodes/speculative.h>
+#include <masternodes/statediff.h>
 #include <masternodes/validation.h>
 #include <masternodes/vaulthistory.h>
 #include <policy/fees.h>
@@ -177,6 +179,9 @@ namespace {
 
     /** Dirty block file entries. */
     std::set<int> setDirtyFileInfo;
+
+    /** Block index entries loaded without a stored minter key, written back in the background. */
+    std::vector<const CBlockIndex*> vMinterKeyMigration;
 } // anon namespace
 
 extern std::string ScriptToString(CScript const& script);
@@ -2599,6 +2604,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
 
+    CDfTxSpeculativeExecutor dftxExecutor(block, pindex->nHeight, pindex->GetBlockTime(), chainparams.GetConsensus(), evmQueueId, fDfTxSpeculation);
+
     // Execute TXs
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
@@ -2669,7 +2676,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
             }
 
             const auto applyCustomTxTime = GetTimeMicros();
-            const auto res = ApplyCustomTx(accountsView, view, tx, chainparams.GetConsensus(), pindex->nHeight, pindex->GetBlockTime(), nullptr, i, evmQueueId);
+            const auto res = dftxExecutor.Apply(accountsView, view, i);
 
             LogApplyCustomTx(tx, applyCustomTxTime);
             if (!res.ok && (res.code & CustomTxErrCodes::Fatal)) {
@@ -2870,29 +2877,24 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     }
     mnview.SetLastHeight(pindex->nHeight);
 
+    CUndosView::CountWrittenUndos(mnview.GetStorage().GetRaw());
+    LogPrint(BCLog::BENCH, "    - Undo data: %d records, %d bytes (%d plain) since startup\n",
+             undoStats.written.load(), undoStats.writtenBytes.load(), undoStats.writtenPlainBytes.load());
+
     auto &checkpoints = chainparams.Checkpoints().mapCheckpoints;
     auto it = checkpoints.lower_bound(pindex->nHeight);
     if (it != checkpoints.begin()) {
         --it;
-        bool pruneStarted = false;
         auto time = GetTimeMillis();
         CCustomCSView pruned(mnview);
-        mnview.ForEachUndo([&](UndoKey const & key, CLazySerialize<CUndo>) {
-            if (key.height >= static_cast<uint32_t>(it->first)) { // don't erase checkpoint height
-                return false;
-            }
-            if (!pruneStarted) {
-                pruneStarted = true;
-                LogPrintf("Pruning undo data prior %d, it can take a while...\n", it->first);
-            }
-            return pruned.DelUndo(key).ok;
-        });
-        if (pruneStarted) {
-            auto& map = pruned.GetStorage().GetRaw();
-            compactBegin = map.begin()->first;
-            compactEnd = map.rbegin()->first;
+        // don't erase checkpoint height
+        const auto result = pruned.PruneUndos(static_cast<uint32_t>(it->first));
+        if (result.records) {
+            compactBegin = result.firstKey;
+            compactEnd = result.lastKey;
             pruned.Flush();
-            LogPrintf("Pruning undo data finished.\n");
+            LogPrintf("Pruning undo data prior %d finished: %d records, %d bytes (%d plain)\n",
+                      it->first, result.records, result.bytes, result.plainBytes);
             LogPrint(BCLog::BENCH, "    - Pruning undo data takes: %dms\n", GetTimeMillis() - time);
         }
         // we can safety delete old interest keys
@@ -3172,6 +3174,11 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
         }
         evm_disconnect_latest_block();
+        mempool.addAccountsViewChanges(block.vtx, mnview.GetStorage().GetRaw());
+        if (fDeFiStateDiffs) {
+            GetMainSignals().DeFiStateChanged(std::make_shared<const CDeFiStateDiff>(
+                CDeFiStateDiff::Construct(pindexDelete, false, pcustomcsview->GetStorage(), mnview.GetStorage().GetRaw())));
+        }
         bool flushed = view.Flush() && mnview.Flush();
         assert(flushed);
         mnview.GetHistoryWriters().FlushDB();
@@ -3335,6 +3342,11 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
             }
 
         }
+        mempool.addAccountsViewChanges(blockConnecting.vtx, mnview.GetStorage().GetRaw());
+        if (fDeFiStateDiffs) {
+            GetMainSignals().DeFiStateChanged(std::make_shared<const CDeFiStateDiff>(
+                CDeFiStateDiff::Construct(pindexNew, true, pcustomcsview->GetStorage(), mnview.GetStorage().GetRaw())));
+        }
         bool flushed = view.Flush() && mnview.Flush();
         assert(flushed);
         mnview.GetHistoryWriters().FlushDB();
@@ -5091,8 +5103,10 @@ bool BlockManager::LoadBlockIndex(
     CBlockTreeDB& blocktree,
     std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates)
 {
-    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, fIsFakeNet))
+    std::vector<CBlockIndex*> minterKeysRecovered;
+    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, fIsFakeNet, minterKeysRecovered))
          return false;
+    vMinterKeyMigration.assign(minterKeysRecovered.begin(), minterKeysRecovered.end());
 
     // Calculate nChainWork
     std::vector<std::pair<int, CBlockIndex*> > vSortedByHeight;
@@ -5620,6 +5634,7 @@ void UnloadBlockIndex()
     nLastBlockFile = 0;
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
+    vMinterKeyMigration.clear();
     versionbitscache.Clear();
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
@@ -5629,6 +5644,26 @@ void UnloadBlockIndex()
     ::ChainstateActive().UnloadBlockIndex();
 }
 
+bool MigrateBlockIndexMinterKeys(size_t count)
+{
+    LOCK(cs_main);
+    if (vMinterKeyMigration.empty()) {
+        return false;
+    }
+    count = std::min(count, vMinterKeyMigration.size());
+    const std::vector<const CBlockIndex*> entries(vMinterKeyMigration.end() - count, vMinterKeyMigration.end());
+    if (!pblocktree->WriteMinterKeys(entries)) {
+        LogPrintf("%s: failed to write minter keys, the remaining ones are stored on the next start\n", __func__);
+        vMinterKeyMigration.clear();
+        return false;
+    }
+    vMinterKeyMigration.resize(vMinterKeyMigration.size() - count);
+    if (vMinterKeyMigration.empty()) {
+        LogPrintf("Block index minter keys stored\n");
+    }
+    return !vMinterKeyMigration.empty();
+}
+
 bool LoadBlockIndex(const CChainParams& chainparams)
 {
     // Load block index from databases
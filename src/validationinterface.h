@@ -19,6 +19,7 @@ struct CBlockLocator;
 class CConnman;
 class CValidationInterface;
 class CValidationState;
+struct CDeFiStateDiff;
 class uint256;
 class CScheduler;
 class CTxMemPool;
@@ -115,6 +116,14 @@ protected:
      * Called on a background thread.
      */
     virtual void BlockDisconnected(const std::shared_ptr<const CBlock> &block) {}
+    /**
+     * Notifies listeners of the changes a block being connected or disconnected made
+     * to the DeFi consensus state, in the order the chain was updated.
+     * Only provided while fDeFiStateDiffs is set.
+     *
+     * Called on a background thread.
+     */
+    virtual void DeFiStateChanged(const std::shared_ptr<const CDeFiStateDiff> &diff) {}
     /**
      * Notifies listeners of the new active block chain on-disk.
      *
@@ -179,6 +188,7 @@ public:
     void TransactionAddedToMempool(const CTransactionRef &);
     void BlockConnected(const std::shared_ptr<const CBlock> &, const CBlockIndex *pindex, const std::shared_ptr<const std::vector<CTransactionRef>> &);
     void BlockDisconnected(const std::shared_ptr<const CBlock> &);
+    void DeFiStateChanged(const std::shared_ptr<const CDeFiStateDiff> &);
     void ChainStateFlushed(const CBlockLocator &);
     void BlockChecked(const CBlock&, const CValidationState&);
     void NewPoWValidBlock(const CBlockIndex *, const std::shared_ptr<const CBlock>&);
@@ -9,6 +9,7 @@
 
 class CBlockIndex;
 class CZMQAbstractNotifier;
+struct CDeFiStateDiff;
 
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
 
@@ -42,6 +43,7 @@ public:
 
     virtual bool NotifyBlock(const CBlockIndex *pindex);
     virtual bool NotifyTransaction(const CTransaction &transaction);
+    virtual bool NotifyDeFiStateDiff(const CDeFiStateDiff &diff);
 
 protected:
     void *psocket;
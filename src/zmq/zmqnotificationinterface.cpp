@@ -5,6 +5,7 @@
 #include <zmq/zmqnotificationinterface.h>
 #include <zmq/zmqpublishnotifier.h>
 
+#include <masternodes/statediff.h>
 #include <version.h>
 #include <validation.h>
 #include <util/system.h>
@@ -47,6 +48,7 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubhashtx"] = CZMQAbstractNotifier::Create<CZMQPublishHashTransactionNotifier>;
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
+    factories["pubdefistatediff"] = CZMQAbstractNotifier::Create<CZMQPublishDeFiStateDiffNotifier>;
 
     for (const auto& entry : factories)
     {
@@ -73,6 +75,11 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
             delete notificationInterface;
             notificationInterface = nullptr;
         }
+        else if (gArgs.IsArgSet("-zmqpubdefistatediff"))
+        {
+            // Block changes are only collected while they are published
+            fDeFiStateDiffs = true;
+        }
     }
 
     return notificationInterface;
@@ -194,4 +201,21 @@ void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CB
     }
 }
 
+void CZMQNotificationInterface::DeFiStateChanged(const std::shared_ptr<const CDeFiStateDiff>& diff)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyDeFiStateDiff(*diff))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
 CZMQNotificationInterface* g_zmq_notification_interface = nullptr;
@@ -4,6 +4,7 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <masternodes/statediff.h>
 #include <streams.h>
 #include <zmq/zmqpublishnotifier.h>
 #include <validation.h>
@@ -16,6 +17,7 @@ static const char *MSG_HASHBLOCK = "hashblock";
 static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
+static const char *MSG_DEFISTATEDIFF = "defistatediff";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -206,3 +208,12 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     ss << transaction;
     return SendMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
+
+bool CZMQPublishDeFiStateDiffNotifier::NotifyDeFiStateDiff(const CDeFiStateDiff &diff)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish defistatediff %s (%s, %d changes)\n",
+             diff.blockHash.GetHex(), diff.connected ? "connected" : "disconnected", diff.changes.size());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << diff;
+    return SendMessage(MSG_DEFISTATEDIFF, &(*ss.begin()), ss.size());
+}
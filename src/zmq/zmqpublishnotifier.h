@@ -52,4 +52,10 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+class CZMQPublishDeFiStateDiffNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyDeFiStateDiff(const CDeFiStateDiff &diff) override;
+};
+
 #endif // DEFI_ZMQ_ZMQPUBLISHNOTIFIER_H
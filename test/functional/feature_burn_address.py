@@ -216,6 +216,11 @@ class BurnAddressTest(DefiTestFramework):
         assert_equal(len(result), 1)
         assert_equal(result[0]['type'], 'CreateToken')
 
+        # Burn totals are kept in the burn history DB across restarts
+        burn_info = self.nodes[0].getburninfo()
+        self.restart_node(0)
+        assert_equal(self.nodes[0].getburninfo(), burn_info)
+
         # Get current block
         current_block = self.nodes[0].getblockcount()
 
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Copyright (c) 2014-2019 The Bitcoin Core developers
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test dumpdefistate and starting from the snapshot with -loaddefistate"""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.test_node import ErrorMatch
+from test_framework.util import assert_equal, assert_raises_rpc_error, connect_nodes
+
+import os
+
+
+class DeFiStateSnapshotTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.setup_clean_chain = True
+        self.extra_args = [
+            ['-txnotokens=0', '-amkheight=1', '-bayfrontheight=1', '-acindex=1'],
+            ['-txnotokens=0', '-amkheight=1', '-bayfrontheight=1', '-acindex=1'],
+        ]
+
+    def run_test(self):
+        self.setup_state()
+        snapshot = self.dump()
+        self.load(snapshot)
+        self.reject_corrupted(snapshot)
+
+    def setup_state(self):
+        node = self.nodes[0]
+        node.generate(101)
+        self.address = node.get_genesis_keys().ownerAuthAddress
+
+        node.createtoken({'symbol': 'GOLD', 'name': 'gold', 'isDAT': True, 'collateralAddress': self.address})
+        node.generate(1)
+        node.minttokens('1000@GOLD')
+        node.utxostoaccount({self.address: '100@DFI'})
+        node.generate(1)
+
+        transfers = {}
+        for i in range(20):
+            transfers[node.getnewaddress()] = f'{1 + i}@GOLD'
+        node.accounttoaccount(self.address, transfers)
+        node.generate(1)
+        self.sync_blocks()
+
+    def state(self, node):
+        return {
+            'height': node.getblockcount(),
+            'balances': node.logaccountbalances(),
+            'tokens': node.listtokens(),
+            'history': node.listaccounthistory('all', {'depth': 0, 'limit': 1000}),
+            'utxos': node.gettxoutsetinfo()['hash_serialized_2'],
+        }
+
+    def dump(self):
+        self.log.info("Dump the state at the tip")
+        snapshot = self.nodes[0].dumpdefistate('defistate.dat')
+        assert_equal(snapshot['height'], self.nodes[0].getblockcount())
+        assert_equal(snapshot['blockhash'], self.nodes[0].getbestblockhash())
+        assert os.path.isfile(snapshot['path'])
+        assert_raises_rpc_error(-8, 'already exists', self.nodes[0].dumpdefistate, 'defistate.dat')
+        return snapshot
+
+    def load(self, snapshot):
+        self.log.info("Start a node from the snapshot")
+        expected = self.state(self.nodes[0])
+        self.restart_node(1, self.extra_args[1] + [f"-loaddefistate={snapshot['path']}",
+                                                   f"-loaddefistateroot={snapshot['stateroot']}"])
+        assert_equal(self.state(self.nodes[1]), expected)
+
+        # and follow the chain from there
+        self.nodes[0].accounttoaccount(self.address, {self.nodes[0].getnewaddress(): '5@GOLD'})
+        self.nodes[0].generate(2)
+        connect_nodes(self.nodes[0], 1)
+        self.sync_blocks()
+        assert_equal(self.state(self.nodes[1]), self.state(self.nodes[0]))
+
+    def reject_corrupted(self, snapshot):
+        self.log.info("Reject snapshots not matching their commitment")
+        self.stop_node(1)
+        self.nodes[1].assert_start_raises_init_error(
+            self.extra_args[1] + [f"-loaddefistate={snapshot['path']}"],
+            '-loaddefistate requires -loaddefistateroot', match=ErrorMatch.PARTIAL_REGEX)
+        self.nodes[1].assert_start_raises_init_error(
+            self.extra_args[1] + [f"-loaddefistate={snapshot['path']}", f"-loaddefistateroot={'00' * 32}"],
+            'is not the trusted one', match=ErrorMatch.PARTIAL_REGEX)
+
+        corrupted = os.path.join(self.options.tmpdir, 'corrupted.dat')
+        with open(snapshot['path'], 'rb') as f:
+            contents = bytearray(f.read())
+        contents[len(contents) // 2] ^= 1
+        with open(corrupted, 'wb') as f:
+            f.write(contents)
+        self.nodes[1].assert_start_raises_init_error(
+            self.extra_args[1] + [f"-loaddefistate={corrupted}", f"-loaddefistateroot={snapshot['stateroot']}"],
+            'DeFi state snapshot .* rejected', match=ErrorMatch.PARTIAL_REGEX)
+
+        # the databases the snapshot replaced are rebuilt from the blocks
+        self.start_node(1, self.extra_args[1] + ['-reindex-chainstate'])
+        connect_nodes(self.nodes[0], 1)
+        self.sync_blocks()
+        assert_equal(self.state(self.nodes[1]), self.state(self.nodes[0]))
+
+
+if __name__ == '__main__':
+    DeFiStateSnapshotTest().main()
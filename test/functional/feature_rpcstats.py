@@ -10,6 +10,7 @@ import time
 from test_framework.test_framework import DefiTestFramework
 from test_framework.util import (
     assert_equal,
+    assert_raises_rpc_error,
 )
 from test_framework.authproxy import JSONRPCException
 
@@ -19,7 +20,8 @@ class RPCstats(DefiTestFramework):
         self.num_nodes = 2
         self.setup_clean_chain = True
         self.extra_args = [
-            ['-acindex=1', '-txnotokens=0', '-amkheight=50', '-bayfrontheight=50', '-bayfrontgardensheight=50'],
+            ['-acindex=1', '-txnotokens=0', '-amkheight=50', '-bayfrontheight=50', '-bayfrontgardensheight=50',
+             '-dftxstats'],
             ['-acindex=1', '-txnotokens=0', '-amkheight=50', '-bayfrontheight=50', '-bayfrontgardensheight=50',
              '-rpcstats=0'],
         ]
@@ -71,6 +73,43 @@ class RPCstats(DefiTestFramework):
             errorString = e.error['message']
         assert ("Rpcstats is desactivated." in errorString)
 
+        # view read caches count regardless of -rpcstats
+        cachestats = self.nodes[1].getviewcachestats()
+        assert_equal(sorted(cachestats.keys()), ["attributes", "poolgraph", "poolpairs", "tokens"])
+        reads = cachestats["tokens"]["hits"] + cachestats["tokens"]["misses"]
+        self.nodes[1].gettoken("0")
+        self.nodes[1].gettoken("0")
+        cachestats = self.nodes[1].getviewcachestats()
+        assert (cachestats["tokens"]["hits"] + cachestats["tokens"]["misses"] >= reads + 2)
+
+        self.dftx_stats()
+
+    def dftx_stats(self):
+        node = self.nodes[0]
+        address = node.get_genesis_keys().ownerAuthAddress
+        node.utxostoaccount({address: "10@DFI"})
+        node.generate(1)
+
+        stats = node.getdftxstats()
+        assert ("event:rewards" in stats)
+        assert ("event:loans" in stats)
+        utxos = stats["UtxosToAccount"]
+        # in the mempool, the block template and the block
+        assert (utxos["count"] >= 2)
+        assert_equal(utxos["failures"], 0)
+        assert (utxos["writes"]["total"] > 0)
+        assert (utxos["bytes"]["max"] > 0)
+        assert (utxos["mapEntries"]["max"] > 0)
+        assert (utxos["time"]["p50"] <= utxos["time"]["max"])
+
+        prometheus = node.getdftxstats("prometheus", True)
+        assert ('defi_dftx_time_microseconds_count{type="UtxosToAccount"}' in prometheus)
+        assert ('defi_dftx_failures_total{type="event:rewards"} 0' in prometheus)
+        assert_equal(node.getdftxstats(), {})
+        assert_raises_rpc_error(-8, "Format must be json or prometheus", node.getdftxstats, "xml")
+
+        assert_raises_rpc_error(-32600, "Dftxstats is deactivated", self.nodes[1].getdftxstats)
+
 
 if __name__ == '__main__':
     RPCstats().main()
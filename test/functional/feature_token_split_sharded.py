@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# Copyright (c) 2014-2019 The Bitcoin Core developers
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test token split sharded over the DfTx pool against a serial one, pool shares included"""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.util import assert_equal
+
+import hashlib
+import json
+import time
+
+
+class TokenSplitShardedTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.setup_clean_chain = True
+        self.fort_canning_crunch = 150
+        args = ['-txnotokens=0', '-amkheight=1', '-bayfrontheight=1', '-eunosheight=1', '-fortcanningheight=1',
+                '-fortcanningmuseumheight=1', '-fortcanninghillheight=1', '-fortcanningroadheight=1',
+                f'-fortcanningcrunchheight={self.fort_canning_crunch}', '-subsidytest=1']
+        self.extra_args = [
+            args + ['-tokensplitworkers=0'],
+            args + ['-tokensplitworkers=1'],
+        ]
+
+    def run_test(self):
+        self.setup_test_tokens()
+        self.setup_test_accounts()
+        self.setup_test_vaults()
+        self.setup_test_pools()
+        self.split_and_compare(2)
+        self.split_and_compare(-3)
+
+    def setup_test_tokens(self):
+        self.nodes[0].generate(101)
+
+        self.symbolDFI = 'DFI'
+        self.symbolTSLA = 'TSLA'
+        self.address = self.nodes[0].get_genesis_keys().ownerAuthAddress
+
+        oracle_address = self.nodes[0].getnewaddress("", "legacy")
+        price_feed = [
+            {"currency": "USD", "token": self.symbolDFI},
+            {"currency": "USD", "token": self.symbolTSLA},
+        ]
+        self.oracle = self.nodes[0].appointoracle(oracle_address, price_feed, 10)
+        self.nodes[0].generate(1)
+
+        oracle_prices = [
+            {"currency": "USD", "tokenAmount": f"1@{self.symbolDFI}"},
+            {"currency": "USD", "tokenAmount": f"1@{self.symbolTSLA}"},
+        ]
+        self.nodes[0].setoracledata(self.oracle, int(time.time()), oracle_prices)
+        self.nodes[0].generate(10)
+
+        self.nodes[0].setloantoken({
+            'symbol': self.symbolTSLA,
+            'name': self.symbolTSLA,
+            'fixedIntervalPriceId': f"{self.symbolTSLA}/USD",
+            'mintable': True,
+            'interest': 1
+        })
+        self.nodes[0].setcollateraltoken({
+            'token': self.symbolDFI,
+            'factor': 1,
+            'fixedIntervalPriceId': f"{self.symbolDFI}/USD"
+        })
+        self.nodes[0].createloanscheme(150, 5, 'LOAN0001')
+        self.nodes[0].generate(1)
+
+        self.idTSLA = list(self.nodes[0].gettoken(self.symbolTSLA).keys())[0]
+
+        # Move to fork height
+        self.nodes[0].generate(self.fort_canning_crunch - self.nodes[0].getblockcount())
+
+    def setup_test_accounts(self):
+        # Enough owners for the accounts to be split over several shards
+        self.nodes[0].minttokens(f'100000@{self.symbolTSLA}')
+        self.nodes[0].generate(1)
+
+        transfers = {}
+        for i in range(80):
+            transfers[self.nodes[0].getnewaddress()] = f'{1 + i * 1.37:.8f}@{self.symbolTSLA}'
+        self.nodes[0].accounttoaccount(self.address, transfers)
+        self.nodes[0].generate(1)
+
+    def setup_test_vaults(self):
+        self.nodes[0].utxostoaccount({self.address: f'20000@{self.symbolDFI}'})
+        self.nodes[0].generate(1)
+
+        for i in range(40):
+            vault_id = self.nodes[0].createvault(self.address, 'LOAN0001')
+            self.nodes[0].generate(1)
+            self.nodes[0].deposittovault(vault_id, self.address, f'{100 + i}@{self.symbolDFI}')
+            self.nodes[0].generate(1)
+            self.nodes[0].takeloan({'vaultId': vault_id, 'amounts': f'{10 + i * 0.3:.8f}@{self.symbolTSLA}'})
+            self.nodes[0].generate(1)
+        self.sync_blocks()
+
+    def setup_test_pools(self):
+        self.nodes[0].createpoolpair({
+            "tokenA": self.symbolTSLA,
+            "tokenB": self.symbolDFI,
+            "commission": 0.001,
+            "status": True,
+            "ownerAddress": self.address
+        })
+        self.nodes[0].generate(1)
+
+        # Enough liquidity providers for their shares to be migrated over several shards,
+        # the burn address among them
+        owners = [self.nodes[0].getnewaddress() for _ in range(50)] + ['mfburnZSAM7Gs1hpDeNaMotJXSGA7edosG']
+        for i, owner in enumerate(owners):
+            self.nodes[0].addpoolliquidity({
+                self.address: [f'{5 + i * 0.73:.8f}@{self.symbolTSLA}', f'{3 + i * 0.41:.8f}@{self.symbolDFI}']
+            }, owner)
+            if i % 10 == 9:
+                self.nodes[0].generate(1)
+        self.nodes[0].generate(1)
+        self.sync_blocks()
+
+    # Everything a token split rewrites, as seen by a node
+    def state_hash(self, node, height):
+        state = {
+            'balances': node.logaccountbalances(),
+            'interests': node.logstoredinterests(),
+            'vaults': [node.getvault(vault['vaultId']) for vault in node.listvaults()],
+            'history': node.listaccounthistory('all', {'maxBlockHeight': height, 'depth': 0, 'limit': 1000000}),
+            'token': node.gettoken(self.symbolTSLA),
+            'pools': node.listpoolpairs({'limit': 1000000}),
+            'shares': node.listpoolshares({'limit': 1000000}),
+        }
+        return hashlib.sha256(json.dumps(state, sort_keys=True, default=str).encode()).hexdigest()
+
+    def split_and_compare(self, multiplier):
+        self.nodes[0].setgov({"ATTRIBUTES": {f'v0/locks/token/{self.idTSLA}': 'true'}})
+        self.nodes[0].generate(1)
+
+        split_height = self.nodes[0].getblockcount() + 2
+        self.nodes[0].setgov({"ATTRIBUTES": {f'v0/oracles/splits/{split_height}': f'{self.idTSLA}/{multiplier}'}})
+        self.nodes[0].generate(2)
+        self.sync_blocks()
+
+        # Both nodes applied the split on their own, sharded and serially
+        new_id = list(self.nodes[0].gettoken(self.symbolTSLA).keys())[0]
+        assert new_id != self.idTSLA
+        # Every provider but the burn address holds shares of the new pool
+        pool_id = list(self.nodes[0].getpoolpair(f'{self.symbolTSLA}-{self.symbolDFI}').keys())[0]
+        shares = self.nodes[0].listpoolshares({'limit': 1000000})
+        assert_equal(len([share for share in shares.values() if share['poolID'] == pool_id]), 50)
+        assert_equal(self.state_hash(self.nodes[0], split_height), self.state_hash(self.nodes[1], split_height))
+
+        # Undone the same way
+        split_block = self.nodes[0].getblockhash(split_height)
+        for node in self.nodes:
+            node.invalidateblock(split_block)
+        assert_equal(self.state_hash(self.nodes[0], split_height), self.state_hash(self.nodes[1], split_height))
+        for node in self.nodes:
+            node.reconsiderblock(split_block)
+        assert_equal(self.state_hash(self.nodes[0], split_height), self.state_hash(self.nodes[1], split_height))
+
+        self.idTSLA = new_id
+        self.nodes[0].setgov({"ATTRIBUTES": {f'v0/locks/token/{self.idTSLA}': 'false'}})
+        self.nodes[0].generate(1)
+        self.sync_blocks()
+
+
+if __name__ == '__main__':
+    TokenSplitShardedTest().main()
@@ -7,7 +7,7 @@ import struct
 
 from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
 from test_framework.test_framework import DefiTestFramework
-from test_framework.messages import CTransaction, hash256, BLOCK_HEADER_SIZE
+from test_framework.messages import CTransaction, hash256, BLOCK_HEADER_SIZE, deser_compact_size, deser_string, deser_uint256
 from test_framework.util import assert_equal, connect_nodes
 from io import BytesIO
 from time import sleep
@@ -17,6 +17,25 @@ def hash256_reversed(byte_str):
     return hash256(byte_str)[::-1]
 
 
+def parse_state_diff(body):
+    f = BytesIO(body)
+    diff = {
+        'connected': struct.unpack('<?', f.read(1))[0],
+        'height': struct.unpack('<i', f.read(4))[0],
+        'hash': '%064x' % deser_uint256(f),
+        'prev': '%064x' % deser_uint256(f),
+        'changes': {},
+    }
+    for _ in range(deser_compact_size(f)):
+        flags = f.read(1)[0]
+        key = deser_string(f)
+        before = deser_string(f) if flags & 1 else None
+        after = deser_string(f) if flags & 2 else None
+        diff['changes'][key] = (before, after)
+    assert_equal(f.read(), b'')
+    return diff
+
+
 class ZMQSubscriber:
     def __init__(self, socket, topic):
         self.sequence = 0
@@ -50,6 +69,7 @@ class ZMQTest(DefiTestFramework):
         try:
             self.test_basic()
             self.test_reorg()
+            self.test_defi_state_diff()
         finally:
             # Destroy the ZMQ context.
             self.log.debug("Destroying ZMQ context")
@@ -153,6 +173,46 @@ class ZMQTest(DefiTestFramework):
         # Should receive nodes[1] tip
         assert_equal(self.nodes[1].getbestblockhash(), hashblock.receive().hex())
 
+    def test_defi_state_diff(self):
+        import zmq
+        address = 'tcp://127.0.0.1:28556'
+        socket = self.ctx.socket(zmq.SUB)
+        socket.set(zmq.RCVTIMEO, 60000)
+        statediff = ZMQSubscriber(socket, b'defistatediff')
+
+        self.restart_node(0, ['-zmqpub%s=%s' % (statediff.topic.decode(), address)])
+        socket.connect(address)
+        # Relax so that the subscriber is ready before publishing zmq messages
+        sleep(0.2)
+
+        # Each block changes at least its minter's masternode record
+        hashes = self.nodes[0].generate(nblocks=2, address=ADDRESS_BCRT1_UNSPENDABLE)
+        connected = [parse_state_diff(statediff.receive()) for _ in hashes]
+        for diff, block_hash in zip(connected, hashes):
+            assert diff['connected']
+            assert_equal(diff['hash'], block_hash)
+            assert_equal(diff['height'], self.nodes[0].getblockheader(block_hash)['height'])
+            assert len(diff['changes']) > 0
+            for before, after in diff['changes'].values():
+                assert before != after
+        assert_equal(connected[1]['prev'], hashes[0])
+
+        # Disconnecting the tip publishes its changes reversed
+        self.nodes[0].invalidateblock(hashes[1])
+        disconnected = parse_state_diff(statediff.receive())
+        assert not disconnected['connected']
+        assert_equal(disconnected['hash'], hashes[1])
+        assert_equal(disconnected['prev'], hashes[0])
+        reverted = set(disconnected['changes']) & set(connected[1]['changes'])
+        assert len(reverted) > 0
+        for key in reverted:
+            before, after = connected[1]['changes'][key]
+            assert_equal(disconnected['changes'][key], (after, before))
+
+        # and connecting it again publishes the same changes
+        self.nodes[0].reconsiderblock(hashes[1])
+        assert_equal(parse_state_diff(statediff.receive()), connected[1])
+
 
 if __name__ == '__main__':
     ZMQTest().main()
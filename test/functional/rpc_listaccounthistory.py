@@ -165,6 +165,19 @@ class TokensRPCListAccountHistory(DefiTestFramework):
         assert_equal(len(res0), len(res2) + 2)
         assert_equal(len(res0), len(res3) + 3)
 
+        # "mine" merges the history of every wallet owner in the order of the whole history
+        mine_addresses = {}
+        def is_mine(address):
+            if address not in mine_addresses:
+                mine_addresses[address] = self.nodes[0].getaddressinfo(address)['ismine']
+            return mine_addresses[address]
+
+        options = {"no_rewards": True, "token": "GOLD", "limit": 0}
+        expected = [row for row in self.nodes[0].listaccounthistory('all', options) if is_mine(row['owner'])]
+        assert_equal(self.nodes[0].listaccounthistory('mine', options), expected)
+        assert_equal(self.nodes[0].listaccounthistory('mine', {**options, "limit": 2}), expected[:2])
+        assert_equal(self.nodes[0].listaccounthistory('mine', {**options, "limit": 2, "start": 1}), expected[2:4])
+
         # accounthistorycount should return total count
         assert_equal(self.nodes[0].accounthistorycount(), 112)
 
@@ -47,6 +47,27 @@ class RpcMiscTest(DefiTestFramework):
 
         assert_raises_rpc_error(-8, "unknown mode foobar", node.getmemoryinfo, mode="foobar")
 
+        self.log.info("test getdbstats")
+        stats = {db['name']: db for db in node.getdbstats()}
+        assert_equal(stats['enhancedcs']['pooled'], True)
+        assert_equal(stats['history']['compression'], True)
+        assert_equal(stats['chainstate']['pooled'], False)
+        assert_equal(stats['enhancedcs']['blockcache'], stats['burn']['blockcache'])
+        for db in stats.values():
+            assert_greater_than_or_equal(db['hitrate'], 0)
+            assert_greater_than_or_equal(1, db['hitrate'])
+
+        self.log.info("test -dbprofile")
+        self.restart_node(0, ['-dbprofile=enhancedcs:adaptive=0,bloombits=10', '-dbcacheadaptive=1'])
+        stats = {db['name']: db for db in node.getdbstats()}
+        assert_equal(stats['enhancedcs']['pooled'], False)
+        assert_equal(stats['enhancedcs']['bloombits'], 10)
+        assert_equal(stats['burn']['pooled'], True)
+        self.stop_node(0)
+        self.nodes[0].assert_start_raises_init_error(['-dbprofile=enhancedcs:cacheshare=2'],
+                                                     "Error: Invalid setting 'cacheshare=2' of database profile 'enhancedcs'")
+        self.start_node(0)
+
         self.log.info("test logging")
         assert_equal(node.logging()['anchoring'], True)
         node.logging(exclude=['anchoring'])